@@ -0,0 +1,53 @@
+QT += core gui svg svgwidgets
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TEMPLATE = app
+
+################################################################################
+
+DESTDIR = $$PWD/../bin
+TARGET = qfi_bench
+
+################################################################################
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+################################################################################
+
+win32: CONFIG(release, debug|release): QMAKE_CXXFLAGS += -O2
+unix:  CONFIG(release, debug|release): QMAKE_CXXFLAGS += -O2
+
+#win32: QMAKE_LFLAGS += /INCREMENTAL:NO
+
+################################################################################
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+greaterThan(QT_MAJOR_VERSION, 4):win32: DEFINES += USE_QT5
+
+win32: DEFINES += \
+    NOMINMAX \
+    WIN32 \
+    _WINDOWS \
+    _CRT_SECURE_NO_DEPRECATE \
+    _SCL_SECURE_NO_WARNINGS \
+    _USE_MATH_DEFINES
+
+win32: CONFIG(release, debug|release): DEFINES += NDEBUG
+win32: CONFIG(debug, debug|release):   DEFINES += _DEBUG
+
+unix: DEFINES += _LINUX_
+
+################################################################################
+
+INCLUDEPATH += ./
+
+################################################################################
+
+# -udp option measures qfi_UdpReceiver
+CONFIG += qfi_network
+
+include($$PWD/bench/bench.pri)
+include($$PWD/qfi/qfi.pri)
@@ -0,0 +1,1202 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <bench/Bench.h>
+
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QGridLayout>
+#include <QHostAddress>
+#include <QImage>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QWidget>
+#include <QtEndian>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#ifdef _LINUX_
+#   include <cstdio>
+#   include <sys/resource.h>
+#   include <unistd.h>
+#endif
+
+#include <qfi/qfi_AI.h>
+#include <qfi/qfi_ALT.h>
+#include <qfi/qfi_ASI.h>
+#include <qfi/qfi_AtlasSvgItem.h>
+#include <qfi/qfi_Cache.h>
+#include <qfi/qfi_EADI.h>
+#include <qfi/qfi_EHSI.h>
+#include <qfi/qfi_FlightLog.h>
+#include <qfi/qfi_FlightLogWriter.h>
+#include <qfi/qfi_FrameScheduler.h>
+#include <qfi/qfi_GlyphTextItem.h>
+#include <qfi/qfi_HI.h>
+#include <qfi/qfi_ILS.h>
+#include <qfi/qfi_Latency.h>
+#include <qfi/qfi_Panel.h>
+#include <qfi/qfi_ParallelRenderer.h>
+#include <qfi/qfi_Recorder.h>
+#include <qfi/qfi_Renderers.h>
+#include <qfi/qfi_Scenario.h>
+#include <qfi/qfi_States.h>
+#include <qfi/qfi_TC.h>
+#include <qfi/qfi_TripleBuffer.h>
+#include <qfi/qfi_UdpReceiver.h>
+#include <qfi/qfi_VOR.h>
+#include <qfi/qfi_VSI.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// flight parameters come from a synthetic scenario of a fixed seed, so every
+// run of the same build measures the same sequence of states
+
+const quint32 seed = 1;
+
+template < class T >
+void drive( T *instrument, const double *values )
+{
+    typename T::State state;
+    qfi_States::fromValues( values, &state );
+    instrument->setState( state );
+}
+
+// painter backend is available for some instruments only
+
+template < class T >
+T* newInstrument( RenderBackend )
+{
+    return new T();
+}
+
+template <>
+qfi_AI* newInstrument< qfi_AI >( RenderBackend backend )
+{
+    return new qfi_AI( Q_NULLPTR, backend );
+}
+
+template <>
+qfi_TC* newInstrument< qfi_TC >( RenderBackend backend )
+{
+    return new qfi_TC( Q_NULLPTR, backend );
+}
+
+template <>
+qfi_VSI* newInstrument< qfi_VSI >( RenderBackend backend )
+{
+    return new qfi_VSI( Q_NULLPTR, backend );
+}
+
+/** Panel instrument, type independent. */
+struct PanelItem
+{
+    QGraphicsView *view;
+    std::function< void( const double* ) > drive;
+    std::function< void() > redraw;
+};
+
+template < class T >
+PanelItem createPanelItem( QWidget *parent )
+{
+    T *instrument = new T( parent );
+
+    PanelItem item;
+
+    item.view   = instrument;
+    item.drive  = [ instrument ]( const double *values ) { drive( instrument, values ); };
+    item.redraw = [ instrument ]() { instrument->redraw(); };
+
+    return item;
+}
+
+/** @return j-th instrument of the same mix as in the example application */
+PanelItem createMixItem( int j, QWidget *parent )
+{
+    switch ( j % 9 )
+    {
+        case 0: return createPanelItem< qfi_EADI >( parent );
+        case 1: return createPanelItem< qfi_EHSI >( parent );
+        case 2: return createPanelItem< qfi_AI   >( parent );
+        case 3: return createPanelItem< qfi_ALT  >( parent );
+        case 4: return createPanelItem< qfi_ASI  >( parent );
+        case 5: return createPanelItem< qfi_HI   >( parent );
+        case 6: return createPanelItem< qfi_TC   >( parent );
+        case 7: return createPanelItem< qfi_VSI  >( parent );
+        default: return createPanelItem< qfi_VOR >( parent );
+    }
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+Bench::Bench( int frames, const QList< int > &sizes ) :
+    _frames ( frames ),
+    _warmUpFrames ( 10 ),
+
+    _sizes ( sizes )
+{}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QJsonArray Bench::runInstruments()
+{
+    QJsonArray results;
+
+    results.append( runInstrument< qfi_AI   >( "qfi_AI"   ) );
+    results.append( runInstrument< qfi_ALT  >( "qfi_ALT"  ) );
+    results.append( runInstrument< qfi_ASI  >( "qfi_ASI"  ) );
+    results.append( runInstrument< qfi_HI   >( "qfi_HI"   ) );
+    results.append( runInstrument< qfi_TC   >( "qfi_TC"   ) );
+    results.append( runInstrument< qfi_VSI  >( "qfi_VSI"  ) );
+    results.append( runInstrument< qfi_VOR  >( "qfi_VOR"  ) );
+    results.append( runInstrument< qfi_ILS  >( "qfi_ILS"  ) );
+    results.append( runInstrument< qfi_EHSI >( "qfi_EHSI" ) );
+    results.append( runInstrument< qfi_EADI >( "qfi_EADI" ) );
+
+    results.append( runInstrument< qfi_AI  >( "qfi_AI" , RenderBackend::Painter ) );
+    results.append( runInstrument< qfi_TC  >( "qfi_TC" , RenderBackend::Painter ) );
+    results.append( runInstrument< qfi_VSI >( "qfi_VSI", RenderBackend::Painter ) );
+
+    return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QJsonArray Bench::compareBackends()
+{
+    QJsonArray results;
+
+    results.append( compareBackend< qfi_AI  >( "qfi_AI"  ) );
+    results.append( compareBackend< qfi_TC  >( "qfi_TC"  ) );
+    results.append( compareBackend< qfi_VSI >( "qfi_VSI" ) );
+
+    return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QJsonObject Bench::runGlyphs()
+{
+    QJsonObject results;
+
+    qfi_GlyphTextItem::setGlyphsEnabled( false );
+    QJsonObject text = runInstrument< qfi_EADI >( "qfi_EADI" );
+
+    qfi_GlyphTextItem::setGlyphsEnabled( true );
+    QJsonObject glyphs = runInstrument< qfi_EADI >( "qfi_EADI" );
+
+    QJsonArray textSizes   = text   [ "sizes" ].toArray();
+    QJsonArray glyphsSizes = glyphs [ "sizes" ].toArray();
+
+    QJsonArray speedup;
+
+    for ( int i = 0; i < textSizes.size() && i < glyphsSizes.size(); i++ )
+    {
+        double textUs   = textSizes   .at( i ).toObject()[ "frameUs" ].toObject()[ "median" ].toDouble();
+        double glyphsUs = glyphsSizes .at( i ).toObject()[ "frameUs" ].toObject()[ "median" ].toDouble();
+
+        QJsonObject result;
+
+        result[ "size"  ] = textSizes.at( i ).toObject()[ "size" ];
+        result[ "ratio" ] = glyphsUs > 0.0 ? textUs / glyphsUs : 0.0;
+
+        speedup.append( result );
+    }
+
+    results[ "text"    ] = text;
+    results[ "glyphs"  ] = glyphs;
+    results[ "speedup" ] = speedup;
+
+    return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QJsonArray Bench::runPanels( const QList< int > &counts, int maxThreads )
+{
+    QJsonArray results;
+
+    // QSvgRenderer must not be shared between worker threads
+    qfi_Renderers::setShared( false );
+
+    const int size = _sizes.isEmpty() ? 240 : _sizes.first();
+
+    for ( int i = 0; i < counts.size(); i++ )
+    {
+        const int count = counts.at( i );
+        const int columns = static_cast< int >( ceil( sqrt( static_cast< double >( count ) ) ) );
+
+        QWidget panel;
+        QGridLayout *layout = new QGridLayout( &panel );
+        layout->setSpacing( 0 );
+        layout->setContentsMargins( 0, 0, 0, 0 );
+
+        QList< PanelItem > items;
+
+        for ( int j = 0; j < count; j++ )
+        {
+            PanelItem item = createMixItem( j, &panel );
+
+            item.view->setFixedSize( size, size );
+            layout->addWidget( item.view, j / columns, j % columns );
+
+            items.push_back( item );
+        }
+
+        panel.show();
+        QApplication::processEvents();
+
+        QJsonArray threadResults;
+
+        for ( int threads = 1; threads <= maxThreads; threads++ )
+        {
+            qfi_ParallelRenderer renderer;
+            renderer.setMaxThreads( threads );
+
+            for ( int j = 0; j < items.size(); j++ )
+            {
+                renderer.addView( items.at( j ).view );
+            }
+
+            QList< qint64 > times;
+
+            qfi_Scenario scenario( seed );
+
+            for ( int frame = 0; frame < _warmUpFrames + _frames; frame++ )
+            {
+                scenario.step( 0.1 );
+
+                QElapsedTimer timer;
+                timer.start();
+
+                for ( int j = 0; j < items.size(); j++ )
+                {
+                    items.at( j ).drive( scenario.values() );
+                    items.at( j ).redraw();
+                }
+
+                renderer.render();
+                QApplication::processEvents();
+
+                if ( frame >= _warmUpFrames )
+                {
+                    times.push_back( timer.nsecsElapsed() / 1000 );
+                }
+            }
+
+            QJsonObject result;
+
+            result[ "threads" ] = threads;
+            result[ "frameUs" ] = frameStats( times );
+
+            threadResults.append( result );
+        }
+
+        QJsonObject result;
+
+        result[ "instruments" ] = count;
+        result[ "size"        ] = size;
+        result[ "threads"     ] = threadResults;
+
+        results.append( result );
+    }
+
+    qfi_Renderers::setShared( true );
+
+    return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QJsonArray Bench::runScene( const QList< int > &counts )
+{
+    QJsonArray results;
+
+    const int size = _sizes.isEmpty() ? 240 : _sizes.first();
+
+    for ( int i = 0; i < counts.size(); i++ )
+    {
+        const int count = counts.at( i );
+        const int columns = static_cast< int >( ceil( sqrt( static_cast< double >( count ) ) ) );
+        const int rows = ( count + columns - 1 ) / columns;
+
+        QJsonObject result;
+
+        result[ "instruments" ] = count;
+        result[ "size"        ] = size;
+
+        // every instrument in its own view vs. all the instruments in qfi_Panel
+        for ( int mode = 0; mode < 2; mode++ )
+        {
+            QWidget views;
+            qfi_Panel panel;
+
+            QList< PanelItem > items;
+
+            if ( mode == 0 )
+            {
+                QGridLayout *layout = new QGridLayout( &views );
+                layout->setSpacing( 0 );
+                layout->setContentsMargins( 0, 0, 0, 0 );
+
+                for ( int j = 0; j < count; j++ )
+                {
+                    PanelItem item = createMixItem( j, &views );
+
+                    item.view->setFixedSize( size, size );
+                    layout->addWidget( item.view, j / columns, j % columns );
+
+                    items.push_back( item );
+                }
+
+                views.show();
+            }
+            else
+            {
+                panel.setFrameShape( QFrame::NoFrame );
+                panel.setFixedSize( columns * size, rows * size );
+                panel.setColumns( columns );
+
+                for ( int j = 0; j < count; j++ )
+                {
+                    PanelItem item = createMixItem( j, Q_NULLPTR );
+
+                    panel.addInstrument( item.view );
+
+                    items.push_back( item );
+                }
+
+                panel.show();
+            }
+
+            QApplication::processEvents();
+
+            QList< qint64 > times;
+
+            qfi_Scenario scenario( seed );
+
+            for ( int frame = 0; frame < _warmUpFrames + _frames; frame++ )
+            {
+                scenario.step( 0.1 );
+
+                QElapsedTimer timer;
+                timer.start();
+
+                for ( int j = 0; j < items.size(); j++ )
+                {
+                    items.at( j ).drive( scenario.values() );
+                    items.at( j ).redraw();
+                }
+
+                // painting
+                QApplication::processEvents();
+
+                if ( frame >= _warmUpFrames )
+                {
+                    times.push_back( timer.nsecsElapsed() / 1000 );
+                }
+            }
+
+            result[ mode == 0 ? "views" : "panel" ] = frameStats( times );
+        }
+
+        results.append( result );
+    }
+
+    return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QJsonObject Bench::runStress( int msec )
+{
+    qfi_TripleBuffer< qfi_EADI::State > buffer;
+
+    std::atomic< bool > done( false );
+    qint64 published = 0;
+
+    std::thread producer( [ &buffer, &done, &published ]()
+    {
+        qfi_EADI::State state;
+        memset( &state, 0, sizeof( state ) );
+
+        while ( !done.load() )
+        {
+            double value = static_cast< double >( ++published );
+
+            state.roll      = value;
+            state.pitch     = value;
+            state.altitude  = value;
+            state.airspeed  = value;
+            state.heading   = value;
+            state.vne       = value;
+
+            buffer.publish( state );
+        }
+    } );
+
+    qint64 consumed    = 0;
+    qint64 torn        = 0;
+    qint64 regressions = 0;
+
+    double last = 0.0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while ( timer.elapsed() < msec )
+    {
+        qfi_EADI::State state;
+
+        if ( buffer.consume( &state ) )
+        {
+            consumed++;
+
+            if ( state.pitch    != state.roll
+              || state.altitude != state.roll
+              || state.airspeed != state.roll
+              || state.heading  != state.roll
+              || state.vne      != state.roll )
+            {
+                torn++;
+            }
+
+            if ( state.roll < last ) regressions++;
+
+            last = state.roll;
+        }
+    }
+
+    done.store( true );
+    producer.join();
+
+    QJsonObject result;
+
+    result[ "durationMs"  ] = msec;
+    result[ "published"   ] = static_cast< double >( published );
+    result[ "consumed"    ] = static_cast< double >( consumed );
+    result[ "torn"        ] = static_cast< double >( torn );
+    result[ "regressions" ] = static_cast< double >( regressions );
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QJsonObject Bench::runReplay( qint64 samples )
+{
+    QJsonObject result;
+
+    const QString fileName = QDir::temp().filePath( "qfi_bench.log" );
+
+    double values[ qfi_FlightLog::_columns ];
+
+    QElapsedTimer timer;
+    timer.start();
+
+    {
+        qfi_FlightLogWriter writer;
+
+        if ( !writer.open( fileName ) ) return result;
+
+        for ( qint64 i = 0; i < samples; i++ )
+        {
+            for ( int c = 0; c < qfi_FlightLog::_columns; c++ )
+            {
+                values[ c ] = sin( 1.0e-3 * i + c );
+            }
+
+            writer.write( 1000 * i, values );
+        }
+    }
+
+    qint64 writeUs = timer.nsecsElapsed() / 1000;
+
+    qfi_FlightLog log;
+
+    timer.restart();
+    bool opened = log.open( fileName );
+    qint64 openUs = timer.nsecsElapsed() / 1000;
+
+    // random seeks all over the log, pseudo-random numbers are repeatable
+    const int seeks = 100000;
+
+    quint64 random = 1;
+    double sum = 0.0;
+
+    timer.restart();
+
+    for ( int i = 0; i < seeks && opened; i++ )
+    {
+        random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+
+        qint64 index = log.find( static_cast< qint64 >( ( random >> 16 ) % samples ) * 1000 + 500 );
+
+        log.read( index, values );
+        sum += values[ 0 ];
+    }
+
+    qint64 seekNs = timer.nsecsElapsed() / seeks;
+
+    result[ "samples"  ] = static_cast< double >( log.samples() );
+    result[ "chunks"   ] = log.chunks();
+    result[ "bytes"    ] = static_cast< double >( QFileInfo( fileName ).size() );
+    result[ "writeUs"  ] = static_cast< double >( writeUs );
+    result[ "openUs"   ] = static_cast< double >( openUs );
+    result[ "seekNs"   ] = static_cast< double >( seekNs );
+    result[ "checksum" ] = sum;
+
+    log.close();
+
+    QFile::remove( fileName );
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QJsonObject Bench::runRecorder( int msec )
+{
+    QJsonObject result;
+
+    const QString fileName = QDir::temp().filePath( "qfi_bench_record.log" );
+
+    const int count = 50;
+
+    QList< qfi_AI* > instruments;
+
+    qfi_Recorder recorder;
+
+    for ( int i = 0; i < count; i++ )
+    {
+        instruments.push_back( new qfi_AI() );
+        recorder.addInstrument( instruments.last() );
+    }
+
+    if ( recorder.start( fileName ) )
+    {
+        QList< qint64 > times;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        qint64 next = 0;
+
+        while ( timer.elapsed() < msec )
+        {
+            // 1 kHz ticks, waiting actively for precise timing
+            if ( timer.nsecsElapsed() < next ) continue;
+
+            next += 1000000;
+
+            qint64 start = timer.nsecsElapsed();
+
+            for ( int i = 0; i < count; i++ )
+            {
+                qfi_AI::State state;
+
+                state.roll  = 1.0e-6 * start + i;
+                state.pitch = 1.0e-7 * start;
+
+                instruments.at( i )->setState( state );
+            }
+
+            times.push_back( ( timer.nsecsElapsed() - start ) / 1000 );
+        }
+
+        recorder.stop();
+
+        result[ "instruments"    ] = count;
+        result[ "ticks"          ] = times.size();
+        result[ "samples"        ] = static_cast< double >( recorder.samples() );
+        result[ "droppedSamples" ] = static_cast< double >( recorder.droppedSamples() );
+        result[ "failed"         ] = recorder.hasFailed();
+        result[ "bytes"          ] = static_cast< double >( QFileInfo( fileName ).size() );
+        result[ "tickUs"         ] = frameStats( times );
+    }
+
+    qDeleteAll( instruments );
+
+    QFile::remove( fileName );
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QJsonObject Bench::runUdp( int msec )
+{
+    QJsonObject result;
+
+    qfi_AI ai;
+    ai.setFixedSize( 240, 240 );
+    ai.show();
+    QApplication::processEvents();
+
+    qfi_FrameScheduler scheduler;
+    scheduler.addInstrument( &ai );
+
+    QVector< qfi_UdpReceiver::Field > mapping;
+
+    mapping.push_back( qfi_UdpReceiver::field( qfi_FlightLog::Column::Roll  , 4, qfi_UdpReceiver::Type::Float32, true ) );
+    mapping.push_back( qfi_UdpReceiver::field( qfi_FlightLog::Column::Pitch , 8, qfi_UdpReceiver::Type::Float32, true ) );
+
+    qfi_UdpReceiver receiver;
+
+    receiver.setHeader( "DATA" );
+    receiver.setMapping( mapping );
+    receiver.addInstrument( &ai );
+
+    QObject::connect( &receiver, &qfi_UdpReceiver::received, &scheduler, &qfi_FrameScheduler::requestFrame );
+
+    if ( !receiver.start( 0, QHostAddress::LocalHost ) ) return result;
+
+    qfi_Latency::addView( &ai );
+    qfi_Latency::start();
+
+    std::atomic< bool > sending( true );
+    std::atomic< qint64 > sent( 0 );
+
+    const quint16 port = receiver.port();
+
+    // 1 kHz sender, roll and pitch as big-endian floats after the header
+    std::thread sender( [ &sending, &sent, port ]()
+    {
+        QUdpSocket socket;
+
+        char datagram[ 12 ] = { 'D', 'A', 'T', 'A' };
+
+        qfi_Scenario scenario( seed );
+
+        std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+
+        while ( sending )
+        {
+            next += std::chrono::milliseconds( 1 );
+            std::this_thread::sleep_until( next );
+
+            scenario.step( 0.001 );
+
+            const float values[] = { static_cast< float >( scenario.value( qfi_FlightLog::Column::Roll  ) ),
+                                     static_cast< float >( scenario.value( qfi_FlightLog::Column::Pitch ) ) };
+
+            for ( int i = 0; i < 2; i++ )
+            {
+                quint32 raw;
+                memcpy( &raw, &values[ i ], sizeof( raw ) );
+                qToBigEndian( raw, reinterpret_cast< uchar* >( datagram + 4 + 4 * i ) );
+            }
+
+            socket.writeDatagram( datagram, sizeof( datagram ), QHostAddress::LocalHost, port );
+            sent++;
+        }
+    } );
+
+    QEventLoop loop;
+    QTimer::singleShot( msec, &loop, &QEventLoop::quit );
+    loop.exec();
+
+    sending = false;
+    sender.join();
+
+    receiver.stop();
+
+    qfi_Latency::stop();
+
+    result[ "sent"      ] = static_cast< double >( sent.load() );
+    result[ "datagrams" ] = static_cast< double >( receiver.datagrams() );
+    result[ "batches"   ] = static_cast< double >( receiver.batches() );
+    result[ "rejected"  ] = static_cast< double >( receiver.rejected() );
+    result[ "frames"    ] = static_cast< double >( scheduler.frames() );
+    result[ "latency"   ] = latencyStats();
+
+    qfi_Latency::removeView( &ai );
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QJsonObject Bench::runLatency( int msec )
+{
+    QWidget panel;
+    QGridLayout *layout = new QGridLayout( &panel );
+    layout->setSpacing( 0 );
+    layout->setContentsMargins( 0, 0, 0, 0 );
+
+    QList< PanelItem > items;
+
+    items.push_back( createPanelItem< qfi_EADI >( &panel ) );
+    items.push_back( createPanelItem< qfi_EHSI >( &panel ) );
+    items.push_back( createPanelItem< qfi_AI   >( &panel ) );
+    items.push_back( createPanelItem< qfi_ALT  >( &panel ) );
+    items.push_back( createPanelItem< qfi_ASI  >( &panel ) );
+    items.push_back( createPanelItem< qfi_HI   >( &panel ) );
+    items.push_back( createPanelItem< qfi_TC   >( &panel ) );
+    items.push_back( createPanelItem< qfi_VSI  >( &panel ) );
+    items.push_back( createPanelItem< qfi_VOR  >( &panel ) );
+    items.push_back( createPanelItem< qfi_ILS  >( &panel ) );
+
+    for ( int i = 0; i < items.size(); i++ )
+    {
+        items.at( i ).view->setFixedSize( 240, 240 );
+        layout->addWidget( items.at( i ).view, i / 5, i % 5 );
+
+        qfi_Latency::addView( items.at( i ).view );
+    }
+
+    panel.show();
+    QApplication::processEvents();
+
+    qfi_FrameScheduler scheduler;
+
+    QObject::connect( &scheduler, &qfi_FrameScheduler::frame, [ &items ]()
+    {
+        for ( int i = 0; i < items.size(); i++ )
+        {
+            items.at( i ).redraw();
+        }
+    } );
+
+    qfi_Scenario scenario( seed );
+
+    int samples = 0;
+
+    // 1 kHz data bus, every sample is given to all the instruments by
+    // setState() and stamped right after
+    QTimer bus;
+    bus.setTimerType( Qt::PreciseTimer );
+
+    QObject::connect( &bus, &QTimer::timeout, [ &items, &samples, &scenario, &scheduler ]()
+    {
+        scenario.step( 0.01 );
+        samples++;
+
+        for ( int i = 0; i < items.size(); i++ )
+        {
+            items.at( i ).drive( scenario.values() );
+            qfi_Latency::stamp( items.at( i ).view );
+        }
+
+        scheduler.requestFrame();
+    } );
+
+    qfi_Latency::start();
+
+    bus.start( 1 );
+
+    QEventLoop loop;
+    QTimer::singleShot( msec, &loop, &QEventLoop::quit );
+    loop.exec();
+
+    bus.stop();
+
+    qfi_Latency::stop();
+
+    QJsonObject result;
+
+    result[ "samples"    ] = samples;
+    result[ "frames"     ] = static_cast< double >( scheduler.frames() );
+    result[ "targetRate" ] = scheduler.targetRate();
+    result[ "latency"    ] = latencyStats();
+
+    for ( int i = 0; i < items.size(); i++ )
+    {
+        qfi_Latency::removeView( items.at( i ).view );
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QJsonArray Bench::runScheduler( int msec )
+{
+    const int size = _sizes.isEmpty() ? 240 : _sizes.first();
+
+    QWidget panel;
+    QGridLayout *layout = new QGridLayout( &panel );
+    layout->setSpacing( 0 );
+    layout->setContentsMargins( 0, 0, 0, 0 );
+
+    QList< PanelItem > items;
+
+    items.push_back( createPanelItem< qfi_EADI >( &panel ) );
+    items.push_back( createPanelItem< qfi_EHSI >( &panel ) );
+    items.push_back( createPanelItem< qfi_AI   >( &panel ) );
+    items.push_back( createPanelItem< qfi_ALT  >( &panel ) );
+    items.push_back( createPanelItem< qfi_ASI  >( &panel ) );
+    items.push_back( createPanelItem< qfi_HI   >( &panel ) );
+    items.push_back( createPanelItem< qfi_TC   >( &panel ) );
+    items.push_back( createPanelItem< qfi_VSI  >( &panel ) );
+    items.push_back( createPanelItem< qfi_VOR  >( &panel ) );
+
+    for ( int i = 0; i < items.size(); i++ )
+    {
+        items.at( i ).view->setFixedSize( size, size );
+        layout->addWidget( items.at( i ).view, i / 3, i % 3 );
+    }
+
+    panel.show();
+    QApplication::processEvents();
+
+    qfi_Scenario scenario( seed );
+
+    int frames = 0;
+
+    // every frame changes all the instruments
+    std::function< void() > update = [ &items, &frames, &scenario ]()
+    {
+        scenario.step( 0.1 );
+        frames++;
+
+        for ( int i = 0; i < items.size(); i++ )
+        {
+            items.at( i ).drive( scenario.values() );
+            items.at( i ).redraw();
+        }
+    };
+
+    const char *modes[] = { "busyLoop", "schedulerIdle", "schedulerLoad" };
+
+    QJsonArray results;
+
+    for ( int mode = 0; mode < 3; mode++ )
+    {
+        QTimer busyTimer;
+        qfi_FrameScheduler scheduler;
+
+        if ( mode == 0 )
+        {
+            QObject::connect( &busyTimer, &QTimer::timeout, update );
+            busyTimer.start( 0 );
+        }
+        else
+        {
+            QObject::connect( &scheduler, &qfi_FrameScheduler::frame, update );
+            scheduler.setContinuous( mode == 2 );
+        }
+
+        frames = 0;
+
+        QEventLoop loop;
+        QTimer::singleShot( msec, &loop, &QEventLoop::quit );
+
+        qint64 cpu_0 = cpuTime();
+
+        QElapsedTimer timer;
+        timer.start();
+
+        loop.exec();
+
+        double wallUs = timer.nsecsElapsed() / 1000.0;
+
+        qint64 cpu_1 = cpuTime();
+
+        busyTimer.stop();
+        scheduler.setContinuous( false );
+
+        QJsonObject result;
+
+        result[ "mode"       ] = modes[ mode ];
+        result[ "frames"     ] = frames;
+        result[ "fps"        ] = 1.0e6 * frames / wallUs;
+        result[ "cpuPercent" ] = ( cpu_0 < 0 || cpu_1 < 0 ) ? -1.0 : 100.0 * ( cpu_1 - cpu_0 ) / wallUs;
+
+        if ( mode > 0 )
+        {
+            result[ "targetRate"    ] = scheduler.targetRate();
+            result[ "droppedFrames" ] = static_cast< double >( scheduler.droppedFrames() );
+        }
+
+        results.append( result );
+    }
+
+    return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 Bench::rss()
+{
+#   ifdef _LINUX_
+    long pages = 0;
+    long resident = 0;
+
+    FILE *file = fopen( "/proc/self/statm", "r" );
+
+    if ( file )
+    {
+        int count = fscanf( file, "%ld %ld", &pages, &resident );
+        fclose( file );
+
+        if ( count == 2 )
+        {
+            return static_cast< qint64 >( resident ) * sysconf( _SC_PAGESIZE );
+        }
+    }
+#   endif
+
+    return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 Bench::cpuTime()
+{
+#   ifdef _LINUX_
+    struct rusage usage;
+
+    if ( getrusage( RUSAGE_SELF, &usage ) == 0 )
+    {
+        return static_cast< qint64 >( usage.ru_utime.tv_sec + usage.ru_stime.tv_sec ) * 1000000
+             + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+    }
+#   endif
+
+    return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template < class T >
+QJsonObject Bench::runInstrument( const char *name, RenderBackend backend )
+{
+    qfi_Cache::clear();
+
+    qint64 rss_0   = rss();
+    qint64 atlas_0 = qfi_AtlasSvgItem::totalBytes();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    T *instrument = newInstrument< T >( backend );
+
+    qint64 constructUs = timer.nsecsElapsed() / 1000;
+
+    QJsonArray sizeResults;
+
+    for ( int i = 0; i < _sizes.size(); i++ )
+    {
+        const int size = _sizes.at( i );
+
+        QImage image( size, size, QImage::Format_ARGB32_Premultiplied );
+
+        // first frame resizes and rebuilds hidden instrument
+        instrument->renderImage( image );
+
+        QList< qint64 > reinitTimes;
+
+        for ( int j = 0; j < 5; j++ )
+        {
+            timer.restart();
+            instrument->reinit();
+            reinitTimes.push_back( timer.nsecsElapsed() / 1000 );
+        }
+
+        QList< qint64 > frameTimes;
+
+        qfi_Scenario scenario( seed );
+
+        for ( int frame = 0; frame < _warmUpFrames + _frames; frame++ )
+        {
+            scenario.step( 0.1 );
+
+            timer.restart();
+
+            drive( instrument, scenario.values() );
+            instrument->renderImage( image );
+
+            if ( frame >= _warmUpFrames )
+            {
+                frameTimes.push_back( timer.nsecsElapsed() / 1000 );
+            }
+        }
+
+        QJsonObject result;
+
+        result[ "size"     ] = size;
+        result[ "reinitUs" ] = frameStats( reinitTimes );
+        result[ "frameUs"  ] = frameStats( frameTimes );
+
+        sizeResults.append( result );
+    }
+
+    QJsonObject memory;
+
+    qint64 rss_1 = rss();
+
+    memory[ "rssBytes"   ] = ( rss_0 < 0 || rss_1 < 0 ) ? -1.0 : static_cast< double >( rss_1 - rss_0 );
+    memory[ "cacheBytes" ] = static_cast< double >( qfi_Cache::stats().bytes );
+    memory[ "atlasBytes" ] = static_cast< double >( qfi_AtlasSvgItem::totalBytes() - atlas_0 );
+
+    delete instrument;
+
+    QJsonObject result;
+
+    result[ "name"        ] = QString( name );
+    result[ "backend"     ] = backend == RenderBackend::Painter ? "painter" : "scene";
+    result[ "constructUs" ] = static_cast< double >( constructUs );
+    result[ "sizes"       ] = sizeResults;
+    result[ "memory"      ] = memory;
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QJsonObject Bench::frameStats( QList< qint64 > times )
+{
+    QJsonObject stats;
+
+    if ( times.isEmpty() ) return stats;
+
+    std::sort( times.begin(), times.end() );
+
+    double sum = 0.0;
+
+    for ( int i = 0; i < times.size(); i++ )
+    {
+        sum += times.at( i );
+    }
+
+    const int count = static_cast< int >( times.size() );
+
+    int i95 = qMin( count - 1, static_cast< int >( 0.95 * count ) );
+
+    stats[ "mean"   ] = sum / count;
+    stats[ "median" ] = static_cast< double >( times.at( count / 2 ) );
+    stats[ "p95"    ] = static_cast< double >( times.at( i95 ) );
+    stats[ "min"    ] = static_cast< double >( times.first() );
+    stats[ "max"    ] = static_cast< double >( times.last() );
+
+    return stats;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QJsonArray Bench::latencyStats()
+{
+    QJsonArray results;
+
+    QList< qfi_Latency::Stats > stats = qfi_Latency::snapshot();
+
+    for ( int i = 0; i < stats.size(); i++ )
+    {
+        QJsonObject instrument;
+
+        instrument[ "name"        ] = stats.at( i ).name;
+        instrument[ "count"       ] = stats.at( i ).count;
+        instrument[ "p50Us"       ] = static_cast< double >( stats.at( i ).p50 );
+        instrument[ "p95Us"       ] = static_cast< double >( stats.at( i ).p95 );
+        instrument[ "p99Us"       ] = static_cast< double >( stats.at( i ).p99 );
+        instrument[ "maxUs"       ] = static_cast< double >( stats.at( i ).max );
+        instrument[ "updateP50Us" ] = static_cast< double >( stats.at( i ).updateP50 );
+        instrument[ "paintP50Us"  ] = static_cast< double >( stats.at( i ).paintP50 );
+
+        results.append( instrument );
+    }
+
+    return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template < class T >
+QJsonObject Bench::compareBackend( const char *name )
+{
+    T *scene   = newInstrument< T >( RenderBackend::Scene   );
+    T *painter = newInstrument< T >( RenderBackend::Painter );
+
+    int images = 0;
+    int maxDiff = 0;
+    qint64 differentPixels = 0;
+
+    for ( int i = 0; i < _sizes.size(); i++ )
+    {
+        const int size = _sizes.at( i );
+
+        QImage imageScene   ( size, size, QImage::Format_ARGB32_Premultiplied );
+        QImage imagePainter ( size, size, QImage::Format_ARGB32_Premultiplied );
+
+        // states half a minute apart, through several maneuvers
+        qfi_Scenario scenario( seed );
+
+        for ( int j = 0; j < 10; j++ )
+        {
+            scenario.step( 30.0 );
+
+            drive( scene   , scenario.values() );
+            drive( painter , scenario.values() );
+
+            scene   ->renderImage( imageScene   );
+            painter ->renderImage( imagePainter );
+
+            for ( int y = 0; y < size; y++ )
+            {
+                const QRgb *line_s = reinterpret_cast< const QRgb* >( imageScene   .constScanLine( y ) );
+                const QRgb *line_p = reinterpret_cast< const QRgb* >( imagePainter .constScanLine( y ) );
+
+                for ( int x = 0; x < size; x++ )
+                {
+                    if ( line_s[ x ] != line_p[ x ] )
+                    {
+                        int diff = qMax( qMax( qAbs( qRed   ( line_s[ x ] ) - qRed   ( line_p[ x ] ) ),
+                                               qAbs( qGreen ( line_s[ x ] ) - qGreen ( line_p[ x ] ) ) ),
+                                         qMax( qAbs( qBlue  ( line_s[ x ] ) - qBlue  ( line_p[ x ] ) ),
+                                               qAbs( qAlpha ( line_s[ x ] ) - qAlpha ( line_p[ x ] ) ) ) );
+
+                        maxDiff = qMax( maxDiff, diff );
+                        differentPixels++;
+                    }
+                }
+            }
+
+            images++;
+        }
+    }
+
+    delete scene;
+    delete painter;
+
+    QJsonObject result;
+
+    result[ "name"            ] = QString( name );
+    result[ "images"          ] = images;
+    result[ "differentPixels" ] = static_cast< double >( differentPixels );
+    result[ "maxDiff"         ] = maxDiff;
+
+    return result;
+}
@@ -0,0 +1,170 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef BENCH_H
+#define BENCH_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+
+#include <qfi/qfi_enums.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Instruments benchmark class.
+ *
+ * Measures construction time, reinit() time, redraw and paint time at
+ * several sizes and memory footprint of every instrument, rendering them
+ * with renderImage(), so it runs headless. Optionally measures scaling
+ * of qfi_ParallelRenderer with the number of worker threads and CPU usage
+ * of qfi_FrameScheduler.
+ */
+class Bench
+{
+public:
+
+    /**
+     * @param frames number of measured frames per size
+     * @param sizes [px] instrument sizes
+     */
+    Bench( int frames, const QList< int > &sizes );
+
+    /** @return results of all instrument benchmarks */
+    QJsonArray runInstruments();
+
+    /**
+     * Renders instruments supporting RenderBackend::Painter with both
+     * backends at all sizes and in several states and compares images.
+     * @return comparison results, "differentPixels" have to be 0
+     */
+    QJsonArray compareBackends();
+
+    /**
+     * Measures qfi_EADI frame times with readouts drawn as text every frame
+     * and with pre-rendered glyphs (see qfi_GlyphTextItem).
+     * @return results of both modes, "speedup" are ratios of median frame
+     * times per size
+     */
+    QJsonObject runGlyphs();
+
+    /**
+     * @param counts numbers of instruments in measured panels
+     * @param maxThreads maximum number of worker threads
+     * @return results of parallel rendering benchmarks
+     */
+    QJsonArray runPanels( const QList< int > &counts, int maxThreads );
+
+    /**
+     * Compares frame times of instruments shown in separate views with
+     * instruments shown in a single qfi_Panel.
+     * @param counts numbers of instruments
+     * @return results of single scene benchmarks
+     */
+    QJsonArray runScene( const QList< int > &counts );
+
+    /**
+     * Stress tests qfi_TripleBuffer: a producer thread publishes states with
+     * all fields set to the same counter as fast as possible, while consumer
+     * checks that every taken state is consistent and not older than
+     * the previous one.
+     * @param msec [ms] test duration
+     * @return test results, "torn" and "regressions" have to be 0
+     */
+    static QJsonObject runStress( int msec );
+
+    /**
+     * Measures CPU usage of a shown panel driven by an event loop busy loop
+     * (zero interval timer), by idle qfi_FrameScheduler and by continuously
+     * running qfi_FrameScheduler.
+     * @param msec [ms] duration of every mode
+     * @return results of all modes
+     */
+    QJsonArray runScheduler( int msec );
+
+    /**
+     * Writes flight log of 1 kHz samples of all columns, then measures
+     * opening it and random seeks (qfi_FlightLog::find() and read()).
+     * @param samples number of samples
+     * @return replay benchmark results
+     */
+    static QJsonObject runReplay( qint64 samples );
+
+    /**
+     * Records 50 instruments, states of all of them are set every
+     * millisecond (1 kHz per instrument) on the calling thread.
+     * @param msec [ms] test duration
+     * @return recorder benchmark results, "tickUs" are times of setting
+     * states of all instruments, "droppedSamples" have to be 0
+     */
+    static QJsonObject runRecorder( int msec );
+
+    /**
+     * Sends roll and pitch datagrams at 1 kHz over loopback to
+     * qfi_UdpReceiver driving a shown qfi_AI through qfi_FrameScheduler.
+     * @param msec [ms] test duration
+     * @return UDP benchmark results, "latency" are times from datagram batch
+     * arrival (stamped by the receiver thread, see
+     * qfi_UdpReceiver::lastArrival()) to the end of painting the frame
+     * showing it
+     */
+    static QJsonObject runUdp( int msec );
+
+    /**
+     * Measures latency of a shown panel of all instruments driven by setState()
+     * at 1 kHz and redrawn by qfi_FrameScheduler, see qfi_Latency.
+     * @param msec [ms] test duration
+     * @return latency benchmark results, per instrument
+     */
+    static QJsonObject runLatency( int msec );
+
+    /** @return [B] resident set size, -1 if not available */
+    static qint64 rss();
+
+    /** @return [us] process CPU time, -1 if not available */
+    static qint64 cpuTime();
+
+private:
+
+    const int _frames;          ///< number of measured frames per size
+    const int _warmUpFrames;    ///< number of frames not measured
+
+    QList< int > _sizes;        ///< [px] instrument sizes
+
+    template < class T >
+    QJsonObject runInstrument( const char *name,
+                               RenderBackend backend = RenderBackend::Scene );
+
+    template < class T >
+    QJsonObject compareBackend( const char *name );
+
+    static QJsonObject frameStats( QList< qint64 > times );
+
+    static QJsonArray latencyStats();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // BENCH_H
@@ -0,0 +1,6 @@
+HEADERS += \
+    $$PWD/Bench.h
+
+SOURCES += \
+    $$PWD/Bench.cpp \
+    $$PWD/main.cpp
@@ -0,0 +1,314 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+#include <QApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QStringList>
+#include <QThread>
+
+#include <iostream>
+
+#include <bench/Bench.h>
+
+#include <qfi/qfi_Profiler.h>
+#include <qfi/qfi_Renderers.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+void printUsage()
+{
+    cout << "Usage: qfi_bench [options]" << endl;
+    cout << "  -o <file>          output JSON file (default: standard output)" << endl;
+    cout << "  -frames <n>        number of measured frames per size (default: 200)" << endl;
+    cout << "  -sizes <list>      comma separated sizes [px] (default: 120,240,480,960)" << endl;
+    cout << "  -panels <list>     comma separated parallel panel sizes (default: none)" << endl;
+    cout << "  -threads <n>       maximum number of worker threads (default: ideal)" << endl;
+    cout << "  -scene <list>      comma separated single scene panel sizes (default: none)" << endl;
+    cout << "  -stress <ms>       only stress tests state triple buffer for given time" << endl;
+    cout << "  -cpu <ms>          only measures CPU usage of busy loop and frame scheduler" << endl;
+    cout << "  -compare           only compares images rendered with scene and painter backends" << endl;
+    cout << "  -glyphs            only measures EADI frame times with text and with glyph readouts" << endl;
+    cout << "  -replay <n>        only measures writing, opening and seeking flight log of n samples" << endl;
+    cout << "  -record <ms>       only records 50 instruments at 1 kHz for given time" << endl;
+    cout << "  -udp <ms>          only measures latency of 1 kHz UDP data for given time" << endl;
+    cout << "  -latency <ms>      only measures latency of all instruments driven at 1 kHz for given time" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QList< int > parseList( const QString &text )
+{
+    QList< int > list;
+
+    QStringList items = text.split( ',' );
+
+    for ( int i = 0; i < items.size(); i++ )
+    {
+        int value = items.at( i ).toInt();
+        if ( value > 0 ) list.push_back( value );
+    }
+
+    return list;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main( int argc, char *argv[] )
+{
+    // benchmark runs headless unless platform is given explicitly
+    if ( qEnvironmentVariableIsEmpty( "QT_QPA_PLATFORM" ) )
+    {
+        qputenv( "QT_QPA_PLATFORM", "offscreen" );
+    }
+
+    QApplication app( argc, argv );
+
+    QString output;
+
+    int frames  = 200;
+    int threads = QThread::idealThreadCount();
+    int stress  = 0;
+    int cpu     = 0;
+    int record  = 0;
+    int udp     = 0;
+    int latency = 0;
+
+    qint64 replay = 0;
+
+    bool compare = false;
+    bool glyphs  = false;
+
+    QList< int > sizes = { 120, 240, 480, 960 };
+    QList< int > panels;
+    QList< int > scene;
+
+    QStringList args = app.arguments();
+
+    for ( int i = 1; i < args.size(); i++ )
+    {
+        const QString &arg = args.at( i );
+
+        bool hasValue = i + 1 < args.size();
+
+        if      ( arg == "-o"       && hasValue ) output  = args.at( ++i );
+        else if ( arg == "-frames"  && hasValue ) frames  = args.at( ++i ).toInt();
+        else if ( arg == "-sizes"   && hasValue ) sizes   = parseList( args.at( ++i ) );
+        else if ( arg == "-panels"  && hasValue ) panels  = parseList( args.at( ++i ) );
+        else if ( arg == "-threads" && hasValue ) threads = args.at( ++i ).toInt();
+        else if ( arg == "-scene"   && hasValue ) scene   = parseList( args.at( ++i ) );
+        else if ( arg == "-stress"  && hasValue ) stress  = args.at( ++i ).toInt();
+        else if ( arg == "-cpu"     && hasValue ) cpu     = args.at( ++i ).toInt();
+        else if ( arg == "-replay"  && hasValue ) replay  = args.at( ++i ).toLongLong();
+        else if ( arg == "-record"  && hasValue ) record  = args.at( ++i ).toInt();
+        else if ( arg == "-udp"     && hasValue ) udp     = args.at( ++i ).toInt();
+        else if ( arg == "-latency" && hasValue ) latency = args.at( ++i ).toInt();
+        else if ( arg == "-compare" ) compare = true;
+        else if ( arg == "-glyphs"  ) glyphs  = true;
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if ( frames < 1 ) frames = 1;
+    if ( threads < 1 ) threads = 1;
+
+    Bench bench( frames, sizes );
+
+    QJsonObject report;
+
+    report[ "qt"       ] = QString( qVersion() );
+    report[ "platform" ] = QApplication::platformName();
+
+    if ( stress > 0 )
+    {
+        QJsonObject result = Bench::runStress( stress );
+
+        report[ "stress" ] = result;
+
+        cout << QJsonDocument( report ).toJson().constData();
+
+        return ( result[ "torn" ].toDouble() == 0.0 && result[ "regressions" ].toDouble() == 0.0 ) ? 0 : 2;
+    }
+
+    if ( compare )
+    {
+        QJsonArray results = bench.compareBackends();
+
+        report[ "compare" ] = results;
+
+        cout << QJsonDocument( report ).toJson().constData();
+
+        for ( int i = 0; i < results.size(); i++ )
+        {
+            if ( results.at( i ).toObject()[ "differentPixels" ].toDouble() != 0.0 ) return 3;
+        }
+
+        return 0;
+    }
+
+    if ( glyphs )
+    {
+        report[ "frames" ] = frames;
+        report[ "glyphs" ] = bench.runGlyphs();
+
+        cout << QJsonDocument( report ).toJson().constData();
+
+        return 0;
+    }
+
+    if ( replay > 0 )
+    {
+        report[ "replay" ] = Bench::runReplay( replay );
+
+        cout << QJsonDocument( report ).toJson().constData();
+
+        return 0;
+    }
+
+    if ( record > 0 )
+    {
+        QJsonObject result = Bench::runRecorder( record );
+
+        report[ "record" ] = result;
+
+        cout << QJsonDocument( report ).toJson().constData();
+
+        return ( !result.isEmpty() && result[ "droppedSamples" ].toDouble() == 0.0 ) ? 0 : 4;
+    }
+
+    if ( udp > 0 )
+    {
+        QJsonObject result = Bench::runUdp( udp );
+
+        report[ "udp" ] = result;
+
+        cout << QJsonDocument( report ).toJson().constData();
+
+        return ( !result.isEmpty() && result[ "datagrams" ].toDouble() > 0.0 ) ? 0 : 5;
+    }
+
+    if ( latency > 0 )
+    {
+        QJsonObject result = Bench::runLatency( latency );
+
+        report[ "latency" ] = result;
+
+        cout << QJsonDocument( report ).toJson().constData();
+
+        // every instrument has to display data within 50 ms (99th percentile)
+        QJsonArray instruments = result[ "latency" ].toArray();
+
+        for ( int i = 0; i < instruments.size(); i++ )
+        {
+            QJsonObject instrument = instruments.at( i ).toObject();
+
+            if ( instrument[ "count" ].toDouble() == 0.0
+              || instrument[ "p99Us" ].toDouble() > 50000.0 ) return 6;
+        }
+
+        return 0;
+    }
+
+    if ( cpu > 0 )
+    {
+        report[ "cpu" ] = bench.runScheduler( cpu );
+
+        cout << QJsonDocument( report ).toJson().constData();
+
+        return 0;
+    }
+
+    report[ "frames"   ] = frames;
+
+    report[ "instruments" ] = bench.runInstruments();
+
+    if ( !panels.isEmpty() )
+    {
+        report[ "panels" ] = bench.runPanels( panels, threads );
+    }
+
+    if ( !scene.isEmpty() )
+    {
+        report[ "scene" ] = bench.runScene( scene );
+    }
+
+    QJsonObject renderers;
+
+    renderers[ "parseUs"   ] = static_cast< double >( qfi_Renderers::totalParseTime() );
+    renderers[ "fileBytes" ] = static_cast< double >( qfi_Renderers::totalFileSize() );
+
+    report[ "renderers" ] = renderers;
+
+    // per layer paint times, available if built with CONFIG += qfi_profiling
+    if ( qfi_Profiler::isEnabled() )
+    {
+        QJsonArray layers;
+
+        QList< qfi_Profiler::Stats > stats = qfi_Profiler::snapshot();
+
+        for ( int i = 0; i < stats.size(); i++ )
+        {
+            QJsonObject layer;
+
+            layer[ "name"  ] = stats.at( i ).name;
+            layer[ "count" ] = stats.at( i ).count;
+            layer[ "p50Ns" ] = static_cast< double >( stats.at( i ).p50 );
+            layer[ "p95Ns" ] = static_cast< double >( stats.at( i ).p95 );
+            layer[ "p99Ns" ] = static_cast< double >( stats.at( i ).p99 );
+            layer[ "maxNs" ] = static_cast< double >( stats.at( i ).max );
+
+            layers.append( layer );
+        }
+
+        report[ "layers" ] = layers;
+    }
+
+    QByteArray json = QJsonDocument( report ).toJson();
+
+    if ( output.isEmpty() )
+    {
+        cout << json.constData();
+    }
+    else
+    {
+        QFile file( output );
+
+        if ( !file.open( QIODevice::WriteOnly ) )
+        {
+            cerr << "Cannot open file: " << output.toLocal8Bit().constData() << endl;
+            return 1;
+        }
+
+        file.write( json );
+    }
+
+    return 0;
+}
@@ -26,28 +26,130 @@
 #include <iostream>
 #include <cmath>
 
+#include <qfi/qfi_Trace.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 
 using namespace std;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+
+template < class T >
+void addInstruments( qfi_FrameScheduler *scheduler, qfi_QualityGovernor *governor,
+                     qfi_QualityGovernor::Priority priority, QObject *parent )
+{
+    QList< T* > instruments = parent->findChildren< T* >();
+
+    for ( int i = 0; i < instruments.size(); i++ )
+    {
+        scheduler->addInstrument( instruments.at( i ) );
+        governor->addInstrument( instruments.at( i ), priority );
+    }
+}
+
+template < class T >
+void addInstruments( qfi_Replay *replay, QObject *parent )
+{
+    QList< T* > instruments = parent->findChildren< T* >();
+
+    for ( int i = 0; i < instruments.size(); i++ )
+    {
+        replay->addInstrument( instruments.at( i ) );
+    }
+}
+
+template < class T >
+void addInstruments( qfi_Recorder *recorder, QObject *parent )
+{
+    QList< T* > instruments = parent->findChildren< T* >();
+
+    for ( int i = 0; i < instruments.size(); i++ )
+    {
+        recorder->addInstrument( instruments.at( i ) );
+    }
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
 MainWindow::MainWindow( QWidget *parent ) :
     QMainWindow( parent ),
     _ui( new Ui::MainWindow ),
 
-    _timerId ( 0 ),
-    _steps   ( 0 ),
+    _scheduler ( Q_NULLPTR ),
+    _governor  ( Q_NULLPTR ),
+    _replay    ( Q_NULLPTR ),
+    _recorder  ( Q_NULLPTR ),
+    _scenario  ( Q_NULLPTR ),
+
+    _steps ( 0 ),
 
     _realTime ( 0.0 ),
     _playTime ( 0.0 )
 {
     _ui->setupUi( this );
 
-    _timerId = startTimer( 0 );
+    // instruments are redrawn at the screen refresh rate, continuously while
+    // playing, otherwise only after parameters have been changed
+    _scheduler = new qfi_FrameScheduler( this );
+
+    // when frames do not fit in the budget, the secondary and low priority
+    // instruments are degraded, primary flight instruments never are
+    _governor = new qfi_QualityGovernor( _scheduler, this );
+
+    const qfi_QualityGovernor::Priority primary   = qfi_QualityGovernor::Priority::Primary;
+    const qfi_QualityGovernor::Priority secondary = qfi_QualityGovernor::Priority::Secondary;
+    const qfi_QualityGovernor::Priority low       = qfi_QualityGovernor::Priority::Low;
+
+    addInstruments< qfi_EADI >( _scheduler, _governor, primary   , this );
+    addInstruments< qfi_EHSI >( _scheduler, _governor, secondary , this );
+    addInstruments< qfi_AI   >( _scheduler, _governor, primary   , this );
+    addInstruments< qfi_ALT  >( _scheduler, _governor, secondary , this );
+    addInstruments< qfi_ASI  >( _scheduler, _governor, secondary , this );
+    addInstruments< qfi_HI   >( _scheduler, _governor, secondary , this );
+    addInstruments< qfi_TC   >( _scheduler, _governor, low       , this );
+    addInstruments< qfi_VSI  >( _scheduler, _governor, secondary , this );
+    addInstruments< qfi_VOR  >( _scheduler, _governor, low       , this );
+
+    connect( _scheduler, &qfi_FrameScheduler::frame, this, &MainWindow::updateInstruments );
 
-    //_time.start();
-    _time.currentTime();
+    QList< QDoubleSpinBox* > spinBoxes = findChildren< QDoubleSpinBox* >();
+
+    for ( int i = 0; i < spinBoxes.size(); i++ )
+    {
+        connect( spinBoxes.at( i ), QOverload< double >::of( &QDoubleSpinBox::valueChanged ),
+                 _scheduler, &qfi_FrameScheduler::requestFrame );
+    }
+
+    QList< QComboBox* > comboBoxes = findChildren< QComboBox* >();
+
+    for ( int i = 0; i < comboBoxes.size(); i++ )
+    {
+        connect( comboBoxes.at( i ), QOverload< int >::of( &QComboBox::currentIndexChanged ),
+                 _scheduler, &qfi_FrameScheduler::requestFrame );
+    }
+
+    connect( _ui->pushButtonStall, &QPushButton::toggled, _scheduler, &qfi_FrameScheduler::requestFrame );
+    connect( _ui->pushButtonPlay , &QPushButton::toggled, this, &MainWindow::setPlaying );
+
+    // instruments are traced if tracing has been enabled (-trace option)
+    if ( qfi_Trace::isActive() )
+    {
+        QList< QGraphicsView* > views = findChildren< QGraphicsView* >();
+
+        for ( int i = 0; i < views.size(); i++ )
+        {
+            qfi_Trace::addView( views.at( i ) );
+        }
+    }
+
+    _time.start();
+
+    _scheduler->requestFrame();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -55,8 +157,24 @@ MainWindow::MainWindow( QWidget *parent ) :
 MainWindow::~MainWindow()
 {
     cout << "Average time step: " << _realTime / ( static_cast< double >( _steps ) ) << " s" << endl;
+    cout << "Frames: " << _scheduler->frames()
+         << " (coalesced requests: " << _scheduler->coalescedRequests()
+         << ", dropped: " << _scheduler->droppedFrames() << ")" << endl;
+    cout << "Quality level: " << _governor->level() << endl;
 
-    if ( _timerId ) killTimer( _timerId );
+    if ( _recorder )
+    {
+        _recorder->stop();
+
+        cout << "Recorded samples: " << _recorder->samples()
+             << " (dropped: " << _recorder->droppedSamples() << ")" << endl;
+
+        delete _recorder;
+        _recorder = Q_NULLPTR;
+    }
+
+    if ( _scenario ) delete _scenario;
+    _scenario = Q_NULLPTR;
 
     if ( _ui ) delete _ui;
     _ui = Q_NULLPTR;
@@ -64,16 +182,90 @@ MainWindow::~MainWindow()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void MainWindow::timerEvent( QTimerEvent *event )
+bool MainWindow::replay( const QString &fileName, double speed, qint64 source )
 {
-    /////////////////////////////////
-    QMainWindow::timerEvent( event );
-    /////////////////////////////////
+    // logs recorded by qfi_Recorder have no source 0 (the whole aircraft),
+    // every instrument is a source, the first one is EADI logging most columns
+    if ( source < 0 )
+    {
+        qfi_FlightLog log;
+
+        if ( !log.open( fileName ) ) return false;
+
+        const QVector< quint32 > &sources = log.sources();
+
+        source = ( sources.isEmpty() || sources.contains( 0 ) ) ? 0 : sources.first();
+    }
+
+    if ( !_replay )
+    {
+        _replay = new qfi_Replay( _scheduler, this );
+
+        addInstruments< qfi_EADI >( _replay, this );
+        addInstruments< qfi_EHSI >( _replay, this );
+        addInstruments< qfi_AI   >( _replay, this );
+        addInstruments< qfi_ALT  >( _replay, this );
+        addInstruments< qfi_ASI  >( _replay, this );
+        addInstruments< qfi_HI   >( _replay, this );
+        addInstruments< qfi_TC   >( _replay, this );
+        addInstruments< qfi_VSI  >( _replay, this );
+        addInstruments< qfi_VOR  >( _replay, this );
+    }
+
+    if ( !_replay->open( fileName, static_cast< quint32 >( source ) ) ) return false;
+
+    _replay->setSpeed( speed );
+    _replay->play();
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool MainWindow::record( const QString &fileName )
+{
+    if ( !_recorder )
+    {
+        _recorder = new qfi_Recorder();
+
+        addInstruments< qfi_EADI >( _recorder, this );
+        addInstruments< qfi_EHSI >( _recorder, this );
+        addInstruments< qfi_AI   >( _recorder, this );
+        addInstruments< qfi_ALT  >( _recorder, this );
+        addInstruments< qfi_ASI  >( _recorder, this );
+        addInstruments< qfi_HI   >( _recorder, this );
+        addInstruments< qfi_TC   >( _recorder, this );
+        addInstruments< qfi_VSI  >( _recorder, this );
+        addInstruments< qfi_VOR  >( _recorder, this );
+    }
+
+    return _recorder->start( fileName );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::playScenario( quint32 seed )
+{
+    if ( _scenario )
+        _scenario->reset( seed );
+    else
+        _scenario = new qfi_Scenario( seed );
+
+    _ui->pushButtonPlay->setChecked( true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::updateInstruments()
+{
+    // instruments are driven by the flight log being replayed
+    if ( _replay && _replay->log().isOpen() ) return;
 
     // getting time step
-    double timeStep = _time.second();
+    double timeStep = 1.0e-9 * _time.nsecsElapsed();
+    _time.restart();
 
-    _realTime = _realTime + timeStep / 100.0;
+    _realTime = _realTime + timeStep;
 
     // flight and navigation parameters to be shown on instruments
     double alpha     =  0.0;
@@ -110,11 +302,78 @@ void MainWindow::timerEvent( QTimerEvent *event )
 
     qfi_EADI::PressureMode press_mode = qfi_EADI::PressureMode::STD;
 
-    if ( _ui->pushButtonPlay->isChecked() )
+    if ( _ui->pushButtonPlay->isChecked() && _scenario )
+    {
+        // synthetic flight scenario, modes and stall are set by the scenario too
+
+        _scenario->step( timeStep );
+
+        typedef qfi_FlightLog::Column Column;
+
+        alpha     = _scenario->value( Column::AngleOfAttack );
+        beta      = _scenario->value( Column::Sideslip      );
+        roll      = _scenario->value( Column::Roll          );
+        pitch     = _scenario->value( Column::Pitch         );
+        heading   = _scenario->value( Column::Heading       );
+        slipSkid  = _scenario->value( Column::SlipSkid      );
+        turnRate  = _scenario->value( Column::TurnRate      );
+        devLC     = _scenario->value( Column::DotV          );
+        devGS     = _scenario->value( Column::DotH          );
+        fd_r      = _scenario->value( Column::FdRoll        ) - roll;
+        fd_p      = _scenario->value( Column::FdPitch       ) - pitch;
+        airspeed  = _scenario->value( Column::Airspeed      );
+        altitude  = _scenario->value( Column::Altitude      );
+        pressure  = _scenario->value( Column::Pressure      );
+        climbRate = _scenario->value( Column::ClimbRate     );
+        machNo    = _scenario->value( Column::MachNo        );
+        hdg       = _scenario->value( Column::HeadingSel    );
+        crs       = _scenario->value( Column::Course        );
+        vor       = _scenario->value( Column::Deviation     );
+        adf       = _scenario->value( Column::Bearing       );
+        dme       = _scenario->value( Column::Distance      );
+        sel_ias   = _scenario->value( Column::AirspeedSel   );
+        sel_alt   = _scenario->value( Column::AltitudeSel   );
+
+        const int flags = static_cast< int >( _scenario->value( Column::Flags ) );
+
+        _ui->comboBoxFltMode ->setCurrentIndex( static_cast< int >( _scenario->value( Column::FltMode      ) ) );
+        _ui->comboBoxSpdMode ->setCurrentIndex( static_cast< int >( _scenario->value( Column::SpdMode      ) ) );
+        _ui->comboBoxLNAV    ->setCurrentIndex( static_cast< int >( _scenario->value( Column::LNAV         ) ) );
+        _ui->comboBoxVNAV    ->setCurrentIndex( static_cast< int >( _scenario->value( Column::VNAV         ) ) );
+        _ui->comboBoxCDI     ->setCurrentIndex( static_cast< int >( _scenario->value( Column::CDI          ) ) );
+        _ui->comboBoxPress   ->setCurrentIndex( static_cast< int >( _scenario->value( Column::PressureMode ) ) );
+
+        _ui->pushButtonStall->setChecked( ( flags & qfi_FlightLog::Stall ) != 0 );
+
+        _ui->spinBoxAlpha  ->setValue( alpha     );
+        _ui->spinBoxBeta   ->setValue( beta      );
+        _ui->spinBoxRoll   ->setValue( roll      );
+        _ui->spinBoxPitch  ->setValue( pitch     );
+        _ui->spinBoxSlip   ->setValue( slipSkid  );
+        _ui->spinBoxTurn   ->setValue( turnRate  );
+        _ui->spinBoxLC     ->setValue( devLC     );
+        _ui->spinBoxGS     ->setValue( devGS     );
+        _ui->spinBoxFDR    ->setValue( fd_r      );
+        _ui->spinBoxFDP    ->setValue( fd_p      );
+        _ui->spinBoxHead   ->setValue( heading   );
+        _ui->spinBoxSpeed  ->setValue( airspeed  );
+        _ui->spinBoxMach   ->setValue( machNo    );
+        _ui->spinBoxAlt    ->setValue( altitude  );
+        _ui->spinBoxPress  ->setValue( pressure  );
+        _ui->spinBoxClimb  ->setValue( climbRate );
+        _ui->spinBoxHDG    ->setValue( hdg       );
+        _ui->spinBoxCRS    ->setValue( crs       );
+        _ui->spinBoxVOR    ->setValue( vor       );
+        _ui->spinBoxADF    ->setValue( adf       );
+        _ui->spinBoxDME    ->setValue( dme       );
+        _ui->spinBoxSelIAS ->setValue( sel_ias   );
+        _ui->spinBoxSelALT ->setValue( sel_alt   );
+    }
+    else if ( _ui->pushButtonPlay->isChecked() )
     {
         // automatic parametes setting
 
-        _playTime = _playTime + timeStep / 100.0;
+        _playTime = _playTime + timeStep;
 
         alpha     =     20.0 * sin( _playTime /  10.0 );
         beta      =     15.0 * sin( _playTime /  10.0 );
@@ -256,69 +515,106 @@ void MainWindow::timerEvent( QTimerEvent *event )
 
     // setting widgets data
 
+    qint64 settersStart = qfi_Trace::now();
+
     // EADI
-    _ui->widgetEADI->setFltMode     ( fltMode );
-    _ui->widgetEADI->setSpdMode     ( spdMode );
-    _ui->widgetEADI->setLNAV        ( lnav    );
-    _ui->widgetEADI->setVNAV        ( vnav    );
-    _ui->widgetEADI->setRoll        ( roll    );
-    _ui->widgetEADI->setPitch       ( pitch   );
-    _ui->widgetEADI->setFPM         ( alpha, beta );
-    _ui->widgetEADI->setSlipSkid    ( slipSkid  );
-    _ui->widgetEADI->setTurnRate    ( turnRate / 6.0 );
-    _ui->widgetEADI->setDots        ( devGS, devLC, true, true );
-    _ui->widgetEADI->setFD          ( fd_roll, fd_pitch, true );
-    _ui->widgetEADI->setStall       ( _ui->pushButtonStall->isChecked() );
-    _ui->widgetEADI->setHeading     ( heading   );
-    _ui->widgetEADI->setAirspeed    ( airspeed  );
-    _ui->widgetEADI->setMachNo      ( machNo    );
-    _ui->widgetEADI->setAltitude    ( altitude  );
-    _ui->widgetEADI->setPressure    ( press_coef * pressure, press_mode );
-    _ui->widgetEADI->setClimbRate   ( climbRate / 1000.0 );
-    _ui->widgetEADI->setAirspeedSel ( sel_ias );
-    _ui->widgetEADI->setAltitudeSel ( sel_alt );
-    _ui->widgetEADI->setHeadingSel  ( hdg );
-    //_ui->widgetEADI->setIdentifier  ( "ILAX" , true );
-    //_ui->widgetEADI->setDistance    ( dme    , true );
-    _ui->widgetEADI->setVfe         (  85.0 );
-    _ui->widgetEADI->setVne         ( 158.0 );
+    qfi_EADI::State eadi;
+
+    eadi.fltMode      = fltMode;
+    eadi.spdMode      = spdMode;
+    eadi.lnav         = lnav;
+    eadi.vnav         = vnav;
+    eadi.pressureMode = press_mode;
+    eadi.roll         = roll;
+    eadi.pitch        = pitch;
+    eadi.aoa          = alpha;
+    eadi.sideslip     = beta;
+    eadi.slipSkid     = slipSkid;
+    eadi.turnRate     = turnRate / 6.0;
+    eadi.dotH         = devGS;
+    eadi.dotV         = devLC;
+    eadi.fdRoll       = fd_roll;
+    eadi.fdPitch      = fd_pitch;
+    eadi.altitude     = altitude;
+    eadi.pressure     = press_coef * pressure;
+    eadi.airspeed     = airspeed;
+    eadi.machNo       = machNo;
+    eadi.heading      = heading;
+    eadi.climbRate    = climbRate / 1000.0;
+    eadi.airspeedSel  = sel_ias;
+    eadi.altitudeSel  = sel_alt;
+    eadi.headingSel   = hdg;
+    eadi.vfe          =  85.0;
+    eadi.vne          = 158.0;
+    eadi.fpmVisible   = true;
+    eadi.dotVisibleH  = true;
+    eadi.dotVisibleV  = true;
+    eadi.fdVisible    = true;
+    eadi.stall        = _ui->pushButtonStall->isChecked();
+
+    _ui->widgetEADI->setState( eadi );
 
     // EHSI
-    _ui->widgetEHSI->setHeading    ( heading   );
-    _ui->widgetEHSI->setCourse     ( crs );
-    _ui->widgetEHSI->setBearing    ( adf  , true );
-    _ui->widgetEHSI->setDeviation  ( vor  , cdi );
-    _ui->widgetEHSI->setDistance   ( dme  , true );
-    _ui->widgetEHSI->setHeadingSel ( hdg );
-
-    // Basic Six
-    _ui->widgetSix->getAI()  ->setRoll      ( roll      );
-    _ui->widgetSix->getAI()  ->setPitch     ( pitch     );
-    _ui->widgetSix->getALT() ->setAltitude  ( altitude  );
-    _ui->widgetSix->getALT() ->setPressure  ( pressure  );
-    _ui->widgetSix->getASI() ->setAirspeed  ( airspeed  );
-    _ui->widgetSix->getHI()  ->setHeading   ( heading   );
-    _ui->widgetSix->getTC()  ->setSlipSkid  ( slipSkid * 15.0 );
-    _ui->widgetSix->getTC()  ->setTurnRate  ( turnRate  );
-    _ui->widgetSix->getVSI() ->setClimbRate ( climbRate );
-    _ui->widgetSix->getVOR() ->setCourse    ( crs );
-    _ui->widgetSix->getVOR() ->setDeviation  ( vor  , cdi );
+    qfi_EHSI::State ehsi;
+
+    ehsi.heading         = heading;
+    ehsi.course          = crs;
+    ehsi.bearing         = adf;
+    ehsi.deviation       = vor;
+    ehsi.distance        = dme;
+    ehsi.headingSel      = hdg;
+    ehsi.cdi             = cdi;
+    ehsi.bearingVisible  = true;
+    ehsi.distanceVisible = true;
+
+    _ui->widgetEHSI->setState( ehsi );
+
+    // Basic Six, states are set at once, so they can be recorded
+    qfi_AI::State  ai;
+    qfi_ALT::State alt;
+    qfi_ASI::State asi;
+    qfi_HI::State  hi;
+    qfi_TC::State  tc;
+    qfi_VSI::State vsi;
+    qfi_VOR::State vorState;
+
+    ai.roll            = roll;
+    ai.pitch           = pitch;
+    alt.altitude       = altitude;
+    alt.pressure       = pressure;
+    asi.airspeed       = airspeed;
+    hi.heading         = heading;
+    tc.turnRate        = turnRate;
+    tc.slipSkid        = slipSkid * 15.0;
+    vsi.climbRate      = climbRate;
+    vorState.course    = crs;
+    vorState.deviation = vor;
+    vorState.cdi       = cdi;
+
+    _ui->widgetSix->getAI()  ->setState( ai       );
+    _ui->widgetSix->getALT() ->setState( alt      );
+    _ui->widgetSix->getASI() ->setState( asi      );
+    _ui->widgetSix->getHI()  ->setState( hi       );
+    _ui->widgetSix->getTC()  ->setState( tc       );
+    _ui->widgetSix->getVSI() ->setState( vsi      );
+    _ui->widgetSix->getVOR() ->setState( vorState );
     //_ui->widgetEHSI->setDeviation  ( vor  , cdi );
 
-    // redrawing widgets
+    qfi_Trace::complete( "setters", Q_NULLPTR, settersStart, qfi_Trace::now() - settersStart );
 
-    _ui->widgetEADI->redraw();
-    _ui->widgetEHSI->redraw();
-
-    _ui->widgetSix->getAI()  ->redraw();
-    _ui->widgetSix->getALT() ->redraw();
-    _ui->widgetSix->getASI() ->redraw();
-    _ui->widgetSix->getHI()  ->redraw();
-    _ui->widgetSix->getTC()  ->redraw();
-    _ui->widgetSix->getVSI() ->redraw();
-    _ui->widgetSix->getVOR() ->redraw();
+    // widgets are redrawn by the frame scheduler
 
     // incrementing number of steps
 
     _steps++;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::setPlaying( bool checked )
+{
+    // idle time is not played
+    if ( checked ) _time.restart();
+
+    _scheduler->setContinuous( checked );
+}
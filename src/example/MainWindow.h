@@ -24,8 +24,14 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <QElapsedTimer>
 #include <QMainWindow>
-#include <QTime>
+
+#include <qfi/qfi_FrameScheduler.h>
+#include <qfi/qfi_QualityGovernor.h>
+#include <qfi/qfi_Recorder.h>
+#include <qfi/qfi_Replay.h>
+#include <qfi/qfi_Scenario.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -51,25 +57,55 @@ public:
     /** Destructor. */
     ~MainWindow();
 
-protected:
+    /**
+     * Replays flight log on all instruments instead of the played or manually
+     * set parameters.
+     * @param fileName flight log file name
+     * @param speed replay speed
+     * @param source source id, -1 means 0 if present, otherwise the first one
+     * @return true on success, false otherwise
+     */
+    bool replay( const QString &fileName, double speed = 1.0, qint64 source = -1 );
 
     /**
-     * Timer timeout callback.
-     * This function is called on default timer timeout event.
+     * Records states of all instruments until the window is destroyed.
+     * @param fileName flight log file name
+     * @return true on success, false otherwise
      */
-    void timerEvent( QTimerEvent *event );
-    
+    bool record( const QString &fileName );
+
+    /**
+     * Plays synthetic flight scenario instead of the automatically played
+     * sinusoidal parameters.
+     * @param seed scenario random seed
+     */
+    void playScenario( quint32 seed );
+
 private:
 
     Ui::MainWindow *_ui;    ///< main UI object
 
-    int _timerId;           ///< default timer ID
+    qfi_FrameScheduler *_scheduler; ///< instruments frame scheduler
+    qfi_QualityGovernor *_governor; ///< instruments quality governor
+    qfi_Replay *_replay;            ///< flight log replay
+    qfi_Recorder *_recorder;        ///< instruments state recorder
+    qfi_Scenario *_scenario;        ///< synthetic flight scenario
+
     int _steps;             ///< number of steps
 
     double _realTime;       ///< [s] real time
     double _playTime;       ///< [s] time for automatic parameters updating
 
-    QTime _time;            ///< time
+    QElapsedTimer _time;    ///< time step timer
+
+    /**
+     * Frame callback.
+     * This function is called by the frame scheduler on every frame.
+     */
+    void updateInstruments();
+
+    /** @param checked specifies if parameters are played automatically */
+    void setPlaying( bool checked );
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -60,6 +60,12 @@ public:
     {
         _ai->setPitch( pitch );
     }
+
+    /** */
+    inline void setState( const qfi_AI::State &state )
+    {
+        _ai->setState( state );
+    }
     
 private:
 
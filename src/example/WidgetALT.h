@@ -61,6 +61,12 @@ public:
         _alt->setPressure( pressure );
     }
 
+    /** */
+    inline void setState( const qfi_ALT::State &state )
+    {
+        _alt->setState( state );
+    }
+
 private:
 
     Ui::WidgetALT *_ui;
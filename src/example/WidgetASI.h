@@ -55,6 +55,12 @@ public:
     {
         _asi->setAirspeed( airspeed );
     }
+
+    /** */
+    inline void setState( const qfi_ASI::State &state )
+    {
+        _asi->setState( state );
+    }
     
 private:
 
@@ -196,6 +196,12 @@ public:
         _eadi->setVne( vne );
     }
 
+    /** */
+    inline void setState( const qfi_EADI::State &state )
+    {
+        _eadi->setState( state );
+    }
+
 private:
 
     Ui::WidgetEADI *_ui;
@@ -83,6 +83,11 @@ public:
         _ehsi->setHeadingSel( headingBug );
     }
 
+    inline void setState( const qfi_EHSI::State &state )
+    {
+        _ehsi->setState( state );
+    }
+
 private:
 
     Ui::WidgetEHSI *_ui;
@@ -56,6 +56,12 @@ public:
         _hi->setHeading( heading );
     }
 
+    /** */
+    inline void setState( const qfi_HI::State &state )
+    {
+        _hi->setState( state );
+    }
+
 private:
     
     Ui::WidgetHI  *_ui;
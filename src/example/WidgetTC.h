@@ -61,6 +61,12 @@ public:
         _tc->setSlipSkid( slipSkid );
     }
 
+    /** */
+    inline void setState( const qfi_TC::State &state )
+    {
+        _tc->setState( state );
+    }
+
 private:
 
     Ui::WidgetTC *_ui;
@@ -61,6 +61,12 @@ public:
         _vor->setDeviation( deviation, cdi );
     }
 
+    /** */
+    inline void setState( const qfi_VOR::State &state )
+    {
+        _vor->setState( state );
+    }
+
 private:
 
     Ui::WidgetVOR  *_ui;
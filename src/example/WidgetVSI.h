@@ -56,6 +56,12 @@ public:
         _vsi->setClimbRate( climbRate );
     }
 
+    /** */
+    inline void setState( const qfi_VSI::State &state )
+    {
+        _vsi->setState( state );
+    }
+
 private:
 
     Ui::WidgetVSI *_ui;
@@ -22,8 +22,12 @@
 
 #include <QApplication>
 
+#include <iostream>
+
 #include <example/MainWindow.h>
 
+#include <qfi/qfi_Trace.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 
 int main( int argc, char *argv[] )
@@ -31,9 +35,68 @@ int main( int argc, char *argv[] )
     QLocale::setDefault( QLocale::system() );
 
     QApplication app( argc, argv );
+
+    // -trace <file> records frames timeline in the Chrome trace event format
+    QString traceFile;
+    QStringList args = app.arguments();
+    int traceIndex = args.indexOf( "-trace" );
+
+    if ( traceIndex > 0 && traceIndex + 1 < args.size() )
+    {
+        traceFile = args.at( traceIndex + 1 );
+        qfi_Trace::start();
+    }
+
     MainWindow   win;
 
+    // -replay <file> [-speed <x>] [-source <id>] plays flight log recorded in the qfi_FlightLog format
+    int replayIndex = args.indexOf( "-replay" );
+    int speedIndex  = args.indexOf( "-speed"  );
+    int sourceIndex = args.indexOf( "-source" );
+
+    if ( replayIndex > 0 && replayIndex + 1 < args.size() )
+    {
+        double speed = ( speedIndex > 0 && speedIndex + 1 < args.size() ) ? args.at( speedIndex + 1 ).toDouble() : 1.0;
+        qint64 source = ( sourceIndex > 0 && sourceIndex + 1 < args.size() ) ? args.at( sourceIndex + 1 ).toUInt() : -1;
+
+        if ( !win.replay( args.at( replayIndex + 1 ), speed, source ) )
+        {
+            std::cerr << "Cannot open flight log: " << args.at( replayIndex + 1 ).toLocal8Bit().constData() << std::endl;
+        }
+    }
+
+    // -scenario <seed> plays synthetic flight scenario instead of sinusoidal parameters
+    int scenarioIndex = args.indexOf( "-scenario" );
+
+    if ( scenarioIndex > 0 && scenarioIndex + 1 < args.size() )
+    {
+        win.playScenario( args.at( scenarioIndex + 1 ).toUInt() );
+    }
+
+    // -record <file> records states of all instruments in the qfi_FlightLog format
+    int recordIndex = args.indexOf( "-record" );
+
+    if ( recordIndex > 0 && recordIndex + 1 < args.size() )
+    {
+        if ( !win.record( args.at( recordIndex + 1 ) ) )
+        {
+            std::cerr << "Cannot create flight log: " << args.at( recordIndex + 1 ).toLocal8Bit().constData() << std::endl;
+        }
+    }
+
     win.show();
 
-    return app.exec();
+    int result = app.exec();
+
+    if ( !traceFile.isEmpty() )
+    {
+        qfi_Trace::stop();
+
+        if ( !qfi_Trace::save( traceFile ) )
+        {
+            std::cerr << "Cannot save trace file: " << traceFile.toLocal8Bit().constData() << std::endl;
+        }
+    }
+
+    return result;
 }
@@ -44,4 +44,10 @@ INCLUDEPATH += ./
 
 ################################################################################
 
+# embed minified SVG files, see qfi/qfi.pri
+# CONFIG += qfi_svgmin
+
+# compile in qfi_UdpReceiver (requires Qt network module), see qfi/qfi.pri
+# CONFIG += qfi_network
+
 include($$PWD/qfi/qfi.pri)
@@ -0,0 +1,47 @@
+QT = core
+
+TEMPLATE = app
+
+################################################################################
+
+DESTDIR = $$PWD/../bin
+TARGET = qfi_log2csv
+
+################################################################################
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+################################################################################
+
+win32: CONFIG(release, debug|release): QMAKE_CXXFLAGS += -O2
+unix:  CONFIG(release, debug|release): QMAKE_CXXFLAGS += -O2
+
+#win32: QMAKE_LFLAGS += /INCREMENTAL:NO
+
+################################################################################
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+greaterThan(QT_MAJOR_VERSION, 4):win32: DEFINES += USE_QT5
+
+win32: DEFINES += \
+    NOMINMAX \
+    WIN32 \
+    _WINDOWS \
+    _CRT_SECURE_NO_DEPRECATE \
+    _SCL_SECURE_NO_WARNINGS \
+    _USE_MATH_DEFINES
+
+win32: CONFIG(release, debug|release): DEFINES += NDEBUG
+win32: CONFIG(debug, debug|release):   DEFINES += _DEBUG
+
+unix: DEFINES += _LINUX_
+
+################################################################################
+
+INCLUDEPATH += ./
+
+################################################################################
+
+include($$PWD/log2csv/log2csv.pri)
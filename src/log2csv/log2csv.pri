@@ -0,0 +1,9 @@
+# flight log reader only, the tool does not need the instruments
+
+HEADERS += \
+    $$PWD/../qfi/qfi_defs.h \
+    $$PWD/../qfi/qfi_FlightLog.h
+
+SOURCES += \
+    $$PWD/../qfi/qfi_FlightLog.cpp \
+    $$PWD/main.cpp
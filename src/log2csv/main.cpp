@@ -0,0 +1,193 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+#include <QCoreApplication>
+#include <QStringList>
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include <qfi/qfi_FlightLog.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+void printUsage()
+{
+    cout << "Usage: qfi_log2csv <log> [options]" << endl;
+    cout << "  -o <file>          output CSV file (default: standard output)" << endl;
+    cout << "  -source <id>       source id (default: 0 if present, otherwise the first one)" << endl;
+    cout << "  -list              only lists sources with their samples and columns" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void printSources( const QString &fileName, const QVector< quint32 > &sources )
+{
+    for ( int i = 0; i < sources.size(); i++ )
+    {
+        qfi_FlightLog log;
+
+        if ( !log.open( fileName, sources.at( i ) ) ) continue;
+
+        cout << "source " << sources.at( i ) << ": " << log.samples() << " samples,";
+
+        for ( int c = 0; c < qfi_FlightLog::_columns; c++ )
+        {
+            qfi_FlightLog::Column column = static_cast< qfi_FlightLog::Column >( c );
+
+            if ( log.hasColumn( column ) ) cout << " " << qfi_FlightLog::name( column );
+        }
+
+        cout << endl;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void writeCsv( const qfi_FlightLog &log, ostream &out )
+{
+    QVector< int > columns;
+
+    out << "time";
+
+    for ( int c = 0; c < qfi_FlightLog::_columns; c++ )
+    {
+        qfi_FlightLog::Column column = static_cast< qfi_FlightLog::Column >( c );
+
+        if ( log.hasColumn( column ) )
+        {
+            columns.push_back( c );
+            out << "," << qfi_FlightLog::name( column );
+        }
+    }
+
+    out << "\n";
+
+    // 17 significant digits are enough to restore double values exactly
+    out << setprecision( 17 );
+
+    double values[ qfi_FlightLog::_columns ];
+
+    for ( qint64 i = 0; i < log.samples(); i++ )
+    {
+        const qint64 time = log.time( i );
+
+        log.read( i, values );
+
+        // [s] time with microseconds
+        out << time / 1000000 << "." << setw( 6 ) << setfill( '0' ) << time % 1000000 << setfill( ' ' );
+
+        for ( int c = 0; c < columns.size(); c++ )
+        {
+            out << "," << values[ columns.at( c ) ];
+        }
+
+        out << "\n";
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main( int argc, char *argv[] )
+{
+    QCoreApplication app( argc, argv );
+
+    QString input;
+    QString output;
+
+    qint64 source = -1;
+
+    bool list = false;
+
+    QStringList args = app.arguments();
+
+    for ( int i = 1; i < args.size(); i++ )
+    {
+        const QString &arg = args.at( i );
+
+        bool hasValue = i + 1 < args.size();
+
+        if      ( arg == "-o"      && hasValue ) output = args.at( ++i );
+        else if ( arg == "-source" && hasValue ) source = args.at( ++i ).toUInt();
+        else if ( arg == "-list" ) list = true;
+        else if ( input.isEmpty() && !arg.startsWith( '-' ) ) input = arg;
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if ( input.isEmpty() )
+    {
+        printUsage();
+        return 1;
+    }
+
+    qfi_FlightLog log;
+
+    if ( !log.open( input ) )
+    {
+        cerr << "Cannot open flight log: " << input.toLocal8Bit().constData() << endl;
+        return 1;
+    }
+
+    const QVector< quint32 > sources = log.sources();
+
+    if ( list )
+    {
+        printSources( input, sources );
+        return 0;
+    }
+
+    if ( source < 0 ) source = ( sources.isEmpty() || sources.contains( 0 ) ) ? 0 : sources.first();
+
+    if ( !log.open( input, static_cast< quint32 >( source ) ) )
+    {
+        cerr << "Cannot open flight log: " << input.toLocal8Bit().constData() << endl;
+        return 1;
+    }
+
+    if ( output.isEmpty() )
+    {
+        writeCsv( log, cout );
+    }
+    else
+    {
+        ofstream file( output.toLocal8Bit().constData() );
+
+        if ( !file.is_open() )
+        {
+            cerr << "Cannot open file: " << output.toLocal8Bit().constData() << endl;
+            return 1;
+        }
+
+        writeCsv( log, file );
+    }
+
+    return 0;
+}
@@ -1,3 +1,22 @@
+# CONFIG += qfi_profiling compiles in recording paint times, see qfi_Profiler.h
+
+qfi_profiling: DEFINES += QFI_PROFILING
+
+# CONFIG += qfi_network compiles in qfi_UdpReceiver, it requires the Qt network
+# module, which is not needed otherwise
+
+qfi_network {
+    QT += network
+
+    HEADERS += \
+        $$PWD/qfi_UdpReceiver.h
+
+    SOURCES += \
+        $$PWD/qfi_UdpReceiver.cpp
+}
+
+################################################################################
+
 HEADERS += \
     $$PWD/qfi_defs.h \
     $$PWD/qfi_doxygen.h \
@@ -6,12 +25,59 @@ HEADERS += \
 ################################################################################
 
 HEADERS += \
+    $$PWD/qfi_AtlasSvgItem.h \
+    $$PWD/qfi_Cache.h \
+    $$PWD/qfi_CachedSvgItem.h \
     $$PWD/qfi_Colors.h \
-    $$PWD/qfi_Fonts.h
+    $$PWD/qfi_DirectPainter.h \
+    $$PWD/qfi_Dirty.h \
+    $$PWD/qfi_FlightLog.h \
+    $$PWD/qfi_FlightLogWriter.h \
+    $$PWD/qfi_Fonts.h \
+    $$PWD/qfi_FrameScheduler.h \
+    $$PWD/qfi_GlyphTextItem.h \
+    $$PWD/qfi_Interpolation.h \
+    $$PWD/qfi_Latency.h \
+    $$PWD/qfi_Offscreen.h \
+    $$PWD/qfi_PaintHook.h \
+    $$PWD/qfi_Panel.h \
+    $$PWD/qfi_ParallelRenderer.h \
+    $$PWD/qfi_Profiler.h \
+    $$PWD/qfi_QualityGovernor.h \
+    $$PWD/qfi_Recorder.h \
+    $$PWD/qfi_Renderers.h \
+    $$PWD/qfi_Replay.h \
+    $$PWD/qfi_Scenario.h \
+    $$PWD/qfi_StateHistory.h \
+    $$PWD/qfi_States.h \
+    $$PWD/qfi_Trace.h \
+    $$PWD/qfi_TripleBuffer.h
 
 SOURCES += \
+    $$PWD/qfi_AtlasSvgItem.cpp \
+    $$PWD/qfi_Cache.cpp \
+    $$PWD/qfi_CachedSvgItem.cpp \
     $$PWD/qfi_Colors.cpp \
-    $$PWD/qfi_Fonts.cpp
+    $$PWD/qfi_DirectPainter.cpp \
+    $$PWD/qfi_Dirty.cpp \
+    $$PWD/qfi_FlightLog.cpp \
+    $$PWD/qfi_FlightLogWriter.cpp \
+    $$PWD/qfi_Fonts.cpp \
+    $$PWD/qfi_FrameScheduler.cpp \
+    $$PWD/qfi_GlyphTextItem.cpp \
+    $$PWD/qfi_Latency.cpp \
+    $$PWD/qfi_Offscreen.cpp \
+    $$PWD/qfi_PaintHook.cpp \
+    $$PWD/qfi_Panel.cpp \
+    $$PWD/qfi_ParallelRenderer.cpp \
+    $$PWD/qfi_Profiler.cpp \
+    $$PWD/qfi_QualityGovernor.cpp \
+    $$PWD/qfi_Recorder.cpp \
+    $$PWD/qfi_Renderers.cpp \
+    $$PWD/qfi_Replay.cpp \
+    $$PWD/qfi_Scenario.cpp \
+    $$PWD/qfi_States.cpp \
+    $$PWD/qfi_Trace.cpp
 
 ################################################################################
 # Electronic Flight Instrument System (EFIS)
@@ -53,5 +119,22 @@ SOURCES += \
 # Resources
 ################################################################################
 
-RESOURCES += \
-    $$PWD/qfi.qrc
+# CONFIG += qfi_svgmin embeds minified copies of the SVG files (editor
+# metadata, unused defs and ids stripped), it requires Python 3; qmake has to
+# be re-run after modifying the images
+
+isEmpty(QFI_PYTHON): QFI_PYTHON = python3
+
+qfi_svgmin {
+    QFI_SVGMIN_DIR = $$OUT_PWD/qfi_svgmin
+
+    !system($$QFI_PYTHON $$shell_quote($$PWD/qfi_svgmin.py) $$shell_quote($$PWD/qfi.qrc) $$shell_quote($$QFI_SVGMIN_DIR)) {
+        error("qfi_svgmin: minifying SVG files failed")
+    }
+
+    RESOURCES += \
+        $$QFI_SVGMIN_DIR/qfi.qrc
+} else {
+    RESOURCES += \
+        $$PWD/qfi.qrc
+}
@@ -28,13 +28,26 @@
 
 #include <cmath>
 
+#include <qfi/qfi_Cache.h>
+#include <qfi/qfi_CachedSvgItem.h>
+#include <qfi/qfi_Interpolation.h>
+#include <qfi/qfi_Latency.h>
+#include <qfi/qfi_Offscreen.h>
+#include <qfi/qfi_Profiler.h>
+#include <qfi/qfi_Renderers.h>
+#include <qfi/qfi_Trace.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 
-qfi_AI::qfi_AI( QWidget *parent ) :
+qfi_AI::qfi_AI( QWidget *parent, RenderBackend backend ) :
     QGraphicsView ( parent ),
 
     _scene ( Q_NULLPTR ),
 
+    _resizeTimer ( Q_NULLPTR ),
+
+    _backend ( backend ),
+
     _itemBack ( Q_NULLPTR ),
     _itemFace ( Q_NULLPTR ),
     _itemRing ( Q_NULLPTR ),
@@ -43,10 +56,12 @@ qfi_AI::qfi_AI( QWidget *parent ) :
     _roll  ( 0.0 ),
     _pitch ( 0.0 ),
 
-    _faceDeltaX_new ( 0.0 ),
-    _faceDeltaX_old ( 0.0 ),
-    _faceDeltaY_new ( 0.0 ),
-    _faceDeltaY_old ( 0.0 ),
+    _roll_old  ( 0.0 ),
+    _pitch_old ( 0.0 ),
+
+    _dirty ( true ),
+
+    _suppressedRedraws ( 0 ),
 
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
@@ -54,6 +69,8 @@ qfi_AI::qfi_AI( QWidget *parent ) :
     _originalHeight ( 240 ),
     _originalWidth  ( 240 ),
 
+    _originalRingRadius ( 94.0 ),
+
     _originalPixPerDeg ( 1.7 ),
 
     _originalAdiCtr ( 120.0 , 120.0 ),
@@ -66,7 +83,14 @@ qfi_AI::qfi_AI( QWidget *parent ) :
     reset();
 
     _scene = new QGraphicsScene( this );
-    setScene( _scene );
+
+    // painter backend draws items itself, the view has no scene
+    if ( _backend == RenderBackend::Scene ) setScene( _scene );
+
+    _resizeTimer = new QTimer( this );
+    _resizeTimer->setSingleShot( true );
+    _resizeTimer->setInterval( 200 );
+    connect( _resizeTimer, &QTimer::timeout, this, &qfi_AI::reinit );
 
     _scene->clear();
 
@@ -93,7 +117,12 @@ void qfi_AI::reinit()
 {
     if ( _scene )
     {
+        _resizeTimer->stop();
+
+        resetTransform();
+
         _scene->clear();
+        _direct.clear();
 
         init();
     }
@@ -104,32 +133,105 @@ void qfi_AI::reinit()
 void qfi_AI::redraw()
 {
     if ( isVisible() )
+    {
+        State state;
+
+        if ( _stateBuffer.consume( &state ) ) setState( state );
+
+        if ( _dirty )
+        {
+            updateView();
+        }
+        else
+        {
+            _suppressedRedraws++;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_AI::renderImage( QImage &image )
+{
+    QSize size = qfi_Offscreen::size( image );
+
+    if ( size.isEmpty() ) return;
+
+    State state;
+
+    if ( _stateBuffer.consume( &state ) ) setState( state );
+
+    if ( !isVisible() && size != this->size() )
+    {
+        resize( size );
+        reinit();
+    }
+
+    if ( _dirty )
     {
         updateView();
+    }
 
-        _faceDeltaX_old  = _faceDeltaX_new;
-        _faceDeltaY_old  = _faceDeltaY_new;
+    QRectF source( 0.0, 0.0, _scaleX * _originalWidth, _scaleY * _originalHeight );
+
+    if ( _backend == RenderBackend::Painter )
+    {
+        qfi_Offscreen::render( _direct, source, image, renderHints() );
     }
+    else
+    {
+        qfi_Offscreen::render( _scene, source, image, renderHints() );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_AI::setState( const State &state )
+{
+    if ( _stateHook ) _stateHook( state );
+
+    setRoll( state.roll );
+    setPitch( state.pitch );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_AI::State::interpolate( const State &s0, const State &s1, double ratio, State *result )
+{
+    result->roll  = qfi_Interpolation::roll  ( s0.roll, s1.roll, ratio );
+    result->pitch = qfi_Interpolation::linear( s0.pitch, s1.pitch, ratio );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_AI::setRoll( double roll )
 {
+    if ( roll < -180.0 ) roll = -180.0;
+    if ( roll >  180.0 ) roll =  180.0;
+
+    double pxPerDeg = qfi_Dirty::pxPerDeg( _originalRingRadius * qMin( _scaleX, _scaleY ) );
+
     _roll = roll;
 
-    if ( _roll < -180.0 ) _roll = -180.0;
-    if ( _roll >  180.0 ) _roll =  180.0;
+    if ( qfi_Dirty::isChanged( _roll, _roll_old, pxPerDeg ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_AI::setPitch( double pitch )
 {
+    if ( pitch < -25.0 ) pitch = -25.0;
+    if ( pitch >  25.0 ) pitch =  25.0;
+
     _pitch = pitch;
 
-    if ( _pitch < -25.0 ) _pitch = -25.0;
-    if ( _pitch >  25.0 ) _pitch =  25.0;
+    if ( qfi_Dirty::isChanged( _pitch, _pitch_old, _originalPixPerDeg * _scaleY ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -140,7 +242,55 @@ void qfi_AI::resizeEvent( QResizeEvent *event )
     QGraphicsView::resizeEvent( event );
     ////////////////////////////////////
 
-    reinit();
+    if ( isVisible() && _itemCase )
+    {
+        rescale();
+    }
+    else
+    {
+        reinit();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_AI::paintEvent( QPaintEvent *event )
+{
+    if ( _backend == RenderBackend::Scene )
+    {
+        QGraphicsView::paintEvent( event );
+        return;
+    }
+
+    QPainter painter( viewport() );
+    painter.setRenderHints( renderHints() );
+
+    // the same area the scene view shows, centered in the viewport
+    QRectF target( 0.5 * ( viewport()->width()  - width()  ),
+                   0.5 * ( viewport()->height() - height() ),
+                   width(), height() );
+
+    _direct.render( &painter, target,
+                    QRectF( 0.0, 0.0, _scaleX * _originalWidth, _scaleY * _originalHeight ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_AI::rescale()
+{
+    // items and their state are kept, the scene is rebuilt at the new scale
+    // once the size settles
+    setTransform( QTransform::fromScale( width()  / ( _scaleX * _originalWidth  ),
+                                         height() / ( _scaleY * _originalHeight ) ) );
+
+    centerOn( _scaleX * _originalWidth / 2.0 , _scaleY * _originalHeight / 2.0 );
+
+    // changes too small to be visible at the previous size may be visible now
+    _dirty = true;
+
+    qfi_Cache::deferRebuilds( _resizeTimer->interval() );
+
+    _resizeTimer->start();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -152,32 +302,32 @@ void qfi_AI::init()
 
     reset();
 
-    _itemBack = new QGraphicsSvgItem( ":/qfi/images/ai/ai_back.svg" );
+    _itemBack = qfi_Renderers::createItem( ":/qfi/images/ai/ai_back.svg" );
     _itemBack->setCacheMode( QGraphicsItem::NoCache );
     _itemBack->setZValue( _backZ );
     _itemBack->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemBack->setTransformOriginPoint( _originalAdiCtr );
-    _scene->addItem( _itemBack );
+    addItem( _itemBack );
 
-    _itemFace = new QGraphicsSvgItem( ":/qfi/images/ai/ai_face.svg" );
+    _itemFace = qfi_Renderers::createItem( ":/qfi/images/ai/ai_face.svg" );
     _itemFace->setCacheMode( QGraphicsItem::NoCache );
     _itemFace->setZValue( _faceZ );
     _itemFace->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemFace->setTransformOriginPoint( _originalAdiCtr );
-    _scene->addItem( _itemFace );
+    addItem( _itemFace );
 
-    _itemRing = new QGraphicsSvgItem( ":/qfi/images/ai/ai_ring.svg" );
+    _itemRing = qfi_Renderers::createItem( ":/qfi/images/ai/ai_ring.svg" );
     _itemRing->setCacheMode( QGraphicsItem::NoCache );
     _itemRing->setZValue( _ringZ );
     _itemRing->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemRing->setTransformOriginPoint( _originalAdiCtr );
-    _scene->addItem( _itemRing );
+    addItem( _itemRing );
 
-    _itemCase = new QGraphicsSvgItem( ":/qfi/images/ai/ai_case.svg" );
+    _itemCase = new qfi_CachedSvgItem( ":/qfi/images/ai/ai_case.svg" );
     _itemCase->setCacheMode( QGraphicsItem::NoCache );
     _itemCase->setZValue( _caseZ );
     _itemCase->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
-    _scene->addItem( _itemCase );
+    addItem( _itemCase );
 
     centerOn( width() / 2.0 , height() / 2.0 );
 
@@ -186,6 +336,20 @@ void qfi_AI::init()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void qfi_AI::addItem( QGraphicsItem *item )
+{
+    if ( _backend == RenderBackend::Painter )
+    {
+        _direct.addItem( item );
+    }
+    else
+    {
+        _scene->addItem( item );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void qfi_AI::reset()
 {
     _itemBack = Q_NULLPTR;
@@ -193,21 +357,16 @@ void qfi_AI::reset()
     _itemRing = Q_NULLPTR;
     _itemCase = Q_NULLPTR;
 
-    _roll  = 0.0;
-    _pitch = 0.0;
-
-    _faceDeltaX_new = 0.0;
-    _faceDeltaX_old = 0.0;
-    _faceDeltaY_new = 0.0;
-    _faceDeltaY_old = 0.0;
+    _dirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_AI::updateView()
 {
-    _scaleX = static_cast< double >( width()  ) / static_cast< double >( _originalWidth  );
-    _scaleY = static_cast< double >( height() ) / static_cast< double >( _originalHeight );
+    QFI_PROFILE( "qfi_AI::updateView" );
+    QFI_TRACE( "updateView", "qfi_AI" );
+    qfi_Latency::updated( this );
 
     _itemBack->setRotation( - _roll );
     _itemFace->setRotation( - _roll );
@@ -217,10 +376,21 @@ void qfi_AI::updateView()
 
     double delta  = _originalPixPerDeg * _pitch;
 
-    _faceDeltaX_new = _scaleX * delta * sin( roll_rad );
-    _faceDeltaY_new = _scaleY * delta * cos( roll_rad );
+    // absolute position computed from the state, face is created at origin
+    _itemFace->setPos( _scaleX * delta * sin( roll_rad ),
+                       _scaleY * delta * cos( roll_rad ) );
 
-    _itemFace->moveBy( _faceDeltaX_new - _faceDeltaX_old, _faceDeltaY_new - _faceDeltaY_old );
+    _roll_old  = _roll;
+    _pitch_old = _pitch;
 
-    _scene->update();
+    _dirty = false;
+
+    if ( _backend == RenderBackend::Painter )
+    {
+        viewport()->update();
+    }
+    else
+    {
+        _scene->update();
+    }
 }
@@ -28,6 +28,15 @@
 
 #include <cmath>
 
+#include <qfi/qfi_Cache.h>
+#include <qfi/qfi_CachedSvgItem.h>
+#include <qfi/qfi_Interpolation.h>
+#include <qfi/qfi_Latency.h>
+#include <qfi/qfi_Offscreen.h>
+#include <qfi/qfi_Profiler.h>
+#include <qfi/qfi_Renderers.h>
+#include <qfi/qfi_Trace.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 
 qfi_ALT::qfi_ALT( QWidget *parent ) :
@@ -35,6 +44,8 @@ qfi_ALT::qfi_ALT( QWidget *parent ) :
 
     _scene ( Q_NULLPTR ),
 
+    _resizeTimer ( Q_NULLPTR ),
+
     _itemFace_1 ( Q_NULLPTR ),
     _itemFace_2 ( Q_NULLPTR ),
     _itemFace_3 ( Q_NULLPTR ),
@@ -45,12 +56,23 @@ qfi_ALT::qfi_ALT( QWidget *parent ) :
     _altitude (  0.0 ),
     _pressure ( 28.0 ),
 
+    _altitude_old (  0.0 ),
+    _pressure_old ( 28.0 ),
+
+    _dirty ( true ),
+
+    _suppressedRedraws ( 0 ),
+
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
 
+    _atlasStep ( 0.0 ),
+
     _originalHeight ( 240 ),
     _originalWidth  ( 240 ),
 
+    _originalHandRadius ( 86.0 ),
+
     _originalAltCtr ( 120.0 , 120.0 ),
 
     _face1Z ( -50 ),
@@ -65,6 +87,11 @@ qfi_ALT::qfi_ALT( QWidget *parent ) :
     _scene = new QGraphicsScene( this );
     setScene( _scene );
 
+    _resizeTimer = new QTimer( this );
+    _resizeTimer->setSingleShot( true );
+    _resizeTimer->setInterval( 200 );
+    connect( _resizeTimer, &QTimer::timeout, this, &qfi_ALT::reinit );
+
     _scene->clear();
 
     init();
@@ -90,6 +117,10 @@ void qfi_ALT::reinit()
 {
     if ( _scene )
     {
+        _resizeTimer->stop();
+
+        resetTransform();
+
         _scene->clear();
 
         init();
@@ -101,26 +132,123 @@ void qfi_ALT::reinit()
 void qfi_ALT::redraw()
 {
     if ( isVisible() )
+    {
+        State state;
+
+        if ( _stateBuffer.consume( &state ) ) setState( state );
+
+        if ( _dirty )
+        {
+            updateView();
+        }
+        else
+        {
+            _suppressedRedraws++;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ALT::renderImage( QImage &image )
+{
+    QSize size = qfi_Offscreen::size( image );
+
+    if ( size.isEmpty() ) return;
+
+    State state;
+
+    if ( _stateBuffer.consume( &state ) ) setState( state );
+
+    if ( !isVisible() && size != this->size() )
+    {
+        resize( size );
+        reinit();
+    }
+
+    if ( _dirty )
     {
         updateView();
     }
+
+    qfi_Offscreen::render( _scene,
+                           QRectF( 0.0, 0.0, _scaleX * _originalWidth, _scaleY * _originalHeight ),
+                           image, renderHints() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ALT::setState( const State &state )
+{
+    if ( _stateHook ) _stateHook( state );
+
+    setAltitude( state.altitude );
+    setPressure( state.pressure );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ALT::State::interpolate( const State &s0, const State &s1, double ratio, State *result )
+{
+    result->altitude = qfi_Interpolation::linear( s0.altitude, s1.altitude, ratio );
+    result->pressure = qfi_Interpolation::linear( s0.pressure, s1.pressure, ratio );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_ALT::setAltitude( double altitude )
 {
+    // 100 ft hand is the fastest one: 0.36 deg per ft
+    double pxPerFt = 0.36 * qfi_Dirty::pxPerDeg( _originalHandRadius * qMin( _scaleX, _scaleY ) );
+
     _altitude = altitude;
+
+    if ( qfi_Dirty::isChanged( _altitude, _altitude_old, pxPerFt ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_ALT::setPressure( double pressure )
 {
+    if ( pressure < 28.0 ) pressure = 28.0;
+    if ( pressure > 31.5 ) pressure = 31.5;
+
+    // pressure scale: 100 deg per inHg
+    double pxPerInHg = 100.0 * qfi_Dirty::pxPerDeg( _originalHandRadius * qMin( _scaleX, _scaleY ) );
+
     _pressure = pressure;
 
-    if ( _pressure < 28.0 ) _pressure = 28.0;
-    if ( _pressure > 31.5 ) _pressure = 31.5;
+    if ( qfi_Dirty::isChanged( _pressure, _pressure_old, pxPerInHg ) )
+    {
+        _dirty = true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ALT::setAtlasStep( double step )
+{
+    _atlasStep = step;
+
+    if ( _itemFace_3 ) _itemFace_3->setAngleStep( _atlasStep );
+    if ( _itemHand_1 ) _itemHand_1->setAngleStep( _atlasStep );
+    if ( _itemHand_2 ) _itemHand_2->setAngleStep( _atlasStep );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_ALT::atlasBytes() const
+{
+    qint64 bytes = 0;
+
+    if ( _itemFace_3 ) bytes += _itemFace_3->atlasBytes();
+    if ( _itemHand_1 ) bytes += _itemHand_1->atlasBytes();
+    if ( _itemHand_2 ) bytes += _itemHand_2->atlasBytes();
+
+    return bytes;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -131,7 +259,33 @@ void qfi_ALT::resizeEvent( QResizeEvent *event )
     QGraphicsView::resizeEvent( event );
     ////////////////////////////////////
 
-    reinit();
+    if ( isVisible() && _itemCase )
+    {
+        rescale();
+    }
+    else
+    {
+        reinit();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ALT::rescale()
+{
+    // items and their state are kept, the scene is rebuilt at the new scale
+    // once the size settles
+    setTransform( QTransform::fromScale( width()  / ( _scaleX * _originalWidth  ),
+                                         height() / ( _scaleY * _originalHeight ) ) );
+
+    centerOn( _scaleX * _originalWidth / 2.0 , _scaleY * _originalHeight / 2.0 );
+
+    // changes too small to be visible at the previous size may be visible now
+    _dirty = true;
+
+    qfi_Cache::deferRebuilds( _resizeTimer->interval() );
+
+    _resizeTimer->start();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -143,41 +297,44 @@ void qfi_ALT::init()
 
     reset();
 
-    _itemFace_1 = new QGraphicsSvgItem( ":/qfi/images/alt/alt_face_1.svg" );
+    _itemFace_1 = qfi_Renderers::createItem( ":/qfi/images/alt/alt_face_1.svg" );
     _itemFace_1->setCacheMode( QGraphicsItem::NoCache );
     _itemFace_1->setZValue( _face1Z );
     _itemFace_1->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemFace_1->setTransformOriginPoint( _originalAltCtr );
     _scene->addItem( _itemFace_1 );
 
-    _itemFace_2 = new QGraphicsSvgItem( ":/qfi/images/alt/alt_face_2.svg" );
+    _itemFace_2 = new qfi_CachedSvgItem( ":/qfi/images/alt/alt_face_2.svg" );
     _itemFace_2->setCacheMode( QGraphicsItem::NoCache );
     _itemFace_2->setZValue( _face2Z );
     _itemFace_2->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _scene->addItem( _itemFace_2 );
 
-    _itemFace_3 = new QGraphicsSvgItem( ":/qfi/images/alt/alt_face_3.svg" );
+    _itemFace_3 = new qfi_AtlasSvgItem( ":/qfi/images/alt/alt_face_3.svg" );
     _itemFace_3->setCacheMode( QGraphicsItem::NoCache );
     _itemFace_3->setZValue( _face3Z );
     _itemFace_3->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
+    _itemFace_3->setAngleStep( _atlasStep );
     _itemFace_3->setTransformOriginPoint( _originalAltCtr );
     _scene->addItem( _itemFace_3 );
 
-    _itemHand_1 = new QGraphicsSvgItem( ":/qfi/images/alt/alt_hand_1.svg" );
+    _itemHand_1 = new qfi_AtlasSvgItem( ":/qfi/images/alt/alt_hand_1.svg" );
     _itemHand_1->setCacheMode( QGraphicsItem::NoCache );
     _itemHand_1->setZValue( _hand1Z );
     _itemHand_1->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
+    _itemHand_1->setAngleStep( _atlasStep );
     _itemHand_1->setTransformOriginPoint( _originalAltCtr );
     _scene->addItem( _itemHand_1 );
 
-    _itemHand_2 = new QGraphicsSvgItem( ":/qfi/images/alt/alt_hand_2.svg" );
+    _itemHand_2 = new qfi_AtlasSvgItem( ":/qfi/images/alt/alt_hand_2.svg" );
     _itemHand_2->setCacheMode( QGraphicsItem::NoCache );
     _itemHand_2->setZValue( _hand2Z );
     _itemHand_2->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
+    _itemHand_2->setAngleStep( _atlasStep );
     _itemHand_2->setTransformOriginPoint( _originalAltCtr );
     _scene->addItem( _itemHand_2 );
 
-    _itemCase = new QGraphicsSvgItem( ":/qfi/images/alt/alt_case.svg" );
+    _itemCase = new qfi_CachedSvgItem( ":/qfi/images/alt/alt_case.svg" );
     _itemCase->setCacheMode( QGraphicsItem::NoCache );
     _itemCase->setZValue( _caseZ );
     _itemCase->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -199,14 +356,17 @@ void qfi_ALT::reset()
     _itemHand_2 = Q_NULLPTR;
     _itemCase   = Q_NULLPTR;
 
-    _altitude =  0.0;
-    _pressure = 28.0;
+    _dirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_ALT::updateView()
 {
+    QFI_PROFILE( "qfi_ALT::updateView" );
+    QFI_TRACE( "updateView", "qfi_ALT" );
+    qfi_Latency::updated( this );
+
     int altitude = ceil( _altitude + 0.5 );
 
     double angleH1 = _altitude * 0.036;
@@ -219,5 +379,10 @@ void qfi_ALT::updateView()
     _itemFace_1->setRotation( - angleF1 );
     _itemFace_3->setRotation(   angleF3 );
 
+    _altitude_old = _altitude;
+    _pressure_old = _pressure;
+
+    _dirty = false;
+
     _scene->update();
 }
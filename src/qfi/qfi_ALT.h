@@ -26,8 +26,15 @@
 
 #include <QGraphicsView>
 #include <QGraphicsSvgItem>
+#include <QImage>
+#include <QTimer>
 
+#include <functional>
+
+#include <qfi/qfi_AtlasSvgItem.h>
 #include <qfi/qfi_defs.h>
+#include <qfi/qfi_Dirty.h>
+#include <qfi/qfi_TripleBuffer.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -40,6 +47,26 @@ class QFIAPI qfi_ALT : public QGraphicsView
 
 public:
 
+    /**
+     * Instrument state, applied at once with setState(). Plain data
+     * structure, it can be copied between threads with memcpy().
+     */
+    struct State
+    {
+        double altitude;    ///< [ft] altitude
+        double pressure;    ///< [inHg] pressure
+
+        /**
+         * Interpolates (ratio from 0.0 to 1.0) or extrapolates (ratio greater
+         * than 1.0) between states, see qfi_StateHistory.
+         * @param s0 first state
+         * @param s1 second state
+         * @param ratio interpolation ratio
+         * @param result output state
+         */
+        static void interpolate( const State &s0, const State &s1, double ratio, State *result );
+    };
+
     /** Constructor. */
     explicit qfi_ALT( QWidget *parent = Q_NULLPTR );
 
@@ -52,12 +79,56 @@ public:
     /** Refreshes (redraws) widget. */
     void redraw();
 
+    /**
+     * Renders widget into the image, also when the widget is not shown
+     * (e.g. with the offscreen platform plugin). Hidden widget is resized
+     * to the image size, image itself is never reallocated.
+     * @param image target image
+     */
+    void renderImage( QImage &image );
+
     /** @param altitude [ft] */
     void setAltitude( double altitude );
 
     /** @param pressure [inHg] */
     void setPressure( double aressure );
 
+    /**
+     * Enables drawing of the needles and the inner card from pre-rotated frames.
+     * @param step [deg] frames angle step, 0 disables (default)
+     */
+    void setAtlasStep( double step );
+
+    /** @return [deg] frames angle step */
+    inline double atlasStep() const { return _atlasStep; }
+
+    /** @return [B] memory occupied by the pre-rotated frames */
+    qint64 atlasBytes() const;
+
+    /**
+     * Applies all values of the state at once, only the visibly changed ones
+     * mark the instrument dirty.
+     * @param state instrument state
+     */
+    void setState( const State &state );
+
+    /**
+     * Other threads (e.g. simulation) may publish state into this buffer
+     * without blocking, the newest state is applied on redraw.
+     * @return state buffer
+     */
+    inline qfi_TripleBuffer< State >& stateBuffer() { return _stateBuffer; }
+
+    /**
+     * Sets function called with every state passed to setState(), also with
+     * states taken from stateBuffer(), e.g. by qfi_Recorder.
+     * @param hook state hook, empty function removes hook
+     */
+    inline void setStateHook( const std::function< void( const State& ) > &hook ) { _stateHook = hook; }
+
+    /** @return number of redraws skipped because nothing has changed */
+    inline qint64 suppressedRedraws() const { return _suppressedRedraws; }
+
 protected:
 
     /** */
@@ -66,23 +137,39 @@ protected:
 private:
 
     QGraphicsScene *_scene;
+    QTimer *_resizeTimer;   ///< debounces rebuilding the scene after resizing
 
     QGraphicsSvgItem *_itemFace_1;
     QGraphicsSvgItem *_itemFace_2;
-    QGraphicsSvgItem *_itemFace_3;
-    QGraphicsSvgItem *_itemHand_1;
-    QGraphicsSvgItem *_itemHand_2;
+    qfi_AtlasSvgItem *_itemFace_3;
+    qfi_AtlasSvgItem *_itemHand_1;
+    qfi_AtlasSvgItem *_itemHand_2;
     QGraphicsSvgItem *_itemCase;
 
     double _altitude;
     double _pressure;
 
+    double _altitude_old;   ///< [ft] altitude currently drawn
+    double _pressure_old;   ///< [inHg] pressure currently drawn
+
+    bool _dirty;
+
+    qint64 _suppressedRedraws;
+
+    qfi_TripleBuffer< State > _stateBuffer;
+
+    std::function< void( const State& ) > _stateHook;
+
     double _scaleX;
     double _scaleY;
 
+    double _atlasStep;
+
     const int _originalHeight;
     const int _originalWidth;
 
+    const double _originalHandRadius;
+
     QPointF _originalAltCtr;
 
     const int _face1Z;
@@ -96,6 +183,9 @@ private:
 
     void reset();
 
+    /** Scales the view to the current size until the scene is rebuilt. */
+    void rescale();
+
     void updateView();
 };
 
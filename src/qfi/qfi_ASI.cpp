@@ -28,6 +28,14 @@
 
 #include <cmath>
 
+#include <qfi/qfi_Cache.h>
+#include <qfi/qfi_CachedSvgItem.h>
+#include <qfi/qfi_Interpolation.h>
+#include <qfi/qfi_Latency.h>
+#include <qfi/qfi_Offscreen.h>
+#include <qfi/qfi_Profiler.h>
+#include <qfi/qfi_Trace.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 
 qfi_ASI::qfi_ASI( QWidget *parent ) :
@@ -35,18 +43,30 @@ qfi_ASI::qfi_ASI( QWidget *parent ) :
 
     _scene ( Q_NULLPTR ),
 
+    _resizeTimer ( Q_NULLPTR ),
+
     _itemFace ( Q_NULLPTR ),
     _itemHand ( Q_NULLPTR ),
     _itemCase ( Q_NULLPTR ),
 
     _airspeed ( 0.0 ),
 
+    _airspeed_old ( 0.0 ),
+
+    _dirty ( true ),
+
+    _suppressedRedraws ( 0 ),
+
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
 
+    _atlasStep ( 0.0 ),
+
     _originalHeight ( 240 ),
     _originalWidth  ( 240 ),
 
+    _originalHandRadius ( 86.0 ),
+
     _originalAsiCtr ( 120.0 , 120.0 ),
 
     _faceZ ( -20 ),
@@ -58,6 +78,11 @@ qfi_ASI::qfi_ASI( QWidget *parent ) :
     _scene = new QGraphicsScene( this );
     setScene( _scene );
 
+    _resizeTimer = new QTimer( this );
+    _resizeTimer->setSingleShot( true );
+    _resizeTimer->setInterval( 200 );
+    connect( _resizeTimer, &QTimer::timeout, this, &qfi_ASI::reinit );
+
     _scene->clear();
 
     init();
@@ -83,6 +108,10 @@ void qfi_ASI::reinit()
 {
     if ( _scene )
     {
+        _resizeTimer->stop();
+
+        resetTransform();
+
         _scene->clear();
 
         init();
@@ -94,19 +123,102 @@ void qfi_ASI::reinit()
 void qfi_ASI::redraw()
 {
     if ( isVisible() )
+    {
+        State state;
+
+        if ( _stateBuffer.consume( &state ) ) setState( state );
+
+        if ( _dirty )
+        {
+            updateView();
+        }
+        else
+        {
+            _suppressedRedraws++;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ASI::renderImage( QImage &image )
+{
+    QSize size = qfi_Offscreen::size( image );
+
+    if ( size.isEmpty() ) return;
+
+    State state;
+
+    if ( _stateBuffer.consume( &state ) ) setState( state );
+
+    if ( !isVisible() && size != this->size() )
+    {
+        resize( size );
+        reinit();
+    }
+
+    if ( _dirty )
     {
         updateView();
     }
+
+    qfi_Offscreen::render( _scene,
+                           QRectF( 0.0, 0.0, _scaleX * _originalWidth, _scaleY * _originalHeight ),
+                           image, renderHints() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ASI::setState( const State &state )
+{
+    if ( _stateHook ) _stateHook( state );
+
+    setAirspeed( state.airspeed );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ASI::State::interpolate( const State &s0, const State &s1, double ratio, State *result )
+{
+    result->airspeed = qfi_Interpolation::linear( s0.airspeed, s1.airspeed, ratio );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_ASI::setAirspeed( double airspeed )
 {
+    if ( airspeed <   0.0 ) airspeed =   0.0;
+    if ( airspeed > 235.0 ) airspeed = 235.0;
+
+    // steepest part of the scale: 2 deg per kt
+    double pxPerKt = 2.0 * qfi_Dirty::pxPerDeg( _originalHandRadius * qMin( _scaleX, _scaleY ) );
+
     _airspeed = airspeed;
 
-    if ( _airspeed <   0.0 ) _airspeed =   0.0;
-    if ( _airspeed > 235.0 ) _airspeed = 235.0;
+    if ( qfi_Dirty::isChanged( _airspeed, _airspeed_old, pxPerKt ) )
+    {
+        _dirty = true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ASI::setAtlasStep( double step )
+{
+    _atlasStep = step;
+
+    if ( _itemHand ) _itemHand->setAngleStep( _atlasStep );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_ASI::atlasBytes() const
+{
+    qint64 bytes = 0;
+
+    if ( _itemHand ) bytes += _itemHand->atlasBytes();
+
+    return bytes;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -117,7 +229,33 @@ void qfi_ASI::resizeEvent( QResizeEvent *event )
     QGraphicsView::resizeEvent( event );
     ////////////////////////////////////
 
-    reinit();
+    if ( isVisible() && _itemCase )
+    {
+        rescale();
+    }
+    else
+    {
+        reinit();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ASI::rescale()
+{
+    // items and their state are kept, the scene is rebuilt at the new scale
+    // once the size settles
+    setTransform( QTransform::fromScale( width()  / ( _scaleX * _originalWidth  ),
+                                         height() / ( _scaleY * _originalHeight ) ) );
+
+    centerOn( _scaleX * _originalWidth / 2.0 , _scaleY * _originalHeight / 2.0 );
+
+    // changes too small to be visible at the previous size may be visible now
+    _dirty = true;
+
+    qfi_Cache::deferRebuilds( _resizeTimer->interval() );
+
+    _resizeTimer->start();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -129,20 +267,21 @@ void qfi_ASI::init()
 
     reset();
 
-    _itemFace = new QGraphicsSvgItem( ":/qfi/images/asi/asi_face.svg" );
+    _itemFace = new qfi_CachedSvgItem( ":/qfi/images/asi/asi_face.svg" );
     _itemFace->setCacheMode( QGraphicsItem::NoCache );
     _itemFace->setZValue( _faceZ );
     _itemFace->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _scene->addItem( _itemFace );
 
-    _itemHand = new QGraphicsSvgItem( ":/qfi/images/asi/asi_hand.svg" );
+    _itemHand = new qfi_AtlasSvgItem( ":/qfi/images/asi/asi_hand.svg" );
     _itemHand->setCacheMode( QGraphicsItem::NoCache );
     _itemHand->setZValue( _handZ );
     _itemHand->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
+    _itemHand->setAngleStep( _atlasStep );
     _itemHand->setTransformOriginPoint( _originalAsiCtr );
     _scene->addItem( _itemHand );
 
-    _itemCase = new QGraphicsSvgItem( ":/qfi/images/asi/asi_case.svg" );
+    _itemCase = new qfi_CachedSvgItem( ":/qfi/images/asi/asi_case.svg" );
     _itemCase->setCacheMode( QGraphicsItem::NoCache );
     _itemCase->setZValue( _caseZ );
     _itemCase->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -161,13 +300,17 @@ void qfi_ASI::reset()
     _itemHand = Q_NULLPTR;
     _itemCase = Q_NULLPTR;
 
-    _airspeed = 0.0;
+    _dirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_ASI::updateView()
 {
+    QFI_PROFILE( "qfi_ASI::updateView" );
+    QFI_TRACE( "updateView", "qfi_ASI" );
+    qfi_Latency::updated( this );
+
     double angle = 0.0;
 
     if ( _airspeed < 40.0 )
@@ -193,5 +336,9 @@ void qfi_ASI::updateView()
 
     _itemHand->setRotation( angle );
 
+    _airspeed_old = _airspeed;
+
+    _dirty = false;
+
     _scene->update();
 }
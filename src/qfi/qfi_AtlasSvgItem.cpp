@@ -0,0 +1,260 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+#include <qfi/qfi_AtlasSvgItem.h>
+
+#include <QImage>
+#include <QPainter>
+#include <QPaintDevice>
+#include <QSvgRenderer>
+
+#include <cmath>
+
+#include <qfi/qfi_Cache.h>
+#include <qfi/qfi_Profiler.h>
+#include <qfi/qfi_Renderers.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+QAtomicInteger< qint64 > qfi_AtlasSvgItem::_totalBytes( 0 );
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_AtlasSvgItem::totalBytes()
+{
+    return _totalBytes.fetchAndAddRelaxed( 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_AtlasSvgItem::qfi_AtlasSvgItem( const QString &fileName,
+                                    QGraphicsItem *parent ) :
+    QGraphicsSvgItem ( parent ),
+
+    _angleStep ( 0.0 ),
+
+    _frameDpr ( 0.0 ),
+
+    _bytes ( 0 ),
+
+    _profileId ( -1 )
+{
+    setSharedRenderer( qfi_Renderers::get( fileName, this ) );
+
+#   ifdef QFI_PROFILING
+    _profileId = qfi_Profiler::id( fileName );
+#   endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_AtlasSvgItem::~qfi_AtlasSvgItem()
+{
+    clearFrames();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_AtlasSvgItem::setAngleStep( double angleStep )
+{
+    if ( angleStep < 0.0 ) angleStep = 0.0;
+
+    if ( angleStep != _angleStep )
+    {
+        clearFrames();
+        _angleStep = angleStep;
+        update();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_AtlasSvgItem::paint( QPainter *painter,
+                              const QStyleOptionGraphicsItem *option,
+                              QWidget *widget )
+{
+    QFI_PROFILE_ID( _profileId );
+
+    if ( _angleStep <= 0.0 || !renderer()->isValid() )
+    {
+        QGraphicsSvgItem::paint( painter, option, widget );
+        return;
+    }
+
+    // item transformation as computed by QGraphicsItem
+    const QPointF origin = transformOriginPoint();
+
+    QTransform local( transform() );
+    local.translate( origin.x(), origin.y() );
+    local.rotate( rotation() );
+    local.scale( scale(), scale() );
+    local.translate( -origin.x(), -origin.y() );
+
+    // parent to device transformation
+    bool invertible = false;
+    QTransform base = local.inverted( &invertible ) * painter->worldTransform();
+
+    if ( !invertible || base.isRotating() )
+    {
+        QGraphicsSvgItem::paint( painter, option, widget );
+        return;
+    }
+
+    qreal dpr = painter->device()->devicePixelRatioF();
+
+    QTransform frameTransform = transform()
+            * QTransform::fromScale( base.m11() * dpr, base.m22() * dpr );
+
+    if ( _frames.isEmpty() || frameTransform != _frameTransform || dpr != _frameDpr )
+    {
+        if ( !_frames.isEmpty() && qfi_Cache::isDeferred() )
+        {
+            QGraphicsSvgItem::paint( painter, option, widget );
+            return;
+        }
+
+        clearFrames();
+
+        _frameTransform = frameTransform;
+        _frameDpr = dpr;
+
+        findContent();
+
+        _frames.resize( static_cast< int >( ceil( 360.0 / _angleStep - 1.0e-9 ) ) );
+    }
+
+    if ( _content.isEmpty() ) return;
+
+    double angle = fmod( rotation(), 360.0 );
+    if ( angle < 0.0 ) angle += 360.0;
+
+    int index = qRound( angle / _angleStep ) % _frames.size();
+
+    Frame &frame = _frames[ index ];
+
+    if ( frame.image.isNull() )
+    {
+        renderFrame( &frame, index * _angleStep );
+    }
+
+    double x = qRound( frame.offset.x() + base.dx() * dpr ) / dpr;
+    double y = qRound( frame.offset.y() + base.dy() * dpr ) / dpr;
+
+    painter->save();
+    painter->setWorldTransform( QTransform() );
+    painter->drawImage( QPointF( x, y ), frame.image );
+    painter->restore();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_AtlasSvgItem::clearFrames()
+{
+    _frames.clear();
+    _content = QRectF();
+
+    _totalBytes.fetchAndAddRelaxed( -_bytes );
+    _bytes = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_AtlasSvgItem::findContent()
+{
+    // most of the layers are full size images with a small visible part
+    // so frames are cropped to the non transparent part of the image
+    QRect bounds = _frameTransform.mapRect( boundingRect() ).toAlignedRect();
+
+    if ( bounds.isEmpty() ) return;
+
+    QImage image( bounds.size(), QImage::Format_ARGB32_Premultiplied );
+    image.fill( Qt::transparent );
+
+    QPainter painter( &image );
+    painter.setTransform( _frameTransform * QTransform::fromTranslate( -bounds.x(), -bounds.y() ) );
+    renderer()->render( &painter, boundingRect() );
+    painter.end();
+
+    int x_min = image.width();
+    int x_max = -1;
+    int y_min = image.height();
+    int y_max = -1;
+
+    for ( int y = 0; y < image.height(); y++ )
+    {
+        const QRgb *line = reinterpret_cast< const QRgb* >( image.constScanLine( y ) );
+
+        for ( int x = 0; x < image.width(); x++ )
+        {
+            if ( qAlpha( line[ x ] ) != 0 )
+            {
+                if ( x < x_min ) x_min = x;
+                if ( x > x_max ) x_max = x;
+                if ( y < y_min ) y_min = y;
+                if ( y > y_max ) y_max = y;
+            }
+        }
+    }
+
+    if ( x_max < 0 ) return;
+
+    // 1 px margin for antialiasing at other angles
+    QRectF content( bounds.x() + x_min - 1.0, bounds.y() + y_min - 1.0,
+                    x_max - x_min + 3.0, y_max - y_min + 3.0 );
+
+    _content = _frameTransform.inverted().mapRect( content );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_AtlasSvgItem::renderFrame( Frame *frame, double angle )
+{
+    const QPointF origin = transformOriginPoint();
+
+    QTransform rotate;
+    rotate.translate( origin.x(), origin.y() );
+    rotate.rotate( angle );
+    rotate.scale( scale(), scale() );
+    rotate.translate( -origin.x(), -origin.y() );
+
+    QTransform transform = rotate * _frameTransform;
+
+    QRect bounds = transform.mapRect( _content ).toAlignedRect();
+
+    QImage image( bounds.size(), QImage::Format_ARGB32_Premultiplied );
+    image.fill( Qt::transparent );
+
+    QPainter painter( &image );
+    painter.setTransform( transform * QTransform::fromTranslate( -bounds.x(), -bounds.y() ) );
+    painter.setClipRect( _content );
+    renderer()->render( &painter, boundingRect() );
+    painter.end();
+
+    image.setDevicePixelRatio( _frameDpr );
+
+    frame->image  = image;
+    frame->offset = bounds.topLeft();
+
+    qint64 bytes = static_cast< qint64 >( image.bytesPerLine() ) * image.height();
+    _bytes += bytes;
+    _totalBytes.fetchAndAddRelaxed( bytes );
+}
@@ -0,0 +1,108 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_ATLASSVGITEM_H
+#define QFI_ATLASSVGITEM_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QAtomicInteger>
+#include <QGraphicsSvgItem>
+#include <QImage>
+#include <QPoint>
+#include <QTransform>
+#include <QVector>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief SVG item painted from an atlas of pre-rotated frames.
+ *
+ * Intended for needles and rotating cards. When the angle step is greater
+ * than zero the item is rasterized lazily at discrete angles (multiples of
+ * the step) at the current scale and the frame nearest to the item rotation
+ * is blitted. Frames are discarded whenever the scale changes. Angle step
+ * equal to zero (default) disables the atlas mode.
+ */
+class QFIAPI qfi_AtlasSvgItem : public QGraphicsSvgItem
+{
+public:
+
+    /** @return [B] memory occupied by atlases of all items */
+    static qint64 totalBytes();
+
+    /** Constructor. */
+    explicit qfi_AtlasSvgItem( const QString &fileName,
+                               QGraphicsItem *parent = Q_NULLPTR );
+
+    /** Destructor. */
+    virtual ~qfi_AtlasSvgItem();
+
+    /** @return [B] memory occupied by atlas frames */
+    inline qint64 atlasBytes() const { return _bytes; }
+
+    /** @return [deg] atlas angle step */
+    inline double angleStep() const { return _angleStep; }
+
+    /** @param angleStep [deg] atlas angle step, 0 disables atlas mode */
+    void setAngleStep( double angleStep );
+
+    /** */
+    void paint( QPainter *painter,
+                const QStyleOptionGraphicsItem *option,
+                QWidget *widget = Q_NULLPTR ) override;
+
+private:
+
+    /** Atlas frame. */
+    struct Frame
+    {
+        QImage image;       ///< rasterized frame
+        QPoint  offset;     ///< [px] frame top-left corner relative to the item origin
+    };
+
+    static QAtomicInteger< qint64 > _totalBytes;
+
+    QVector< Frame > _frames;   ///< atlas frames
+
+    QRectF _content;            ///< non transparent part of the bounding rectangle
+
+    double _angleStep;          ///< [deg] atlas angle step
+
+    QTransform _frameTransform; ///< item to frame pixels transformation (without rotation)
+    qreal _frameDpr;            ///< frames device pixel ratio
+
+    qint64 _bytes;              ///< [B] memory occupied by atlas frames
+
+    int _profileId;             ///< profiler layer ID
+
+    void clearFrames();
+
+    void findContent();
+
+    void renderFrame( Frame *frame, double angle );
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_ATLASSVGITEM_H
@@ -0,0 +1,166 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+#include <qfi/qfi_Cache.h>
+
+#include <QCoreApplication>
+#include <QMutexLocker>
+
+#include <climits>
+
+////////////////////////////////////////////////////////////////////////////////
+
+QCache< QString, QImage > qfi_Cache::_cache( 128 * 1024 * 1024 );
+
+QMutex qfi_Cache::_mutex;
+
+qint64 qfi_Cache::_hits   = 0;
+qint64 qfi_Cache::_misses = 0;
+
+QElapsedTimer qfi_Cache::_clock;
+qint64 qfi_Cache::_deferredUntil = 0;
+
+bool qfi_Cache::_inited = false;
+
+////////////////////////////////////////////////////////////////////////////////
+
+QString qfi_Cache::key( const QString &file, const QSize &size, qreal dpr )
+{
+    return QString( "%1@%2x%3@%4" )
+            .arg( file )
+            .arg( size.width() )
+            .arg( size.height() )
+            .arg( dpr );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_Cache::find( const QString &key, QImage *image )
+{
+    QMutexLocker locker( &_mutex );
+
+    QImage *cached = _cache.object( key );
+
+    if ( cached )
+    {
+        _hits++;
+        *image = *cached;
+        return true;
+    }
+
+    _misses++;
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Cache::insert( const QString &key, const QImage &image )
+{
+    QMutexLocker locker( &_mutex );
+
+    if ( !_inited ) init();
+
+    qint64 cost = static_cast< qint64 >( image.bytesPerLine() )
+                * static_cast< qint64 >( image.height() );
+
+    // images larger than the whole cache are not stored (QCache drops them)
+    if ( cost <= _cache.maxCost() )
+    {
+        _cache.insert( key, new QImage( image ), static_cast< int >( cost ) );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Cache::clear()
+{
+    QMutexLocker locker( &_mutex );
+    _cache.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Cache::resetStats()
+{
+    QMutexLocker locker( &_mutex );
+    _hits   = 0;
+    _misses = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Cache::setMaxBytes( qint64 maxBytes )
+{
+    QMutexLocker locker( &_mutex );
+
+    if ( maxBytes < 0       ) maxBytes = 0;
+    if ( maxBytes > INT_MAX ) maxBytes = INT_MAX;
+
+    _cache.setMaxCost( static_cast< int >( maxBytes ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Cache::Stats qfi_Cache::stats()
+{
+    QMutexLocker locker( &_mutex );
+
+    Stats stats;
+
+    stats.hits     = _hits;
+    stats.misses   = _misses;
+    stats.bytes    = _cache.totalCost();
+    stats.maxBytes = _cache.maxCost();
+    stats.count    = _cache.count();
+
+    return stats;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Cache::deferRebuilds( int msec )
+{
+    QMutexLocker locker( &_mutex );
+
+    if ( !_clock.isValid() ) _clock.start();
+
+    _deferredUntil = qMax( _deferredUntil, _clock.elapsed() + msec );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_Cache::isDeferred()
+{
+    QMutexLocker locker( &_mutex );
+
+    return _clock.isValid() && _clock.elapsed() < _deferredUntil;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Cache::init()
+{
+    _inited = true;
+
+    // images must not outlive the application object
+    qAddPostRoutine( qfi_Cache::clear );
+}
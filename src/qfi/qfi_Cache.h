@@ -0,0 +1,123 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_CACHE_H
+#define QFI_CACHE_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QCache>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QString>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Process-wide raster cache class.
+ *
+ * Rasterized layers are keyed by resource path, pixel size and device pixel
+ * ratio, so all instances of the same instrument share their images.
+ * QImage is used rather than QPixmap as layers are also rasterized and drawn
+ * on worker threads (see qfi_ParallelRenderer).
+ */
+class QFIAPI qfi_Cache
+{
+public:
+
+    /** Cache statistics. */
+    struct Stats
+    {
+        qint64 hits;        ///< number of lookups served from the cache
+        qint64 misses;      ///< number of lookups which required rasterization
+        qint64 bytes;       ///< [B] memory occupied by cached images
+        qint64 maxBytes;    ///< [B] cache capacity
+        int count;          ///< number of cached images
+    };
+
+    /**
+     * @param file resource path
+     * @param size pixel size
+     * @param dpr device pixel ratio
+     * @return cache key
+     */
+    static QString key( const QString &file, const QSize &size, qreal dpr );
+
+    /**
+     * @param key cache key
+     * @param image output image
+     * @return true if image has been found, false otherwise
+     */
+    static bool find( const QString &key, QImage *image );
+
+    /**
+     * @param key cache key
+     * @param image image to be stored
+     */
+    static void insert( const QString &key, const QImage &image );
+
+    /** Removes all images from the cache. */
+    static void clear();
+
+    /** Resets hit and miss counters. */
+    static void resetStats();
+
+    /** @param maxBytes [B] cache capacity */
+    static void setMaxBytes( qint64 maxBytes );
+
+    /** @return cache statistics */
+    static Stats stats();
+
+    /**
+     * Defers rasterization of layers which already have an image of
+     * a different size, e.g. while a widget is being resized. Such layers are
+     * drawn by scaling their previous image (or as vectors) meanwhile.
+     * @param msec [ms] time from now
+     */
+    static void deferRebuilds( int msec );
+
+    /** @return true if rebuilding images is deferred */
+    static bool isDeferred();
+
+private:
+
+    static QCache< QString, QImage > _cache;
+
+    static QMutex _mutex;
+
+    static qint64 _hits;
+    static qint64 _misses;
+
+    static QElapsedTimer _clock;
+    static qint64 _deferredUntil;       ///< [ms] clock time
+
+    static bool _inited;
+
+    static void init();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_CACHE_H
@@ -0,0 +1,150 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+#include <qfi/qfi_CachedSvgItem.h>
+
+#include <QImage>
+#include <QPainter>
+#include <QPaintDevice>
+#include <QSvgRenderer>
+
+#include <qfi/qfi_Cache.h>
+#include <qfi/qfi_Profiler.h>
+#include <qfi/qfi_Renderers.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_CachedSvgItem::qfi_CachedSvgItem( const QString &fileName,
+                                      QGraphicsItem *parent ) :
+    QGraphicsSvgItem ( parent ),
+
+    _fileName ( fileName ),
+
+    _imageDpr  ( 0.0 ),
+
+    _profileId ( -1 )
+{
+    setSharedRenderer( qfi_Renderers::get( fileName, this ) );
+
+#   ifdef QFI_PROFILING
+    _profileId = qfi_Profiler::id( _fileName );
+#   endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_CachedSvgItem::addLayer( const QString &fileName )
+{
+    _layers.push_back( qfi_Renderers::get( fileName, this ) );
+    _fileName += "|" + fileName;
+
+#   ifdef QFI_PROFILING
+    _profileId = qfi_Profiler::id( _fileName );
+#   endif
+
+    _image     = QImage();
+    _imageSize = QSize();
+
+    update();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_CachedSvgItem::paint( QPainter *painter,
+                               const QStyleOptionGraphicsItem *option,
+                               QWidget *widget )
+{
+    QFI_PROFILE_ID( _profileId );
+
+    const QTransform transform = painter->worldTransform();
+
+    if ( !renderer()->isValid() || transform.isRotating() )
+    {
+        QGraphicsSvgItem::paint( painter, option, widget );
+
+        for ( int i = 0; i < _layers.size(); i++ )
+        {
+            _layers.at( i )->render( painter, boundingRect() );
+        }
+
+        return;
+    }
+
+    QRectF rect = transform.mapRect( boundingRect() );
+
+    qreal dpr = painter->device()->devicePixelRatioF();
+
+    QSize size( qRound( rect.width()  * dpr ),
+                qRound( rect.height() * dpr ) );
+
+    if ( size.isEmpty() ) return;
+
+    if ( ( size != _imageSize || dpr != _imageDpr )
+         && !_image.isNull() && qfi_Cache::isDeferred() )
+    {
+        // previous image is stretched until rebuilding is allowed again
+        painter->save();
+        painter->setRenderHint( QPainter::SmoothPixmapTransform );
+        painter->setWorldTransform( QTransform() );
+        painter->drawImage( rect, _image, QRectF( _image.rect() ) );
+        painter->restore();
+        return;
+    }
+
+    if ( size != _imageSize || dpr != _imageDpr )
+    {
+        QString key = qfi_Cache::key( _fileName, size, dpr );
+
+        if ( !qfi_Cache::find( key, &_image ) )
+        {
+            QImage image( size, QImage::Format_ARGB32_Premultiplied );
+            image.fill( Qt::transparent );
+
+            QRectF bounds( QPointF( 0.0, 0.0 ), QSizeF( size ) );
+
+            QPainter imagePainter( &image );
+            renderer()->render( &imagePainter, bounds );
+
+            for ( int i = 0; i < _layers.size(); i++ )
+            {
+                _layers.at( i )->render( &imagePainter, bounds );
+            }
+
+            imagePainter.end();
+
+            image.setDevicePixelRatio( dpr );
+
+            _image = image;
+
+            qfi_Cache::insert( key, _image );
+        }
+
+        _imageSize = size;
+        _imageDpr  = dpr;
+    }
+
+    // image is drawn in device coordinates at whole pixels to keep it sharp
+    painter->save();
+    painter->setWorldTransform( QTransform() );
+    painter->drawImage( QPointF( qRound( rect.x() ), qRound( rect.y() ) ), _image );
+    painter->restore();
+}
@@ -0,0 +1,81 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_CACHEDSVGITEM_H
+#define QFI_CACHEDSVGITEM_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QGraphicsSvgItem>
+#include <QImage>
+#include <QList>
+#include <QSvgRenderer>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief SVG item painted from the shared raster cache.
+ *
+ * Intended for layers which are never rotated. The layer is rasterized once
+ * per pixel size and device pixel ratio, see qfi_Cache. Rotated items fall
+ * back to the vector rendering.
+ *
+ * Consecutive (in the Z order) static layers of an instrument can be
+ * flattened into a single item with addLayer().
+ */
+class QFIAPI qfi_CachedSvgItem : public QGraphicsSvgItem
+{
+public:
+
+    /** Constructor. */
+    explicit qfi_CachedSvgItem( const QString &fileName,
+                                QGraphicsItem *parent = Q_NULLPTR );
+
+    /**
+     * Adds layer painted on top of the previous ones. Layer is expected
+     * to have the same size as the item's main SVG file.
+     * @param fileName layer SVG file
+     */
+    void addLayer( const QString &fileName );
+
+    /** */
+    void paint( QPainter *painter,
+                const QStyleOptionGraphicsItem *option,
+                QWidget *widget = Q_NULLPTR ) override;
+
+private:
+
+    QString _fileName;                  ///< resource path (joined paths of all layers)
+
+    QList< QSvgRenderer* > _layers;     ///< additional layers (shared or owned renderers)
+
+    QImage  _image;                     ///< last used image
+    QSize   _imageSize;                 ///< [px] last used image size
+    qreal   _imageDpr;                  ///< last used image device pixel ratio
+
+    int _profileId;                     ///< profiler layer ID
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_CACHEDSVGITEM_H
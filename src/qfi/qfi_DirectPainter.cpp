@@ -0,0 +1,96 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_DirectPainter.h>
+
+#include <QStyleOptionGraphicsItem>
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_DirectPainter::qfi_DirectPainter() {}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_DirectPainter::~qfi_DirectPainter()
+{
+    clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_DirectPainter::addItem( QGraphicsItem *item )
+{
+    if ( !item ) return;
+
+    int index = _items.size();
+
+    while ( index > 0 && _items.at( index - 1 )->zValue() > item->zValue() )
+    {
+        index--;
+    }
+
+    _items.insert( index, item );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_DirectPainter::clear()
+{
+    qDeleteAll( _items );
+    _items.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_DirectPainter::render( QPainter *painter, const QRectF &target,
+                                const QRectF &source ) const
+{
+    if ( source.isEmpty() || target.isEmpty() ) return;
+
+    // the same source to target mapping as QGraphicsScene::render()
+    // with Qt::IgnoreAspectRatio
+    QTransform view = QTransform::fromTranslate( -source.x(), -source.y() )
+                    * QTransform::fromScale( target.width()  / source.width(),
+                                             target.height() / source.height() )
+                    * QTransform::fromTranslate( target.x(), target.y() )
+                    * painter->worldTransform();
+
+    painter->save();
+    painter->setClipRect( target, Qt::IntersectClip );
+
+    QStyleOptionGraphicsItem option;
+
+    for ( int i = 0; i < _items.size(); i++ )
+    {
+        QGraphicsItem *item = _items.at( i );
+
+        if ( !item->isVisible() ) continue;
+
+        option.exposedRect = item->boundingRect();
+
+        painter->save();
+        painter->setWorldTransform( item->sceneTransform() * view );
+        item->paint( painter, &option, Q_NULLPTR );
+        painter->restore();
+    }
+
+    painter->restore();
+}
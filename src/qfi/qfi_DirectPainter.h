@@ -0,0 +1,87 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_DIRECTPAINTER_H
+#define QFI_DIRECTPAINTER_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QGraphicsItem>
+#include <QList>
+#include <QPainter>
+#include <QRectF>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Direct painter class.
+ *
+ * Immediate mode counterpart of QGraphicsScene used by instruments created
+ * with RenderBackend::Painter. Items are not added to any scene, so there is
+ * no BSP index, no dirty regions tracking and no scene update processing,
+ * items are painted in the Z order with their absolute transformations
+ * straight into the view or into an image. As the same items paint
+ * themselves with the same transformations the output is identical to
+ * the scene rendering.
+ */
+class QFIAPI qfi_DirectPainter
+{
+public:
+
+    /** Constructor. */
+    qfi_DirectPainter();
+
+    /** Destructor, items are deleted. */
+    virtual ~qfi_DirectPainter();
+
+    /**
+     * Adds item, painter takes ownership. Items with equal Z values are
+     * painted in the order they were added.
+     * @param item top-level item not added to any scene
+     */
+    void addItem( QGraphicsItem *item );
+
+    /** Deletes all items. */
+    void clear();
+
+    /** @return true if there are no items */
+    inline bool isEmpty() const { return _items.isEmpty(); }
+
+    /**
+     * Paints visible items, the same way as QGraphicsScene::render().
+     * @param painter painter
+     * @param target target rectangle in the painter coordinates
+     * @param source rectangle in the items parent coordinates
+     */
+    void render( QPainter *painter, const QRectF &target, const QRectF &source ) const;
+
+private:
+
+    QList< QGraphicsItem* > _items;     ///< items sorted by Z value
+
+    Q_DISABLE_COPY( qfi_DirectPainter )
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_DIRECTPAINTER_H
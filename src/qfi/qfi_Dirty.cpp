@@ -0,0 +1,49 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+#include <qfi/qfi_Dirty.h>
+
+#ifdef WIN32
+#   include <float.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+double qfi_Dirty::_epsilon = 0.25;
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Dirty::setEpsilon( double epsilon )
+{
+    _epsilon = ( epsilon > 0.0 ) ? epsilon : 0.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double qfi_Dirty::pxPerDeg( double radius )
+{
+#   ifndef M_PI
+    return 3.14159265358979323846 * radius / 180.0;
+#   else
+    return M_PI * radius / 180.0;
+#   endif
+}
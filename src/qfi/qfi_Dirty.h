@@ -0,0 +1,90 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_DIRTY_H
+#define QFI_DIRTY_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Dirty tracking helper class.
+ *
+ * Instruments always store a new value, but are marked dirty only if it
+ * differs from the value currently drawn by at least the threshold given in
+ * display pixels (or changes a readout). The displayed state never differs
+ * from the requested one by more than the threshold, and the latest value is
+ * drawn as soon as anything else makes the instrument redraw.
+ */
+class QFIAPI qfi_Dirty
+{
+public:
+
+    /** @return [px] change threshold */
+    static inline double epsilon()
+    {
+        return _epsilon;
+    }
+
+    /** @param epsilon [px] change threshold (default 0.25 px) */
+    static void setEpsilon( double epsilon );
+
+    /**
+     * @param radius [px] distance from the rotation center
+     * @return [px/deg] display pixels per degree of rotation
+     */
+    static double pxPerDeg( double radius );
+
+    /**
+     * @param value_new new value
+     * @param value_old value currently drawn
+     * @param pxPerUnit [px/unit] display pixels per unit of the quantity
+     * @return true if the change is visible
+     */
+    static inline bool isChanged( double value_new, double value_old, double pxPerUnit )
+    {
+        return fabs( value_new - value_old ) * pxPerUnit >= _epsilon;
+    }
+
+    /**
+     * @param value_new new value
+     * @param value_old value currently drawn (or previous value)
+     * @param resolution readout resolution (e.g. 0.1 for one decimal place)
+     * @return true if the readout changes
+     */
+    static inline bool isReadoutChanged( double value_new, double value_old, double resolution )
+    {
+        return floor( value_new / resolution + 0.5 ) != floor( value_old / resolution + 0.5 );
+    }
+
+private:
+
+    static double _epsilon;     ///< [px] change threshold
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_DIRTY_H
@@ -28,8 +28,16 @@
 
 #include <cmath>
 
+#include <qfi/qfi_Cache.h>
+#include <qfi/qfi_CachedSvgItem.h>
 #include <qfi/qfi_Colors.h>
 #include <qfi/qfi_Fonts.h>
+#include <qfi/qfi_Interpolation.h>
+#include <qfi/qfi_Latency.h>
+#include <qfi/qfi_Offscreen.h>
+#include <qfi/qfi_Profiler.h>
+#include <qfi/qfi_Renderers.h>
+#include <qfi/qfi_Trace.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -38,6 +46,8 @@ qfi_EADI::qfi_EADI( QWidget *parent ) :
 
     _scene ( Q_NULLPTR ),
 
+    _resizeTimer ( Q_NULLPTR ),
+
     _adi ( Q_NULLPTR ),
     _alt ( Q_NULLPTR ),
     _asi ( Q_NULLPTR ),
@@ -62,6 +72,10 @@ qfi_EADI::qfi_EADI( QWidget *parent ) :
     _lnav ( LNAV::Off ),
     _vnav ( VNAV::Off ),
 
+    _dirty ( true ),
+
+    _suppressedRedraws ( 0 ),
+
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
 
@@ -86,6 +100,11 @@ qfi_EADI::qfi_EADI( QWidget *parent ) :
     _scene = new QGraphicsScene( this );
     setScene( _scene );
 
+    _resizeTimer = new QTimer( this );
+    _resizeTimer->setSingleShot( true );
+    _resizeTimer->setInterval( 200 );
+    connect( _resizeTimer, &QTimer::timeout, this, &qfi_EADI::reinit );
+
     _scene->clear();
 
     _adi = new qfi_EADI::ADI( _scene );
@@ -132,6 +151,10 @@ void qfi_EADI::reinit()
 {
     if ( _scene )
     {
+        _resizeTimer->stop();
+
+        resetTransform();
+
         _scene->clear();
 
         init();
@@ -143,9 +166,112 @@ void qfi_EADI::reinit()
 void qfi_EADI::redraw()
 {
     if ( isVisible() )
+    {
+        State state;
+
+        if ( _stateBuffer.consume( &state ) ) setState( state );
+
+        if ( _dirty
+          || _adi->isDirty() || _alt->isDirty() || _asi->isDirty()
+          || _hdg->isDirty() || _vsi->isDirty() )
+        {
+            updateView();
+        }
+        else
+        {
+            _suppressedRedraws++;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_EADI::renderImage( QImage &image )
+{
+    QSize size = qfi_Offscreen::size( image );
+
+    if ( size.isEmpty() ) return;
+
+    State state;
+
+    if ( _stateBuffer.consume( &state ) ) setState( state );
+
+    if ( !isVisible() && size != this->size() )
+    {
+        resize( size );
+        reinit();
+    }
+
+    if ( _dirty
+      || _adi->isDirty() || _alt->isDirty() || _asi->isDirty()
+      || _hdg->isDirty() || _vsi->isDirty() )
     {
         updateView();
     }
+
+    qfi_Offscreen::render( _scene,
+                           QRectF( 0.0, 0.0, _scaleX * _originalWidth, _scaleY * _originalHeight ),
+                           image, renderHints() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_EADI::setState( const State &state )
+{
+    if ( _stateHook ) _stateHook( state );
+
+    setFltMode     ( state.fltMode );
+    setSpdMode     ( state.spdMode );
+    setLNAV        ( state.lnav );
+    setVNAV        ( state.vnav );
+    setRoll        ( state.roll );
+    setPitch       ( state.pitch );
+    setFPM         ( state.aoa, state.sideslip, state.fpmVisible );
+    setSlipSkid    ( state.slipSkid );
+    setTurnRate    ( state.turnRate );
+    setDots        ( state.dotH, state.dotV, state.dotVisibleH, state.dotVisibleV );
+    setFD          ( state.fdRoll, state.fdPitch, state.fdVisible );
+    setStall       ( state.stall );
+    setAltitude    ( state.altitude );
+    setPressure    ( state.pressure, state.pressureMode );
+    setAirspeed    ( state.airspeed );
+    setMachNo      ( state.machNo );
+    setHeading     ( state.heading );
+    setClimbRate   ( state.climbRate );
+    setAirspeedSel ( state.airspeedSel );
+    setAltitudeSel ( state.altitudeSel );
+    setHeadingSel  ( state.headingSel );
+    setVfe         ( state.vfe );
+    setVne         ( state.vne );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_EADI::State::interpolate( const State &s0, const State &s1, double ratio, State *result )
+{
+    *result = ( ratio < 0.5 ) ? s0 : s1;
+
+    result->roll        = qfi_Interpolation::roll  ( s0.roll, s1.roll, ratio );
+    result->pitch       = qfi_Interpolation::linear( s0.pitch, s1.pitch, ratio );
+    result->aoa         = qfi_Interpolation::linear( s0.aoa, s1.aoa, ratio );
+    result->sideslip    = qfi_Interpolation::linear( s0.sideslip, s1.sideslip, ratio );
+    result->slipSkid    = qfi_Interpolation::linear( s0.slipSkid, s1.slipSkid, ratio );
+    result->turnRate    = qfi_Interpolation::linear( s0.turnRate, s1.turnRate, ratio );
+    result->dotH        = qfi_Interpolation::linear( s0.dotH, s1.dotH, ratio );
+    result->dotV        = qfi_Interpolation::linear( s0.dotV, s1.dotV, ratio );
+    result->fdRoll      = qfi_Interpolation::roll  ( s0.fdRoll, s1.fdRoll, ratio );
+    result->fdPitch     = qfi_Interpolation::linear( s0.fdPitch, s1.fdPitch, ratio );
+    result->altitude    = qfi_Interpolation::linear( s0.altitude, s1.altitude, ratio );
+    result->pressure    = qfi_Interpolation::linear( s0.pressure, s1.pressure, ratio );
+    result->airspeed    = qfi_Interpolation::linear( s0.airspeed, s1.airspeed, ratio );
+    result->machNo      = qfi_Interpolation::linear( s0.machNo, s1.machNo, ratio );
+    result->heading     = qfi_Interpolation::angle ( s0.heading, s1.heading, ratio );
+    result->climbRate   = qfi_Interpolation::linear( s0.climbRate, s1.climbRate, ratio );
+    result->airspeedSel = qfi_Interpolation::linear( s0.airspeedSel, s1.airspeedSel, ratio );
+    result->altitudeSel = qfi_Interpolation::linear( s0.altitudeSel, s1.altitudeSel, ratio );
+    result->headingSel  = qfi_Interpolation::angle ( s0.headingSel, s1.headingSel, ratio );
+    result->vfe         = qfi_Interpolation::linear( s0.vfe, s1.vfe, ratio );
+    result->vne         = qfi_Interpolation::linear( s0.vne, s1.vne, ratio );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -156,7 +282,37 @@ void qfi_EADI::resizeEvent( QResizeEvent *event )
     QGraphicsView::resizeEvent( event );
     ////////////////////////////////////
 
-    reinit();
+    if ( isVisible() && _itemBack )
+    {
+        rescale();
+    }
+    else
+    {
+        reinit();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_EADI::rescale()
+{
+    // items and their state are kept, the scene is rebuilt at the new scale
+    // once the size settles
+    setTransform( QTransform::fromScale( width()  / ( _scaleX * _originalWidth  ),
+                                         height() / ( _scaleY * _originalHeight ) ) );
+
+    centerOn( _scaleX * _originalWidth / 2.0 , _scaleY * _originalHeight / 2.0 );
+
+    // changes too small to be visible at the previous size may be visible now
+    _adi->setDirty();
+    _alt->setDirty();
+    _asi->setDirty();
+    _hdg->setDirty();
+    _vsi->setDirty();
+
+    qfi_Cache::deferRebuilds( _resizeTimer->interval() );
+
+    _resizeTimer->start();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -174,22 +330,21 @@ void qfi_EADI::init()
     _hdg->init( _scaleX, _scaleY );
     _vsi->init( _scaleX, _scaleY );
 
-    _itemBack = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_back.svg" );
+    _itemBack = new qfi_CachedSvgItem( ":/qfi/images/eadi/eadi_back.svg" );
     _itemBack->setCacheMode( QGraphicsItem::NoCache );
     _itemBack->setZValue( _backZ );
     _itemBack->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _scene->addItem( _itemBack );
 
-    _itemMask = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_mask.svg" );
+    _itemMask = new qfi_CachedSvgItem( ":/qfi/images/eadi/eadi_mask.svg" );
     _itemMask->setCacheMode( QGraphicsItem::NoCache );
     _itemMask->setZValue( _maskZ );
     _itemMask->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _scene->addItem( _itemMask );
 
-    _itemFMA = new QGraphicsTextItem( QString( "  CMD  " ) );
+    _itemFMA = new qfi_GlyphTextItem( QString( "  CMD  " ) );
     _itemFMA->setCacheMode( QGraphicsItem::NoCache );
     _itemFMA->setZValue( _textZ );
-    _itemFMA->setTextInteractionFlags( Qt::NoTextInteraction );
     _itemFMA->setDefaultTextColor( qfi_Colors::_lime );
     _itemFMA->setFont( qfi_Fonts::medium() );
     _itemFMA->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -197,10 +352,9 @@ void qfi_EADI::init()
                       _scaleY * ( _originalFMA.y() - _itemFMA->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemFMA );
 
-    _itemSPD = new QGraphicsTextItem( QString( "FMC SPD" ) );
+    _itemSPD = new qfi_GlyphTextItem( QString( "FMC SPD" ) );
     _itemSPD->setCacheMode( QGraphicsItem::NoCache );
     _itemSPD->setZValue( _textZ );
-    _itemSPD->setTextInteractionFlags( Qt::NoTextInteraction );
     _itemSPD->setDefaultTextColor( qfi_Colors::_lime );
     _itemSPD->setFont( qfi_Fonts::xsmall() );
     _itemSPD->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -208,10 +362,9 @@ void qfi_EADI::init()
                       _scaleY * ( _originalSPD.y() - _itemSPD->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemSPD );
 
-    _itemLNAV = new QGraphicsTextItem( QString( "HDG SEL" ) );
+    _itemLNAV = new qfi_GlyphTextItem( QString( "HDG SEL" ) );
     _itemLNAV->setCacheMode( QGraphicsItem::NoCache );
     _itemLNAV->setZValue( _textZ );
-    _itemLNAV->setTextInteractionFlags( Qt::NoTextInteraction );
     _itemLNAV->setDefaultTextColor( qfi_Colors::_lime );
     _itemLNAV->setFont( qfi_Fonts::xsmall() );
     _itemLNAV->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -219,10 +372,9 @@ void qfi_EADI::init()
                        _scaleY * ( _originalLNAV.y() - _itemLNAV->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemLNAV );
 
-    _itemVNAV = new QGraphicsTextItem( QString( "ALT SEL" ) );
+    _itemVNAV = new qfi_GlyphTextItem( QString( "ALT SEL" ) );
     _itemVNAV->setCacheMode( QGraphicsItem::NoCache );
     _itemVNAV->setZValue( _textZ );
-    _itemVNAV->setTextInteractionFlags( Qt::NoTextInteraction );
     _itemVNAV->setDefaultTextColor( qfi_Colors::_lime );
     _itemVNAV->setFont( qfi_Fonts::xsmall() );
     _itemVNAV->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -230,10 +382,9 @@ void qfi_EADI::init()
                        _scaleY * ( _originalVNAV.y() - _itemVNAV->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemVNAV );
 
-    _itemLNAV_ARM = new QGraphicsTextItem( QString( "VOR/LOC" ) );
+    _itemLNAV_ARM = new qfi_GlyphTextItem( QString( "VOR/LOC" ) );
     _itemLNAV_ARM->setCacheMode( QGraphicsItem::NoCache );
     _itemLNAV_ARM->setZValue( _textZ );
-    _itemLNAV_ARM->setTextInteractionFlags( Qt::NoTextInteraction );
     _itemLNAV_ARM->setDefaultTextColor( qfi_Colors::_white );
     _itemLNAV_ARM->setFont( qfi_Fonts::xsmall() );
     _itemLNAV_ARM->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -241,10 +392,9 @@ void qfi_EADI::init()
                            _scaleY * ( _originalLNAV_ARM.y() - _itemLNAV_ARM->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemLNAV_ARM );
 
-    _itemVNAV_ARM = new QGraphicsTextItem( QString( "GS PATH" ) );
+    _itemVNAV_ARM = new qfi_GlyphTextItem( QString( "GS PATH" ) );
     _itemVNAV_ARM->setCacheMode( QGraphicsItem::NoCache );
     _itemVNAV_ARM->setZValue( _textZ );
-    _itemVNAV_ARM->setTextInteractionFlags( Qt::NoTextInteraction );
     _itemVNAV_ARM->setDefaultTextColor( qfi_Colors::_white );
     _itemVNAV_ARM->setFont( qfi_Fonts::xsmall() );
     _itemVNAV_ARM->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -270,14 +420,17 @@ void qfi_EADI::reset()
 
     _itemLNAV_ARM = Q_NULLPTR;
     _itemVNAV_ARM = Q_NULLPTR;
+
+    _dirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::updateView()
 {
-    _scaleX = static_cast< double >( width()  ) / static_cast< double >( _originalWidth  );
-    _scaleY = static_cast< double >( height() ) / static_cast< double >( _originalHeight );
+    QFI_PROFILE( "qfi_EADI::updateView" );
+    QFI_TRACE( "updateView", "qfi_EADI" );
+    qfi_Latency::updated( this );
 
     _adi->update( _scaleX, _scaleY );
     _alt->update( _scaleX, _scaleY );
@@ -285,45 +438,57 @@ void qfi_EADI::updateView()
     _asi->update( _scaleX, _scaleY );
     _hdg->update( _scaleX, _scaleY );
 
+    if ( _dirty )
+    {
+        updateModes();
+    }
+
+    _dirty = false;
+
+    _scene->update();
+
+    centerOn( _scaleX * _originalWidth / 2.0 , _scaleY * _originalHeight / 2.0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_EADI::updateModes()
+{
     switch ( _fltMode )
     {
-        case FltMode::FD:  _itemFMA->setPlainText( "  FD   " ); break;
-        case FltMode::CMD: _itemFMA->setPlainText( "  CMD  " ); break;
-        default:           _itemFMA->setPlainText( "       " ); break;
+        case FltMode::FD:  _itemFMA->setText( "  FD   " ); break;
+        case FltMode::CMD: _itemFMA->setText( "  CMD  " ); break;
+        default:           _itemFMA->setText( "       " ); break;
     }
 
     switch ( _spdMode )
     {
-        case SpdMode::FMC_SPD: _itemSPD->setPlainText( "FMC SPD" ); break;
-        default:               _itemSPD->setPlainText( "       " ); break;
+        case SpdMode::FMC_SPD: _itemSPD->setText( "FMC SPD" ); break;
+        default:               _itemSPD->setText( "       " ); break;
     }
 
     switch ( _lnav )
     {
-        case LNAV::HDG:     _itemLNAV->setPlainText( "HDG SEL" ); _itemLNAV_ARM->setPlainText( "       " ); break;
-        case LNAV::NAV:     _itemLNAV->setPlainText( "VOR/LOC" ); _itemLNAV_ARM->setPlainText( "       " ); break;
-        case LNAV::NAV_ARM: _itemLNAV->setPlainText( "HDG SEL" ); _itemLNAV_ARM->setPlainText( "VOR/LOC" ); break;
-        case LNAV::APR:     _itemLNAV->setPlainText( "  APR  " ); _itemLNAV_ARM->setPlainText( "       " ); break;
-        case LNAV::APR_ARM: _itemLNAV->setPlainText( "  APR  " ); _itemLNAV_ARM->setPlainText( "  APR  " ); break;
-        case LNAV::BC:      _itemLNAV->setPlainText( "  BC   " ); _itemLNAV_ARM->setPlainText( "       " ); break;
-        case LNAV::BC_ARM:  _itemLNAV->setPlainText( "  BC   " ); _itemLNAV_ARM->setPlainText( "  BC   " ); break;
-        default:            _itemLNAV->setPlainText( "       " ); _itemLNAV_ARM->setPlainText( "       " ); break;
+        case LNAV::HDG:     _itemLNAV->setText( "HDG SEL" ); _itemLNAV_ARM->setText( "       " ); break;
+        case LNAV::NAV:     _itemLNAV->setText( "VOR/LOC" ); _itemLNAV_ARM->setText( "       " ); break;
+        case LNAV::NAV_ARM: _itemLNAV->setText( "HDG SEL" ); _itemLNAV_ARM->setText( "VOR/LOC" ); break;
+        case LNAV::APR:     _itemLNAV->setText( "  APR  " ); _itemLNAV_ARM->setText( "       " ); break;
+        case LNAV::APR_ARM: _itemLNAV->setText( "  APR  " ); _itemLNAV_ARM->setText( "  APR  " ); break;
+        case LNAV::BC:      _itemLNAV->setText( "  BC   " ); _itemLNAV_ARM->setText( "       " ); break;
+        case LNAV::BC_ARM:  _itemLNAV->setText( "  BC   " ); _itemLNAV_ARM->setText( "  BC   " ); break;
+        default:            _itemLNAV->setText( "       " ); _itemLNAV_ARM->setText( "       " ); break;
     }
 
     switch ( _vnav )
     {
-        case VNAV::ALT:     _itemVNAV->setPlainText( "  ALT  " ); _itemVNAV_ARM->setPlainText( "       " ); break;
-        case VNAV::IAS:     _itemVNAV->setPlainText( "  IAS  " ); _itemVNAV_ARM->setPlainText( "       " ); break;
-        case VNAV::VS:      _itemVNAV->setPlainText( "  VS   " ); _itemVNAV_ARM->setPlainText( "       " ); break;
-        case VNAV::ALT_SEL: _itemVNAV->setPlainText( "ALT SEL" ); _itemVNAV_ARM->setPlainText( "       " ); break;
-        case VNAV::GS:      _itemVNAV->setPlainText( "GS PATH" ); _itemVNAV_ARM->setPlainText( "       " ); break;
-        case VNAV::GS_ARM:  _itemVNAV->setPlainText( "GS PATH" ); _itemVNAV_ARM->setPlainText( "GS PATH" ); break;
-        default:            _itemVNAV->setPlainText( "       " ); _itemVNAV_ARM->setPlainText( "       " ); break;
+        case VNAV::ALT:     _itemVNAV->setText( "  ALT  " ); _itemVNAV_ARM->setText( "       " ); break;
+        case VNAV::IAS:     _itemVNAV->setText( "  IAS  " ); _itemVNAV_ARM->setText( "       " ); break;
+        case VNAV::VS:      _itemVNAV->setText( "  VS   " ); _itemVNAV_ARM->setText( "       " ); break;
+        case VNAV::ALT_SEL: _itemVNAV->setText( "ALT SEL" ); _itemVNAV_ARM->setText( "       " ); break;
+        case VNAV::GS:      _itemVNAV->setText( "GS PATH" ); _itemVNAV_ARM->setText( "       " ); break;
+        case VNAV::GS_ARM:  _itemVNAV->setText( "GS PATH" ); _itemVNAV_ARM->setText( "GS PATH" ); break;
+        default:            _itemVNAV->setText( "       " ); _itemVNAV_ARM->setText( "       " ); break;
     }
-
-    _scene->update();
-
-    centerOn( width() / 2.0 , height() / 2.0 );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -357,6 +522,17 @@ qfi_EADI::ADI::ADI( QGraphicsScene *scene ) :
     _angleOfAttack ( 0.0 ),
     _sideslipAngle ( 0.0 ),
 
+    _roll_old     ( 0.0 ),
+    _pitch_old    ( 0.0 ),
+    _slipSkid_old ( 0.0 ),
+    _turnRate_old ( 0.0 ),
+    _dotH_old     ( 0.0 ),
+    _dotV_old     ( 0.0 ),
+    _fdRoll_old   ( 0.0 ),
+    _fdPitch_old  ( 0.0 ),
+    _angleOfAttack_old ( 0.0 ),
+    _sideslipAngle_old ( 0.0 ),
+
     _fpmValid ( false ),
 
     _fpmVisible  ( false ),
@@ -397,6 +573,8 @@ qfi_EADI::ADI::ADI( QGraphicsScene *scene ) :
     _fpmxDeltaY_new     ( 0.0 ),
     _fpmxDeltaY_old     ( 0.0 ),
 
+    _dirty ( true ),
+
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
 
@@ -406,6 +584,7 @@ qfi_EADI::ADI::ADI( QGraphicsScene *scene ) :
     _maxSlipDeflection (  20.0 ),
     _maxTurnDeflection (  55.0 ),
     _maxDotsDeflection (  50.0 ),
+    _originalRadius    ( 100.0 ),
 
     _originalAdiCtr    ( 150.0 ,  125.0 ),
     _originalBackPos   (  45.0 ,  -85.0 ),
@@ -445,7 +624,7 @@ void qfi_EADI::ADI::init( double scaleX, double scaleY )
 
     reset();
 
-    _itemBack = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_adi_back.svg" );
+    _itemBack = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_adi_back.svg" );
     _itemBack->setCacheMode( QGraphicsItem::NoCache );
     _itemBack->setZValue( _backZ );
     _itemBack->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -453,7 +632,7 @@ void qfi_EADI::ADI::init( double scaleX, double scaleY )
     _itemBack->moveBy( _scaleX * _originalBackPos.x(), _scaleY * _originalBackPos.y() );
     _scene->addItem( _itemBack );
 
-    _itemLadd = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_adi_ladd.svg" );
+    _itemLadd = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_adi_ladd.svg" );
     _itemLadd->setCacheMode( QGraphicsItem::NoCache );
     _itemLadd->setZValue( _laddZ );
     _itemLadd->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -461,7 +640,7 @@ void qfi_EADI::ADI::init( double scaleX, double scaleY )
     _itemLadd->moveBy( _scaleX * _originalLaddPos.x(), _scaleY * _originalLaddPos.y() );
     _scene->addItem( _itemLadd );
 
-    _itemRoll = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_adi_roll.svg" );
+    _itemRoll = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_adi_roll.svg" );
     _itemRoll->setCacheMode( QGraphicsItem::NoCache );
     _itemRoll->setZValue( _rollZ );
     _itemRoll->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -469,7 +648,7 @@ void qfi_EADI::ADI::init( double scaleX, double scaleY )
     _itemRoll->moveBy( _scaleX * _originalRollPos.x(), _scaleY * _originalRollPos.y() );
     _scene->addItem( _itemRoll );
 
-    _itemSlip = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_adi_slip.svg" );
+    _itemSlip = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_adi_slip.svg" );
     _itemSlip->setCacheMode( QGraphicsItem::NoCache );
     _itemSlip->setZValue( _slipZ );
     _itemSlip->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -477,28 +656,28 @@ void qfi_EADI::ADI::init( double scaleX, double scaleY )
     _itemSlip->moveBy( _scaleX * _originalSlipPos.x(), _scaleY * _originalSlipPos.y() );
     _scene->addItem( _itemSlip );
 
-    _itemTurn = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_adi_turn.svg" );
+    _itemTurn = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_adi_turn.svg" );
     _itemTurn->setCacheMode( QGraphicsItem::NoCache );
     _itemTurn->setZValue( _turnZ );
     _itemTurn->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemTurn->moveBy( _scaleX * _originalTurnPos.x(), _scaleY * _originalTurnPos.y() );
     _scene->addItem( _itemTurn );
 
-    _itemDotH = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_adi_doth.svg" );
+    _itemDotH = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_adi_doth.svg" );
     _itemDotH->setCacheMode( QGraphicsItem::NoCache );
     _itemDotH->setZValue( _dotsZ - 1 );
     _itemDotH->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemDotH->moveBy( _scaleX * _originalDotHPos.x(), _scaleY * _originalDotHPos.y() );
     _scene->addItem( _itemDotH );
 
-    _itemDotV = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_adi_dotv.svg" );
+    _itemDotV = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_adi_dotv.svg" );
     _itemDotV->setCacheMode( QGraphicsItem::NoCache );
     _itemDotV->setZValue( _dotsZ - 1 );
     _itemDotV->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemDotV->moveBy( _scaleX * _originalDotVPos.x(), _scaleY * _originalDotVPos.y() );
     _scene->addItem( _itemDotV );
 
-    _itemFD = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_adi_fd.svg" );
+    _itemFD = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_adi_fd.svg" );
     _itemFD->setCacheMode( QGraphicsItem::NoCache );
     _itemFD->setZValue( _fdZ );
     _itemFD->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -506,41 +685,41 @@ void qfi_EADI::ADI::init( double scaleX, double scaleY )
     _itemFD->moveBy( _scaleX * _originalFdPos.x(), _scaleY * _originalFdPos.y() );
     _scene->addItem( _itemFD );
 
-    _itemStall = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_adi_stall.svg" );
+    _itemStall = new qfi_CachedSvgItem( ":/qfi/images/eadi/eadi_adi_stall.svg" );
     _itemStall->setCacheMode( QGraphicsItem::NoCache );
     _itemStall->setZValue( _stallZ );
     _itemStall->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemStall->moveBy( _scaleX * _originalStallPos.x(), _scaleY * _originalStallPos.y() );
     _scene->addItem( _itemStall );
 
-    _itemScaleH = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_adi_scaleh.svg" );
+    _itemScaleH = new qfi_CachedSvgItem( ":/qfi/images/eadi/eadi_adi_scaleh.svg" );
     _itemScaleH->setCacheMode( QGraphicsItem::NoCache );
     _itemScaleH->setZValue( _scalesZ );
     _itemScaleH->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemScaleH->moveBy( _scaleX * _originalScaleHPos.x(), _scaleY * _originalScaleHPos.y() );
     _scene->addItem( _itemScaleH );
 
-    _itemScaleV = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_adi_scalev.svg" );
+    _itemScaleV = new qfi_CachedSvgItem( ":/qfi/images/eadi/eadi_adi_scalev.svg" );
     _itemScaleV->setCacheMode( QGraphicsItem::NoCache );
     _itemScaleV->setZValue( _scalesZ );
     _itemScaleV->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemScaleV->moveBy( _scaleX * _originalScaleVPos.x(), _scaleY * _originalScaleVPos.y() );
     _scene->addItem( _itemScaleV );
 
-    _itemMask = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_adi_mask.svg" );
+    _itemMask = new qfi_CachedSvgItem( ":/qfi/images/eadi/eadi_adi_mask.svg" );
     _itemMask->setCacheMode( QGraphicsItem::NoCache );
     _itemMask->setZValue( _maskZ );
     _itemMask->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _scene->addItem( _itemMask );
 
-    _itemFPM = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_adi_fpm.svg" );
+    _itemFPM = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_adi_fpm.svg" );
     _itemFPM->setCacheMode( QGraphicsItem::NoCache );
     _itemFPM->setZValue( _fpmZ );
     _itemFPM->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemFPM->moveBy( _scaleX * _originalFpmPos.x(), _scaleY * _originalFpmPos.y() );
     _scene->addItem( _itemFPM );
 
-    _itemFPMX = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_adi_fpmx.svg" );
+    _itemFPMX = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_adi_fpmx.svg" );
     _itemFPMX->setCacheMode( QGraphicsItem::NoCache );
     _itemFPMX->setZValue( _fpmZ );
     _itemFPMX->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -557,6 +736,11 @@ void qfi_EADI::ADI::update( double scaleX, double scaleY )
     _scaleX = scaleX;
     _scaleY = scaleY;
 
+    if ( !_dirty )
+    {
+        return;
+    }
+
     double delta = _originalPixPerDeg * _pitch;
 
 #   ifndef M_PI
@@ -593,97 +777,155 @@ void qfi_EADI::ADI::update( double scaleX, double scaleY )
     _fpmDeltaY_old      = _fpmDeltaY_new;
     _fpmxDeltaX_old     = _fpmxDeltaX_new;
     _fpmxDeltaY_old     = _fpmxDeltaY_new;
+
+    _roll_old          = _roll;
+    _pitch_old         = _pitch;
+    _slipSkid_old      = _slipSkid;
+    _turnRate_old      = _turnRate;
+    _dotH_old          = _dotH;
+    _dotV_old          = _dotV;
+    _fdRoll_old        = _fdRoll;
+    _fdPitch_old       = _fdPitch;
+    _angleOfAttack_old = _angleOfAttack;
+    _sideslipAngle_old = _sideslipAngle;
+
+    _dirty = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ADI::setRoll( double roll )
 {
+    if      ( roll < -180.0 ) roll = -180.0;
+    else if ( roll >  180.0 ) roll =  180.0;
+
+    double pxPerDeg = qfi_Dirty::pxPerDeg( _originalRadius * qMin( _scaleX, _scaleY ) );
+
     _roll = roll;
 
-    if      ( _roll < -180.0 ) _roll = -180.0;
-    else if ( _roll >  180.0 ) _roll =  180.0;
+    if ( qfi_Dirty::isChanged( _roll, _roll_old, pxPerDeg ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ADI::setPitch( double pitch )
 {
+    if      ( pitch < -90.0 ) pitch = -90.0;
+    else if ( pitch >  90.0 ) pitch =  90.0;
+
     _pitch = pitch;
 
-    if      ( _pitch < -90.0 ) _pitch = -90.0;
-    else if ( _pitch >  90.0 ) _pitch =  90.0;
+    if ( qfi_Dirty::isChanged( _pitch, _pitch_old, _originalPixPerDeg * _scaleY ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ADI::setFPM( double aoa, double sideslip, bool visible )
 {
-    _angleOfAttack = aoa;
-    _sideslipAngle = sideslip;
-
-    _fpmValid = true;
+    bool valid = true;
 
-    if ( _angleOfAttack < -15.0 )
+    if ( aoa < -15.0 )
     {
-        _angleOfAttack = -15.0;
-        _fpmValid = false;
+        aoa = -15.0;
+        valid = false;
     }
-    else if ( _angleOfAttack > 15.0 )
+    else if ( aoa > 15.0 )
     {
-        _angleOfAttack = 15.0;
-        _fpmValid = false;
+        aoa = 15.0;
+        valid = false;
     }
 
-    if ( _sideslipAngle < -10.0 )
+    if ( sideslip < -10.0 )
     {
-        _sideslipAngle = -10.0;
-        _fpmValid = false;
+        sideslip = -10.0;
+        valid = false;
     }
-    else if ( _sideslipAngle > 10.0 )
+    else if ( sideslip > 10.0 )
+    {
+        sideslip = 10.0;
+        valid = false;
+    }
+
+    if ( valid != _fpmValid || visible != _fpmVisible )
     {
-        _sideslipAngle = 10.0;
-        _fpmValid = false;
+        _dirty = true;
     }
 
+    _angleOfAttack = aoa;
+    _sideslipAngle = sideslip;
+
+    _fpmValid   = valid;
     _fpmVisible = visible;
+
+    if ( qfi_Dirty::isChanged( _angleOfAttack, _angleOfAttack_old, _originalPixPerDeg * _scaleY )
+      || qfi_Dirty::isChanged( _sideslipAngle, _sideslipAngle_old, _originalPixPerDeg * _scaleX ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ADI::setSlipSkid( double slipSkid )
 {
+    if      ( slipSkid < -1.0 ) slipSkid = -1.0;
+    else if ( slipSkid >  1.0 ) slipSkid =  1.0;
+
     _slipSkid = slipSkid;
 
-    if      ( _slipSkid < -1.0 ) _slipSkid = -1.0;
-    else if ( _slipSkid >  1.0 ) _slipSkid =  1.0;
+    if ( qfi_Dirty::isChanged( _slipSkid, _slipSkid_old, _maxSlipDeflection * _scaleX ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ADI::setTurnRate( double turnRate )
 {
+    if      ( turnRate < -1.0 ) turnRate = -1.0;
+    else if ( turnRate >  1.0 ) turnRate =  1.0;
+
     _turnRate = turnRate;
 
-    if      ( _turnRate < -1.0 ) _turnRate = -1.0;
-    else if ( _turnRate >  1.0 ) _turnRate =  1.0;
+    if ( qfi_Dirty::isChanged( _turnRate, _turnRate_old, _maxTurnDeflection * _scaleX ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ADI::setDots( double dotH, double dotV, bool visibleH, bool visibleV )
 {
-    _dotH = dotH;
-    _dotV = dotV;
+    if      ( dotH < -1.0 ) dotH = -1.0;
+    else if ( dotH >  1.0 ) dotH =  1.0;
 
-    if      ( _dotH < -1.0 ) _dotH = -1.0;
-    else if ( _dotH >  1.0 ) _dotH =  1.0;
+    if      ( dotV < -1.0 ) dotV = -1.0;
+    else if ( dotV >  1.0 ) dotV =  1.0;
 
-    if      ( _dotV < -1.0 ) _dotV = -1.0;
-    else if ( _dotV >  1.0 ) _dotV =  1.0;
+    if ( visibleH != _dotVisibleH || visibleV != _dotVisibleV )
+    {
+        _dirty = true;
+    }
+
+    _dotH = dotH;
+    _dotV = dotV;
 
     _dotVisibleH = visibleH;
     _dotVisibleV = visibleV;
+
+    if ( qfi_Dirty::isChanged( _dotH, _dotH_old, _maxDotsDeflection * _scaleX )
+      || qfi_Dirty::isChanged( _dotV, _dotV_old, _maxDotsDeflection * _scaleY ) )
+    {
+        _dirty = true;
+    }
 }
 
 
@@ -691,23 +933,40 @@ void qfi_EADI::ADI::setDots( double dotH, double dotV, bool visibleH, bool visib
 
 void qfi_EADI::ADI::setFD( double roll, double pitch, bool visible )
 {
-    _fdRoll  = roll;
-    _fdPitch = pitch;
+    if      ( roll < -180.0 ) roll = -180.0;
+    else if ( roll >  180.0 ) roll =  180.0;
+
+    if      ( pitch < -90.0 ) pitch = -90.0;
+    else if ( pitch >  90.0 ) pitch =  90.0;
+
+    double pxPerDeg = qfi_Dirty::pxPerDeg( _originalRadius * qMin( _scaleX, _scaleY ) );
 
-    if      ( _fdRoll < -180.0 ) _fdRoll = -180.0;
-    else if ( _fdRoll >  180.0 ) _fdRoll =  180.0;
+    if ( visible != _fdVisible )
+    {
+        _dirty = true;
+    }
 
-    if      ( _fdPitch < -90.0 ) _fdPitch = -90.0;
-    else if ( _fdPitch >  90.0 ) _fdPitch =  90.0;
+    _fdRoll  = roll;
+    _fdPitch = pitch;
 
     _fdVisible = visible;
+
+    if ( qfi_Dirty::isChanged( _fdRoll  , _fdRoll_old  , pxPerDeg )
+      || qfi_Dirty::isChanged( _fdPitch , _fdPitch_old , _originalPixPerDeg * _scaleY ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ADI::setStall( bool stall )
 {
-    _stall = stall;
+    if ( stall != _stall )
+    {
+        _stall = stall;
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -728,26 +987,6 @@ void qfi_EADI::ADI::reset()
     _itemFPM    = Q_NULLPTR;
     _itemFPMX   = Q_NULLPTR;
 
-    _roll     = 0.0;
-    _pitch    = 0.0;
-    _slipSkid = 0.0;
-    _turnRate = 0.0;
-    _dotH     = 0.0;
-    _dotV     = 0.0;
-    _fdRoll   = 0.0;
-    _fdPitch  = 0.0;
-    _angleOfAttack = 0.0;
-    _sideslipAngle = 0.0;
-
-    _fpmValid = false;
-
-    _fpmVisible   = false;
-    _dotVisibleH  = false;
-    _dotVisibleV  = false;
-    _fdVisible    = false;
-
-    _stall = false;
-
     _laddDeltaX_new     = 0.0;
     _laddDeltaX_old     = 0.0;
     _laddDeltaY_new     = 0.0;
@@ -778,6 +1017,8 @@ void qfi_EADI::ADI::reset()
     _fpmxDeltaX_old     = 0.0;
     _fpmxDeltaY_new     = 0.0;
     _fpmxDeltaY_old     = 0.0;
+
+    _dirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -994,6 +1235,9 @@ qfi_EADI::ALT::ALT( QGraphicsScene *scene ) :
     _pressure ( 0.0 ),
     _altitude_sel ( 0.0 ),
 
+    _altitude_old     ( 0.0 ),
+    _altitude_sel_old ( 0.0 ),
+
     _pressureMode ( qfi_EADI::PressureMode::STD ),
 
     _scale1DeltaY_new ( 0.0 ),
@@ -1007,6 +1251,8 @@ qfi_EADI::ALT::ALT( QGraphicsScene *scene ) :
     _bugDeltaY_new    ( 0.0 ),
     _bugDeltaY_old    ( 0.0 ),
 
+    _dirty ( true ),
+
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
 
@@ -1046,28 +1292,28 @@ void qfi_EADI::ALT::init( double scaleX, double scaleY )
 
     reset();
 
-    _itemBack = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_alt_back.svg" );
+    _itemBack = new qfi_CachedSvgItem( ":/qfi/images/eadi/eadi_alt_back.svg" );
     _itemBack->setCacheMode( QGraphicsItem::NoCache );
     _itemBack->setZValue( _backZ );
     _itemBack->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemBack->moveBy( _scaleX * _originalBackPos.x(), _scaleY * _originalBackPos.y() );
     _scene->addItem( _itemBack );
 
-    _itemScale1 = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_alt_scale.svg" );
+    _itemScale1 = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_alt_scale.svg" );
     _itemScale1->setCacheMode( QGraphicsItem::NoCache );
     _itemScale1->setZValue( _scaleZ );
     _itemScale1->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemScale1->moveBy( _scaleX * _originalScale1Pos.x(), _scaleY * _originalScale1Pos.y() );
     _scene->addItem( _itemScale1 );
 
-    _itemScale2 = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_alt_scale.svg" );
+    _itemScale2 = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_alt_scale.svg" );
     _itemScale2->setCacheMode( QGraphicsItem::NoCache );
     _itemScale2->setZValue( _scaleZ );
     _itemScale2->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemScale2->moveBy( _scaleX * _originalScale2Pos.x(), _scaleY * _originalScale2Pos.y() );
     _scene->addItem( _itemScale2 );
 
-    _itemLabel1 = new QGraphicsTextItem( QString( "99999" ) );
+    _itemLabel1 = new qfi_GlyphTextItem( QString( "99999" ) );
     _itemLabel1->setCacheMode( QGraphicsItem::NoCache );
     _itemLabel1->setZValue( _labelsZ );
     _itemLabel1->setDefaultTextColor( qfi_Colors::_white );
@@ -1077,7 +1323,7 @@ void qfi_EADI::ALT::init( double scaleX, double scaleY )
                          _scaleY * ( _originalLabel1Y - _itemLabel1->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemLabel1 );
 
-    _itemLabel2 = new QGraphicsTextItem( QString( "99999" ) );
+    _itemLabel2 = new qfi_GlyphTextItem( QString( "99999" ) );
     _itemLabel2->setCacheMode( QGraphicsItem::NoCache );
     _itemLabel2->setZValue( _labelsZ );
     _itemLabel2->setDefaultTextColor( qfi_Colors::_white );
@@ -1087,7 +1333,7 @@ void qfi_EADI::ALT::init( double scaleX, double scaleY )
                          _scaleY * ( _originalLabel2Y - _itemLabel2->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemLabel2 );
 
-    _itemLabel3 = new QGraphicsTextItem( QString( "99999" ) );
+    _itemLabel3 = new qfi_GlyphTextItem( QString( "99999" ) );
     _itemLabel3->setCacheMode( QGraphicsItem::NoCache );
     _itemLabel3->setZValue( _labelsZ );
     _itemLabel3->setDefaultTextColor( qfi_Colors::_white );
@@ -1097,28 +1343,28 @@ void qfi_EADI::ALT::init( double scaleX, double scaleY )
                          _scaleY * ( _originalLabel3Y - _itemLabel3->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemLabel3 );
 
-    _itemGround = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_alt_ground.svg" );
+    _itemGround = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_alt_ground.svg" );
     _itemGround->setCacheMode( QGraphicsItem::NoCache );
     _itemGround->setZValue( _groundZ );
     _itemGround->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemGround->moveBy( _scaleX * _originalGroundPos.x(), _scaleY * _originalGroundPos.y() );
     _scene->addItem( _itemGround );
 
-    _itemBugAlt = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_alt_bug.svg" );
+    _itemBugAlt = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_alt_bug.svg" );
     _itemBugAlt->setCacheMode( QGraphicsItem::NoCache );
     _itemBugAlt->setZValue( _altBugZ );
     _itemBugAlt->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemBugAlt->moveBy( _scaleX * _originalFramePos.x(), _scaleY * _originalFramePos.y() );
     _scene->addItem( _itemBugAlt );
 
-    _itemFrame = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_alt_frame.svg" );
+    _itemFrame = new qfi_CachedSvgItem( ":/qfi/images/eadi/eadi_alt_frame.svg" );
     _itemFrame->setCacheMode( QGraphicsItem::NoCache );
     _itemFrame->setZValue( _frameZ );
     _itemFrame->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemFrame->moveBy( _scaleX * _originalFramePos.x(), _scaleY * _originalFramePos.y() );
     _scene->addItem( _itemFrame );
 
-    _itemAltitude = new QGraphicsTextItem( QString( "    0" ) );
+    _itemAltitude = new qfi_GlyphTextItem( QString( "    0" ) );
     _itemAltitude->setCacheMode( QGraphicsItem::NoCache );
     _itemAltitude->setZValue( _frameTextZ );
     _itemAltitude->setDefaultTextColor( qfi_Colors::_white );
@@ -1128,7 +1374,7 @@ void qfi_EADI::ALT::init( double scaleX, double scaleY )
                            _scaleY * ( _originalAltitudeCtr.y() - _itemAltitude->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemAltitude );
 
-    _itemPressure = new QGraphicsTextItem( QString( "  STD  " ) );
+    _itemPressure = new qfi_GlyphTextItem( QString( "  STD  " ) );
     _itemPressure->setCacheMode( QGraphicsItem::NoCache );
     _itemPressure->setZValue( _frameTextZ );
     _itemPressure->setDefaultTextColor( qfi_Colors::_lime );
@@ -1138,7 +1384,7 @@ void qfi_EADI::ALT::init( double scaleX, double scaleY )
                            _scaleY * ( _originalPressureCtr.y() - _itemPressure->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemPressure );
 
-    _itemSetpoint = new QGraphicsTextItem( QString( "    0" ) );
+    _itemSetpoint = new qfi_GlyphTextItem( QString( "    0" ) );
     _itemSetpoint->setCacheMode( QGraphicsItem::NoCache );
     _itemSetpoint->setZValue( _frameTextZ );
     _itemSetpoint->setDefaultTextColor( qfi_Colors::_magenta );
@@ -1158,6 +1404,11 @@ void qfi_EADI::ALT::update( double scaleX, double scaleY )
     _scaleX = scaleX;
     _scaleY = scaleY;
 
+    if ( !_dirty )
+    {
+        return;
+    }
+
     updateAltitude();
     updatePressure();
 
@@ -1166,27 +1417,52 @@ void qfi_EADI::ALT::update( double scaleX, double scaleY )
     _groundDeltaY_old = _groundDeltaY_new;
     _labelsDeltaY_old = _labelsDeltaY_new;
     _bugDeltaY_old    = _bugDeltaY_new;
+
+    _altitude_old     = _altitude;
+    _altitude_sel_old = _altitude_sel;
+
+    _dirty = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ALT::setAltitude( double altitude )
 {
+    if      ( altitude <     0.0 ) altitude =     0.0;
+    else if ( altitude > 99999.0 ) altitude = 99999.0;
+
     _altitude = altitude;
 
-    if      ( _altitude <     0.0 ) _altitude =     0.0;
-    else if ( _altitude > 99999.0 ) _altitude = 99999.0;
+    if ( qfi_Dirty::isChanged( _altitude, _altitude_old, _originalPixPerAlt * _scaleY )
+      || qfi_Dirty::isReadoutChanged( _altitude, _altitude_old, 1.0 ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ALT::setPressure( double pressure, qfi_EADI::PressureMode pressureMode )
 {
-    _pressure = pressure;
+    if      ( pressure <    0.0 ) pressure =    0.0;
+    else if ( pressure > 2000.0 ) pressure = 2000.0;
+
+    // readout resolution, pressure is not displayed in STD mode
+    double resolution = ( pressureMode == qfi_EADI::PressureMode::IN ) ? 0.01 : 1.0;
+
+    bool changed = pressureMode != _pressureMode;
 
-    if      ( _pressure <    0.0 ) _pressure =    0.0;
-    else if ( _pressure > 2000.0 ) _pressure = 2000.0;
+    if ( !changed && pressureMode != qfi_EADI::PressureMode::STD )
+    {
+        changed = qfi_Dirty::isReadoutChanged( pressure, _pressure, resolution );
+    }
 
+    if ( changed )
+    {
+        _dirty = true;
+    }
+
+    _pressure     = pressure;
     _pressureMode = pressureMode;
 }
 
@@ -1194,10 +1470,16 @@ void qfi_EADI::ALT::setPressure( double pressure, qfi_EADI::PressureMode pressur
 
 void qfi_EADI::ALT::setAltitudeSel( double altitude )
 {
+    if      ( altitude <     0.0 ) altitude =     0.0;
+    else if ( altitude > 99999.0 ) altitude = 99999.0;
+
     _altitude_sel = altitude;
 
-    if      ( _altitude_sel <     0.0 ) _altitude_sel =     0.0;
-    else if ( _altitude_sel > 99999.0 ) _altitude_sel = 99999.0;
+    if ( qfi_Dirty::isChanged( _altitude_sel, _altitude_sel_old, _originalPixPerAlt * _scaleY )
+      || qfi_Dirty::isReadoutChanged( _altitude_sel, _altitude_sel_old, 1.0 ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1217,12 +1499,6 @@ void qfi_EADI::ALT::reset()
     _itemPressure = Q_NULLPTR;
     _itemSetpoint = Q_NULLPTR;
 
-    _altitude = 0.0;
-    _pressure = 0.0;
-    _altitude_sel = 0.0;
-
-    _pressureMode = qfi_EADI::PressureMode::STD;
-
     _scale1DeltaY_new = 0.0;
     _scale1DeltaY_old = 0.0;
     _scale2DeltaY_new = 0.0;
@@ -1233,14 +1509,16 @@ void qfi_EADI::ALT::reset()
     _labelsDeltaY_old = 0.0;
     _bugDeltaY_new    = 0.0;
     _bugDeltaY_old    = 0.0;
+
+    _dirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ALT::updateAltitude()
 {
-    _itemAltitude->setPlainText( QString("%1").arg(_altitude     , 5, 'f', 0, QChar(' ')) );
-    _itemSetpoint->setPlainText( QString("%1").arg(_altitude_sel , 5, 'f', 0, QChar(' ')) );
+    _itemAltitude->setNumber( _altitude, 5, 0, ' ' );
+    _itemSetpoint->setNumber( _altitude_sel, 5, 0, ' ' );
 
     updateScale();
     updateScaleLabels();
@@ -1253,15 +1531,15 @@ void qfi_EADI::ALT::updatePressure()
 {
     if ( _pressureMode == qfi_EADI::PressureMode::STD )
     {
-        _itemPressure->setPlainText( QString( "  STD  " ) );
+        _itemPressure->setText( "  STD  " );
     }
     else if ( _pressureMode == qfi_EADI::PressureMode::MB )
     {
-        _itemPressure->setPlainText( QString::number( _pressure, 'f', 0 ) + QString( " MB" ) );
+        _itemPressure->setNumber( _pressure, 0, 0, ' ', Q_NULLPTR, " MB" );
     }
     else if ( _pressureMode == qfi_EADI::PressureMode::IN )
     {
-        _itemPressure->setPlainText( QString::number( _pressure, 'f', 2 ) + QString( " IN" ) );
+        _itemPressure->setNumber( _pressure, 0, 2, ' ', Q_NULLPTR, " IN" );
     }
 }
 
@@ -1337,7 +1615,7 @@ void qfi_EADI::ALT::updateScaleLabels()
     if ( alt1 > 0.0 && alt1 <= 100000.0 )
     {
         _itemLabel1->setVisible( true );
-        _itemLabel1->setPlainText( QString("%1").arg(alt1, 5, 'f', 0, QChar(' ')) );
+        _itemLabel1->setNumber( alt1, 5, 0, ' ' );
     }
     else
     {
@@ -1347,7 +1625,7 @@ void qfi_EADI::ALT::updateScaleLabels()
     if ( alt2 > 0.0 && alt2 <= 100000.0 )
     {
         _itemLabel2->setVisible( true );
-        _itemLabel2->setPlainText( QString("%1").arg(alt2, 5, 'f', 0, QChar(' ')) );
+        _itemLabel2->setNumber( alt2, 5, 0, ' ' );
     }
     else
     {
@@ -1357,7 +1635,7 @@ void qfi_EADI::ALT::updateScaleLabels()
     if ( alt3 > 0.0 && alt3 <= 100000.0 )
     {
         _itemLabel3->setVisible( true );
-        _itemLabel3->setPlainText( QString("%1").arg(alt3, 5, 'f', 0, QChar(' ')) );
+        _itemLabel3->setNumber( alt3, 5, 0, ' ' );
     }
     else
     {
@@ -1399,6 +1677,11 @@ qfi_EADI::ASI::ASI( QGraphicsScene *scene ) :
     _vfe ( 0.0 ),
     _vne ( 0.0 ),
 
+    _airspeed_old     ( 0.0 ),
+    _airspeed_sel_old ( 0.0 ),
+    _vfe_old ( 0.0 ),
+    _vne_old ( 0.0 ),
+
     _scale1DeltaY_new ( 0.0 ),
     _scale1DeltaY_old ( 0.0 ),
     _scale2DeltaY_new ( 0.0 ),
@@ -1410,6 +1693,8 @@ qfi_EADI::ASI::ASI( QGraphicsScene *scene ) :
     _vneDeltaY_new    ( 0.0 ),
     _vneDeltaY_old    ( 0.0 ),
 
+    _dirty ( true ),
+
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
 
@@ -1455,28 +1740,28 @@ void qfi_EADI::ASI::init( double scaleX, double scaleY )
 
     reset();
 
-    _itemBack = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_asi_back.svg" );
+    _itemBack = new qfi_CachedSvgItem( ":/qfi/images/eadi/eadi_asi_back.svg" );
     _itemBack->setCacheMode( QGraphicsItem::NoCache );
     _itemBack->setZValue( _backZ );
     _itemBack->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemBack->moveBy( _scaleX * _originalBackPos.x(), _scaleY * _originalBackPos.y() );
     _scene->addItem( _itemBack );
 
-    _itemScale1 = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_asi_scale.svg" );
+    _itemScale1 = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_asi_scale.svg" );
     _itemScale1->setCacheMode( QGraphicsItem::NoCache );
     _itemScale1->setZValue( _scaleZ );
     _itemScale1->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemScale1->moveBy( _scaleX * _originalScale1Pos.x(), _scaleY * _originalScale1Pos.y() );
     _scene->addItem( _itemScale1 );
 
-    _itemScale2 = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_asi_scale.svg" );
+    _itemScale2 = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_asi_scale.svg" );
     _itemScale2->setCacheMode( QGraphicsItem::NoCache );
     _itemScale2->setZValue( _scaleZ );
     _itemScale2->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemScale2->moveBy( _scaleX * _originalScale2Pos.x(), _scaleY * _originalScale2Pos.y() );
     _scene->addItem( _itemScale2 );
 
-    _itemLabel1 = new QGraphicsTextItem( QString( "999" ) );
+    _itemLabel1 = new qfi_GlyphTextItem( QString( "999" ) );
     _itemLabel1->setCacheMode( QGraphicsItem::NoCache );
     _itemLabel1->setZValue( _labelsZ );
     _itemLabel1->setDefaultTextColor( qfi_Colors::_white );
@@ -1486,7 +1771,7 @@ void qfi_EADI::ASI::init( double scaleX, double scaleY )
                          _scaleY * ( _originalLabel1Y - _itemLabel1->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemLabel1 );
 
-    _itemLabel2 = new QGraphicsTextItem( QString( "999" ) );
+    _itemLabel2 = new qfi_GlyphTextItem( QString( "999" ) );
     _itemLabel2->setCacheMode( QGraphicsItem::NoCache );
     _itemLabel2->setZValue( _labelsZ );
     _itemLabel2->setDefaultTextColor( qfi_Colors::_white );
@@ -1496,7 +1781,7 @@ void qfi_EADI::ASI::init( double scaleX, double scaleY )
                          _scaleY * ( _originalLabel2Y - _itemLabel2->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemLabel2 );
 
-    _itemLabel3 = new QGraphicsTextItem( QString( "999" ) );
+    _itemLabel3 = new qfi_GlyphTextItem( QString( "999" ) );
     _itemLabel3->setCacheMode( QGraphicsItem::NoCache );
     _itemLabel3->setZValue( _labelsZ );
     _itemLabel3->setDefaultTextColor( qfi_Colors::_white );
@@ -1506,7 +1791,7 @@ void qfi_EADI::ASI::init( double scaleX, double scaleY )
                          _scaleY * ( _originalLabel3Y - _itemLabel3->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemLabel3 );
 
-    _itemLabel4 = new QGraphicsTextItem( QString( "999" ) );
+    _itemLabel4 = new qfi_GlyphTextItem( QString( "999" ) );
     _itemLabel4->setCacheMode( QGraphicsItem::NoCache );
     _itemLabel4->setZValue( _labelsZ );
     _itemLabel4->setDefaultTextColor( qfi_Colors::_white );
@@ -1516,7 +1801,7 @@ void qfi_EADI::ASI::init( double scaleX, double scaleY )
                          _scaleY * ( _originalLabel4Y - _itemLabel4->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemLabel4 );
 
-    _itemLabel5 = new QGraphicsTextItem( QString( "999" ) );
+    _itemLabel5 = new qfi_GlyphTextItem( QString( "999" ) );
     _itemLabel5->setCacheMode( QGraphicsItem::NoCache );
     _itemLabel5->setZValue( _labelsZ );
     _itemLabel5->setDefaultTextColor( qfi_Colors::_white );
@@ -1526,7 +1811,7 @@ void qfi_EADI::ASI::init( double scaleX, double scaleY )
                          _scaleY * ( _originalLabel5Y - _itemLabel5->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemLabel5 );
 
-    _itemLabel6 = new QGraphicsTextItem( QString( "999" ) );
+    _itemLabel6 = new qfi_GlyphTextItem( QString( "999" ) );
     _itemLabel6->setCacheMode( QGraphicsItem::NoCache );
     _itemLabel6->setZValue( _labelsZ );
     _itemLabel6->setDefaultTextColor( qfi_Colors::_white );
@@ -1536,7 +1821,7 @@ void qfi_EADI::ASI::init( double scaleX, double scaleY )
                          _scaleY * ( _originalLabel6Y - _itemLabel6->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemLabel6 );
 
-    _itemLabel7 = new QGraphicsTextItem( QString( "999" ) );
+    _itemLabel7 = new qfi_GlyphTextItem( QString( "999" ) );
     _itemLabel7->setCacheMode( QGraphicsItem::NoCache );
     _itemLabel7->setZValue( _labelsZ );
     _itemLabel7->setDefaultTextColor( qfi_Colors::_white );
@@ -1546,14 +1831,14 @@ void qfi_EADI::ASI::init( double scaleX, double scaleY )
                          _scaleY * ( _originalLabel7Y - _itemLabel7->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemLabel7 );
 
-    _itemBugIAS = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_asi_bug.svg" );
+    _itemBugIAS = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_asi_bug.svg" );
     _itemBugIAS->setCacheMode( QGraphicsItem::NoCache );
     _itemBugIAS->setZValue( _iasBugZ );
     _itemBugIAS->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemBugIAS->moveBy( _scaleX * _originalFramePos.x(), _scaleY * _originalFramePos.y() );
     _scene->addItem( _itemBugIAS );
 
-    _itemFrame = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_asi_frame.svg" );
+    _itemFrame = new qfi_CachedSvgItem( ":/qfi/images/eadi/eadi_asi_frame.svg" );
     _itemFrame->setCacheMode( QGraphicsItem::NoCache );
     _itemFrame->setZValue( _frameZ );
     _itemFrame->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -1567,17 +1852,16 @@ void qfi_EADI::ASI::init( double scaleX, double scaleY )
                                 _vfePen, _vfeBrush );
     _itemVfe->setZValue( _iasVfeZ );
 
-    _itemVne = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_asi_vne.svg" );
+    _itemVne = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_asi_vne.svg" );
     _itemVne->setCacheMode( QGraphicsItem::NoCache );
     _itemVne->setZValue( _iasVneZ );
     _itemVne->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemVne->moveBy( _scaleX * _originalScale1Pos.x(), _scaleY * _originalScale1Pos.y() );
     _scene->addItem( _itemVne );
 
-    _itemAirspeed = new QGraphicsTextItem( QString( "000" ) );
+    _itemAirspeed = new qfi_GlyphTextItem( QString( "000" ) );
     _itemAirspeed->setCacheMode( QGraphicsItem::NoCache );
     _itemAirspeed->setZValue( _frameTextZ );
-    _itemAirspeed->setTextInteractionFlags( Qt::NoTextInteraction );
     _itemAirspeed->setDefaultTextColor( qfi_Colors::_white );
     _itemAirspeed->setFont( qfi_Fonts::medium() );
     _itemAirspeed->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -1585,10 +1869,9 @@ void qfi_EADI::ASI::init( double scaleX, double scaleY )
                            _scaleY * ( _originalAirspeedCtr.y() - _itemAirspeed->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemAirspeed );
 
-    _itemMachNo = new QGraphicsTextItem( QString( ".000" ) );
+    _itemMachNo = new qfi_GlyphTextItem( QString( ".000" ) );
     _itemMachNo->setCacheMode( QGraphicsItem::NoCache );
     _itemMachNo->setZValue( _frameTextZ );
-    _itemMachNo->setTextInteractionFlags( Qt::NoTextInteraction );
     _itemMachNo->setDefaultTextColor( qfi_Colors::_white );
     _itemMachNo->setFont( qfi_Fonts::medium() );
     _itemMachNo->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -1596,10 +1879,9 @@ void qfi_EADI::ASI::init( double scaleX, double scaleY )
                          _scaleY * ( _originalMachNoCtr.y() - _itemMachNo->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemMachNo );
 
-    _itemSetpoint = new QGraphicsTextItem( QString( "000" ) );
+    _itemSetpoint = new qfi_GlyphTextItem( QString( "000" ) );
     _itemSetpoint->setCacheMode( QGraphicsItem::NoCache );
     _itemSetpoint->setZValue( _frameTextZ );
-    _itemSetpoint->setTextInteractionFlags( Qt::NoTextInteraction );
     _itemSetpoint->setDefaultTextColor( qfi_Colors::_magenta );
     _itemSetpoint->setFont( qfi_Fonts::medium() );
     _itemSetpoint->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -1617,6 +1899,11 @@ void qfi_EADI::ASI::update( double scaleX, double scaleY )
     _scaleX = scaleX;
     _scaleY = scaleY;
 
+    if ( !_dirty )
+    {
+        return;
+    }
+
     updateAirspeed();
 
     _scale1DeltaY_old = _scale1DeltaY_new;
@@ -1624,56 +1911,95 @@ void qfi_EADI::ASI::update( double scaleX, double scaleY )
     _labelsDeltaY_old = _labelsDeltaY_new;
     _bugDeltaY_old    = _bugDeltaY_new;
     _vneDeltaY_old    = _vneDeltaY_new;
+
+    _airspeed_old     = _airspeed;
+    _airspeed_sel_old = _airspeed_sel;
+    _vfe_old          = _vfe;
+    _vne_old          = _vne;
+
+    _dirty = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ASI::setAirspeed( double airspeed )
 {
+    if      ( airspeed <    0.0 ) airspeed =    0.0;
+    else if ( airspeed > 9999.0 ) airspeed = 9999.0;
+
     _airspeed = airspeed;
 
-    if      ( _airspeed <    0.0 ) _airspeed =    0.0;
-    else if ( _airspeed > 9999.0 ) _airspeed = 9999.0;
+    if ( qfi_Dirty::isChanged( _airspeed, _airspeed_old, _originalPixPerSpd * _scaleY )
+      || qfi_Dirty::isReadoutChanged( _airspeed, _airspeed_old, 1.0 ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ASI::setMachNo( double machNo )
 {
-    _machNo = machNo;
+    if      ( machNo <  0.0 ) machNo =  0.0;
+    else if ( machNo > 99.9 ) machNo = 99.9;
+
+    // finest readout resolution of both values
+    double resolution = ( qMin( machNo, _machNo ) < 1.0 ) ? 0.001 : 0.01;
+
+    // readouts are compared with the previous value only, if the readout
+    // did not change since the last value it equals the drawn one
+    if ( qfi_Dirty::isReadoutChanged( machNo, _machNo, resolution ) )
+    {
+        _dirty = true;
+    }
 
-    if      ( _machNo <  0.0 ) _machNo =  0.0;
-    else if ( _machNo > 99.9 ) _machNo = 99.9;
+    _machNo = machNo;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ASI::setAirspeedSel( double airspeed )
 {
+    if      ( airspeed < 0.0    ) airspeed = 0.0;
+    else if ( airspeed > 9999.0 ) airspeed = 9999.0;
+
     _airspeed_sel = airspeed;
 
-    if      ( _airspeed_sel < 0.0    ) _airspeed_sel = 0.0;
-    else if ( _airspeed_sel > 9999.0 ) _airspeed_sel = 9999.0;
+    if ( qfi_Dirty::isChanged( _airspeed_sel, _airspeed_sel_old, _originalPixPerSpd * _scaleY )
+      || qfi_Dirty::isReadoutChanged( _airspeed_sel, _airspeed_sel_old, 1.0 ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ASI::setVfe( double vfe )
 {
+    if      ( vfe < 0.0    ) vfe = 0.0;
+    else if ( vfe > 9999.0 ) vfe = 9999.0;
+
     _vfe = vfe;
 
-    if      ( _vfe < 0.0    ) _vfe = 0.0;
-    else if ( _vfe > 9999.0 ) _vfe = 9999.0;
+    if ( qfi_Dirty::isChanged( _vfe, _vfe_old, _originalPixPerSpd * _scaleY ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ASI::setVne( double vne )
 {
+    if      ( vne < 0.0    ) vne = 0.0;
+    else if ( vne > 9999.0 ) vne = 9999.0;
+
     _vne = vne;
 
-    if      ( _vne < 0.0    ) _vne = 0.0;
-    else if ( _vne > 9999.0 ) _vne = 9999.0;
+    if ( qfi_Dirty::isChanged( _vne, _vne_old, _originalPixPerSpd * _scaleY ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1698,11 +2024,6 @@ void qfi_EADI::ASI::reset()
     _itemMachNo   = Q_NULLPTR;
     _itemSetpoint = Q_NULLPTR;
 
-    _airspeed = 0.0;
-    _machNo   = 0.0;
-
-    _airspeed_sel = 0.0;
-
     _scale1DeltaY_new = 0.0;
     _scale1DeltaY_old = 0.0;
     _scale2DeltaY_new = 0.0;
@@ -1713,29 +2034,31 @@ void qfi_EADI::ASI::reset()
     _bugDeltaY_old    = 0.0;
     _vneDeltaY_new    = 0.0;
     _vneDeltaY_old    = 0.0;
+
+    _dirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::ASI::updateAirspeed()
 {
-    _itemAirspeed->setPlainText( QString("%1").arg(_airspeed     , 3, 'f', 0, QChar(' ')) );
-    _itemSetpoint->setPlainText( QString("%1").arg(_airspeed_sel , 3, 'f', 0, QChar(' ')) );
+    _itemAirspeed->setNumber( _airspeed, 3, 0, ' ' );
+    _itemSetpoint->setNumber( _airspeed_sel, 3, 0, ' ' );
 
     if ( _machNo < 1.0 )
     {
         double machNo = 1000.0 * _machNo;
-        _itemMachNo->setPlainText( QString(".%1").arg(machNo, 3, 'f', 0, QChar('0')) );
+        _itemMachNo->setNumber( machNo, 3, 0, '0', "." );
     }
     else
     {
         if ( _machNo < 10.0 )
         {
-            _itemMachNo->setPlainText( QString::number( _machNo, 'f', 2 ) );
+            _itemMachNo->setNumber( _machNo, 0, 2 );
         }
         else
         {
-            _itemMachNo->setPlainText( QString::number( _machNo, 'f', 1 ) );
+            _itemMachNo->setNumber( _machNo, 0, 1 );
         }
     }
 
@@ -1826,7 +2149,7 @@ void qfi_EADI::ASI::updateScaleLabels()
     if ( spd1 >= 0.0 && spd1 <= 10000.0 )
     {
         _itemLabel1->setVisible( true );
-        _itemLabel1->setPlainText( QString("%1").arg(spd1, 3, 'f', 0, QChar(' ')) );
+        _itemLabel1->setNumber( spd1, 3, 0, ' ' );
     }
     else
     {
@@ -1836,7 +2159,7 @@ void qfi_EADI::ASI::updateScaleLabels()
     if ( spd2 >= 0.0 && spd2 <= 10000.0 )
     {
         _itemLabel2->setVisible( true );
-        _itemLabel2->setPlainText( QString("%1").arg(spd2, 3, 'f', 0, QChar(' ')) );
+        _itemLabel2->setNumber( spd2, 3, 0, ' ' );
     }
     else
     {
@@ -1846,7 +2169,7 @@ void qfi_EADI::ASI::updateScaleLabels()
     if ( spd3 >= 0.0 && spd3 <= 10000.0 )
     {
         _itemLabel3->setVisible( true );
-        _itemLabel3->setPlainText( QString("%1").arg(spd3, 3, 'f', 0, QChar(' ')) );
+        _itemLabel3->setNumber( spd3, 3, 0, ' ' );
     }
     else
     {
@@ -1856,7 +2179,7 @@ void qfi_EADI::ASI::updateScaleLabels()
     if ( spd4 >= 0.0 && spd4 <= 10000.0 )
     {
         _itemLabel4->setVisible( true );
-        _itemLabel4->setPlainText( QString("%1").arg(spd4, 3, 'f', 0, QChar(' ')) );
+        _itemLabel4->setNumber( spd4, 3, 0, ' ' );
     }
     else
     {
@@ -1866,7 +2189,7 @@ void qfi_EADI::ASI::updateScaleLabels()
     if ( spd5 >= 0.0 && spd5 <= 10000.0 )
     {
         _itemLabel5->setVisible( true );
-        _itemLabel5->setPlainText( QString("%1").arg(spd5, 3, 'f', 0, QChar(' ')) );
+        _itemLabel5->setNumber( spd5, 3, 0, ' ' );
     }
     else
     {
@@ -1876,7 +2199,7 @@ void qfi_EADI::ASI::updateScaleLabels()
     if ( spd6 >= 0.0 && spd6 <= 10000.0 )
     {
         _itemLabel6->setVisible( true );
-        _itemLabel6->setPlainText( QString("%1").arg(spd6, 3, 'f', 0, QChar(' ')) );
+        _itemLabel6->setNumber( spd6, 3, 0, ' ' );
     }
     else
     {
@@ -1886,7 +2209,7 @@ void qfi_EADI::ASI::updateScaleLabels()
     if ( spd7 >= 0.0 && spd7 <= 10000.0 )
     {
         _itemLabel7->setVisible( true );
-        _itemLabel7->setPlainText( QString("%1").arg(spd7, 3, 'f', 0, QChar(' ')) );
+        _itemLabel7->setNumber( spd7, 3, 0, ' ' );
     }
     else
     {
@@ -1930,9 +2253,16 @@ qfi_EADI::HDG::HDG( QGraphicsScene *scene ) :
     _heading ( 0.0 ),
     _heading_sel ( 0.0 ),
 
+    _heading_old     ( 0.0 ),
+    _heading_sel_old ( 0.0 ),
+
+    _dirty ( true ),
+
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
 
+    _originalFaceRadius ( 110.0 ),
+
     _originalHsiCtr       ( 150.0 , 345.0 ),
     _originalBackPos      (   0.0,  210.0 ),
     _originalFacePos      (  38.0 , 233.0 ),
@@ -1957,14 +2287,14 @@ void qfi_EADI::HDG::init( double scaleX, double scaleY )
 
     reset();
 
-    _itemBack = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_hsi_back.svg" );
+    _itemBack = new qfi_CachedSvgItem( ":/qfi/images/eadi/eadi_hsi_back.svg" );
     _itemBack->setCacheMode( QGraphicsItem::NoCache );
     _itemBack->setZValue( _backZ );
     _itemBack->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemBack->moveBy( _scaleX * _originalBackPos.x(), _scaleY * _originalBackPos.y() );
     _scene->addItem( _itemBack );
 
-    _itemFace = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_hsi_face.svg" );
+    _itemFace = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_hsi_face.svg" );
     _itemFace->setCacheMode( QGraphicsItem::NoCache );
     _itemFace->setZValue( _faceZ );
     _itemFace->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -1972,7 +2302,7 @@ void qfi_EADI::HDG::init( double scaleX, double scaleY )
     _itemFace->moveBy( _scaleX * _originalFacePos.x(), _scaleY * _originalFacePos.y() );
     _scene->addItem( _itemFace );
 
-    _itemHdgBug = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_hsi_bug.svg" );
+    _itemHdgBug = qfi_Renderers::createItem( ":/qfi/images/eadi/eadi_hsi_bug.svg" );
     _itemHdgBug->setCacheMode( QGraphicsItem::NoCache );
     _itemHdgBug->setZValue( _hdgBugZ );
     _itemHdgBug->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -1980,17 +2310,16 @@ void qfi_EADI::HDG::init( double scaleX, double scaleY )
     _itemHdgBug->moveBy( _scaleX * _originalFacePos.x(), _scaleY * _originalFacePos.y() );
     _scene->addItem( _itemHdgBug );
 
-    _itemMarks = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_hsi_marks.svg" );
+    _itemMarks = new qfi_CachedSvgItem( ":/qfi/images/eadi/eadi_hsi_marks.svg" );
     _itemMarks->setCacheMode( QGraphicsItem::NoCache );
     _itemMarks->setZValue( _marksZ );
     _itemMarks->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemMarks->moveBy( _scaleX * _originalMarksPos.x(), _scaleY * _originalMarksPos.y() );
     _scene->addItem( _itemMarks );
 
-    _itemFrameText = new QGraphicsTextItem( QString( "000" ) );
+    _itemFrameText = new qfi_GlyphTextItem( QString( "000" ) );
     _itemFrameText->setCacheMode( QGraphicsItem::NoCache );
     _itemFrameText->setZValue( _frameTextZ );
-    _itemFrameText->setTextInteractionFlags( Qt::NoTextInteraction );
     _itemFrameText->setDefaultTextColor( qfi_Colors::_white );
     _itemFrameText->setFont( qfi_Fonts::medium() );
     _itemFrameText->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -2008,27 +2337,52 @@ void qfi_EADI::HDG::update( double scaleX, double scaleY )
     _scaleX = scaleX;
     _scaleY = scaleY;
 
+    if ( !_dirty )
+    {
+        return;
+    }
+
     updateHeading();
+
+    _heading_old     = _heading;
+    _heading_sel_old = _heading_sel;
+
+    _dirty = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::HDG::setHeading( double heading )
 {
+    heading = fmod( heading, 360.0 );
+    if ( heading < 0.0 ) heading += 360.0;
+
+    double pxPerDeg = qfi_Dirty::pxPerDeg( _originalFaceRadius * qMin( _scaleX, _scaleY ) );
+
     _heading = heading;
 
-    while ( _heading <   0.0 ) _heading += 360.0;
-    while ( _heading > 360.0 ) _heading -= 360.0;
+    if ( qfi_Dirty::isChanged( _heading, _heading_old, pxPerDeg )
+      || qfi_Dirty::isReadoutChanged( _heading, _heading_old, 1.0 ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::HDG::setHeadingSel( double heading )
 {
+    heading = fmod( heading, 360.0 );
+    if ( heading < 0.0 ) heading += 360.0;
+
+    double pxPerDeg = qfi_Dirty::pxPerDeg( _originalFaceRadius * qMin( _scaleX, _scaleY ) );
+
     _heading_sel = heading;
 
-    while ( _heading_sel <   0.0 ) _heading_sel += 360.0;
-    while ( _heading_sel > 360.0 ) _heading_sel -= 360.0;
+    if ( qfi_Dirty::isChanged( _heading_sel, _heading_sel_old, pxPerDeg ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2041,8 +2395,7 @@ void qfi_EADI::HDG::reset()
     _itemMarks     = Q_NULLPTR;
     _itemFrameText = Q_NULLPTR;
 
-    _heading = 0.0;
-    _heading_sel = 0.0;
+    _dirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2054,7 +2407,7 @@ void qfi_EADI::HDG::updateHeading()
 
     double fHeading = floor( _heading + 0.5 );
 
-    _itemFrameText->setPlainText( QString("%1").arg(fHeading, 3, 'f', 0, QChar('0')) );
+    _itemFrameText->setNumber( fHeading, 3, 0, '0' );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2066,6 +2419,9 @@ qfi_EADI::VSI::VSI( QGraphicsScene *scene ) :
     _itemMarker ( Q_NULLPTR ),
 
     _climbRate ( 0.0 ),
+    _climbRate_old ( 0.0 ),
+
+    _dirty ( true ),
 
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
@@ -2096,7 +2452,7 @@ void qfi_EADI::VSI::init( double scaleX, double scaleY )
 
     reset();
 
-    _itemScale = new QGraphicsSvgItem( ":/qfi/images/eadi/eadi_vsi_scale.svg" );
+    _itemScale = new qfi_CachedSvgItem( ":/qfi/images/eadi/eadi_vsi_scale.svg" );
     _itemScale->setCacheMode( QGraphicsItem::NoCache );
     _itemScale->setZValue( _scaleZ );
     _itemScale->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -2120,17 +2476,31 @@ void qfi_EADI::VSI::update( double scaleX, double scaleY )
     _scaleX = scaleX;
     _scaleY = scaleY;
 
+    if ( !_dirty )
+    {
+        return;
+    }
+
     updateVSI();
+
+    _climbRate_old = _climbRate;
+
+    _dirty = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EADI::VSI::setClimbRate( double climbRate )
 {
+    if      ( climbRate >  6.8 ) climbRate =  6.8;
+    else if ( climbRate < -6.8 ) climbRate = -6.8;
+
     _climbRate = climbRate;
 
-    if      ( _climbRate >  6.8 ) _climbRate =  6.8;
-    else if ( _climbRate < -6.8 ) _climbRate = -6.8;
+    if ( qfi_Dirty::isChanged( _climbRate, _climbRate_old, _originalPixPerSpd1 * _scaleY ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2138,7 +2508,8 @@ void qfi_EADI::VSI::setClimbRate( double climbRate )
 void qfi_EADI::VSI::reset()
 {
     _itemScale = Q_NULLPTR;
-    _climbRate = 0.0;
+
+    _dirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
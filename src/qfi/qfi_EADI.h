@@ -27,8 +27,15 @@
 #include <QGraphicsView>
 #include <QGraphicsRectItem>
 #include <QGraphicsSvgItem>
+#include <QImage>
+#include <QTimer>
+
+#include <functional>
 
 #include <qfi/qfi_defs.h>
+#include <qfi/qfi_Dirty.h>
+#include <qfi/qfi_GlyphTextItem.h>
+#include <qfi/qfi_TripleBuffer.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -89,6 +96,58 @@ public:
         IN          ///< inches of mercury
     };
 
+    /**
+     * Instrument state, applied at once with setState(). Plain data
+     * structure, it can be copied between threads with memcpy().
+     */
+    struct State
+    {
+        FltMode fltMode;           ///< flight mode
+        SpdMode spdMode;           ///< speed mode
+        LNAV lnav;                 ///< lateral navigation mode
+        VNAV vnav;                 ///< vertical navigation mode
+        PressureMode pressureMode; ///< pressure unit
+
+        double roll;               ///< [deg] roll angle
+        double pitch;              ///< [deg] pitch angle
+        double aoa;                ///< [deg] angle of attack
+        double sideslip;           ///< [deg] angle of sideslip
+        double slipSkid;           ///< normalized slip or skid (range from -1.0 to 1.0)
+        double turnRate;           ///< normalized turn rate (range from -1.0 to 1.0)
+        double dotH;               ///< normalized horizontal deviation dot position
+        double dotV;               ///< normalized vertical deviation dot position
+        double fdRoll;             ///< [deg] FD roll angle
+        double fdPitch;            ///< [deg] FD pitch angle
+        double altitude;           ///< altitude (dimensionless numeric value)
+        double pressure;           ///< pressure (dimensionless numeric value)
+        double airspeed;           ///< airspeed (dimensionless numeric value)
+        double machNo;             ///< Mach number
+        double heading;            ///< [deg] heading
+        double climbRate;          ///< climb rate (dimensionless numeric value)
+        double airspeedSel;        ///< selected airspeed (dimensionless numeric value)
+        double altitudeSel;        ///< selected altitude (dimensionless numeric value)
+        double headingSel;         ///< [deg] selected heading
+        double vfe;                ///< vfe (dimensionless numeric value)
+        double vne;                ///< vne (dimensionless numeric value)
+
+        bool fpmVisible;           ///< flight path marker visibility
+        bool dotVisibleH;          ///< horizontal deviation dot visibility
+        bool dotVisibleV;          ///< vertical deviation dot visibility
+        bool fdVisible;            ///< FD visibility
+        bool stall;                ///< stall flag
+
+        /**
+         * Interpolates (ratio from 0.0 to 1.0) or extrapolates (ratio greater
+         * than 1.0) between states, see qfi_StateHistory. Discrete values
+         * (flags, modes) are taken from the nearer state.
+         * @param s0 first state
+         * @param s1 second state
+         * @param ratio interpolation ratio
+         * @param result output state
+         */
+        static void interpolate( const State &s0, const State &s1, double ratio, State *result );
+    };
+
     /** @brief Constructor. */
     explicit qfi_EADI( QWidget *parent = Q_NULLPTR );
 
@@ -101,28 +160,52 @@ public:
     /** Refreshes (redraws) widget. */
     void redraw();
 
+    /**
+     * Renders widget into the image, also when the widget is not shown
+     * (e.g. with the offscreen platform plugin). Hidden widget is resized
+     * to the image size, image itself is never reallocated.
+     * @param image target image
+     */
+    void renderImage( QImage &image );
+
     /** Sets flight mode. */
     inline void setFltMode( FltMode fltMode )
     {
-        _fltMode = fltMode;
+        if ( fltMode != _fltMode )
+        {
+            _fltMode = fltMode;
+            _dirty = true;
+        }
     }
 
     /** Sets speed mode. */
     inline void setSpdMode( SpdMode spdMode )
     {
-        _spdMode = spdMode;
+        if ( spdMode != _spdMode )
+        {
+            _spdMode = spdMode;
+            _dirty = true;
+        }
     }
 
     /** */
     inline void setLNAV( LNAV lnav )
     {
-        _lnav = lnav;
+        if ( lnav != _lnav )
+        {
+            _lnav = lnav;
+            _dirty = true;
+        }
     }
 
     /** */
     inline void setVNAV( VNAV vnav )
     {
-        _vnav = vnav;
+        if ( vnav != _vnav )
+        {
+            _vnav = vnav;
+            _dirty = true;
+        }
     }
 
     /** @param roll angle [deg] */
@@ -253,6 +336,30 @@ public:
         _asi->setVne( vne );
     }
 
+    /**
+     * Applies all values of the state at once, only the visibly changed ones
+     * mark the instrument dirty.
+     * @param state instrument state
+     */
+    void setState( const State &state );
+
+    /**
+     * Other threads (e.g. simulation) may publish state into this buffer
+     * without blocking, the newest state is applied on redraw.
+     * @return state buffer
+     */
+    inline qfi_TripleBuffer< State >& stateBuffer() { return _stateBuffer; }
+
+    /**
+     * Sets function called with every state passed to setState(), also with
+     * states taken from stateBuffer(), e.g. by qfi_Recorder.
+     * @param hook state hook, empty function removes hook
+     */
+    inline void setStateHook( const std::function< void( const State& ) > &hook ) { _stateHook = hook; }
+
+    /** @return number of redraws skipped because nothing has changed */
+    inline qint64 suppressedRedraws() const { return _suppressedRedraws; }
+
 protected:
 
     /** */
@@ -267,6 +374,7 @@ private:
     class VSI;
 
     QGraphicsScene *_scene;                 ///< graphics scene
+    QTimer *_resizeTimer;                   ///< debounces rebuilding the scene after resizing
 
     qfi_EADI::ADI *_adi;                    ///<
     qfi_EADI::ALT *_alt;                    ///<
@@ -277,14 +385,14 @@ private:
     QGraphicsSvgItem *_itemBack;            ///< PFD background
     QGraphicsSvgItem *_itemMask;            ///< PFD mask
 
-    QGraphicsTextItem *_itemFMA;            ///< FMA (Flight Mode Annunciator)
-    QGraphicsTextItem *_itemSPD;
+    qfi_GlyphTextItem *_itemFMA;            ///< FMA (Flight Mode Annunciator)
+    qfi_GlyphTextItem *_itemSPD;
 
-    QGraphicsTextItem *_itemLNAV;           ///< LNAV (Lateral Navigation Mode)
-    QGraphicsTextItem *_itemVNAV;           ///< VNAV (Vertical Navigation Mode)
+    qfi_GlyphTextItem *_itemLNAV;           ///< LNAV (Lateral Navigation Mode)
+    qfi_GlyphTextItem *_itemVNAV;           ///< VNAV (Vertical Navigation Mode)
 
-    QGraphicsTextItem *_itemLNAV_ARM;       ///< LNAV (Lateral Navigation Mode)
-    QGraphicsTextItem *_itemVNAV_ARM;       ///< VNAV (Vertical Navigation Mode)
+    qfi_GlyphTextItem *_itemLNAV_ARM;       ///< LNAV (Lateral Navigation Mode)
+    qfi_GlyphTextItem *_itemVNAV_ARM;       ///< VNAV (Vertical Navigation Mode)
 
     FltMode _fltMode;                       ///< flight mode
     SpdMode _spdMode;                       ///< speed mode
@@ -292,6 +400,14 @@ private:
     LNAV _lnav;                             ///<
     VNAV _vnav;                             ///<
 
+    bool _dirty;                            ///< flight mode annunciators need update
+
+    qint64 _suppressedRedraws;              ///<
+
+    qfi_TripleBuffer< State > _stateBuffer; ///< state published by other threads
+
+    std::function< void( const State& ) > _stateHook; ///< state hook
+
     double _scaleX;                         ///<
     double _scaleY;                         ///<
 
@@ -315,8 +431,13 @@ private:
 
     void reset();
 
+    /** Scales the view to the current size until the scene is rebuilt. */
+    void rescale();
+
     void updateView();
 
+    void updateModes();
+
     /** Attitude Director Indicator */
     class ADI
     {
@@ -326,6 +447,9 @@ private:
         void init( double scaleX, double scaleY );
         void update( double scaleX, double scaleY );
 
+        inline bool isDirty() const { return _dirty; }
+        inline void setDirty() { _dirty = true; }
+
         void setRoll( double roll );
         void setPitch( double pitch );
         void setFPM( double aoa, double sideslip, bool visible = true );
@@ -365,6 +489,17 @@ private:
         double _angleOfAttack;              ///< [deg]
         double _sideslipAngle;              ///< [deg]
 
+        double _roll_old;                   ///< [deg] roll angle currently drawn
+        double _pitch_old;                  ///< [deg] pitch angle currently drawn
+        double _slipSkid_old;               ///< slip or skid currently drawn
+        double _turnRate_old;               ///< turn rate currently drawn
+        double _dotH_old;                   ///< horizontal dot position currently drawn
+        double _dotV_old;                   ///< vertical dot position currently drawn
+        double _fdRoll_old;                 ///< [deg] FD roll angle currently drawn
+        double _fdPitch_old;                ///< [deg] FD pitch angle currently drawn
+        double _angleOfAttack_old;          ///< [deg] angle of attack currently drawn
+        double _sideslipAngle_old;          ///< [deg] angle of sideslip currently drawn
+
         bool _fpmValid;                     ///<
 
         bool _fpmVisible;                   ///<
@@ -405,6 +540,8 @@ private:
         double _fpmxDeltaY_new;             ///<
         double _fpmxDeltaY_old;             ///<
 
+        bool _dirty;                        ///<
+
         double _scaleX;                     ///<
         double _scaleY;                     ///<
 
@@ -414,6 +551,7 @@ private:
         const double _maxSlipDeflection;    ///< [px] max slip indicator deflection
         const double _maxTurnDeflection;    ///< [px] max turn indicator deflection
         const double _maxDotsDeflection;    ///<
+        const double _originalRadius;       ///< [px] radius of visible attitude sphere
 
         QPointF _originalAdiCtr;            ///<
         QPointF _originalBackPos;           ///<
@@ -463,6 +601,9 @@ private:
         void init( double scaleX, double scaleY );
         void update( double scaleX, double scaleY );
 
+        inline bool isDirty() const { return _dirty; }
+        inline void setDirty() { _dirty = true; }
+
         void setAltitude( double altitude );
         void setPressure( double pressure, qfi_EADI::PressureMode pressureMode );
         void setAltitudeSel( double altitude );
@@ -474,20 +615,23 @@ private:
         QGraphicsSvgItem  *_itemBack;       ///<
         QGraphicsSvgItem  *_itemScale1;     ///<
         QGraphicsSvgItem  *_itemScale2;     ///<
-        QGraphicsTextItem *_itemLabel1;     ///<
-        QGraphicsTextItem *_itemLabel2;     ///<
-        QGraphicsTextItem *_itemLabel3;     ///<
+        qfi_GlyphTextItem *_itemLabel1;     ///<
+        qfi_GlyphTextItem *_itemLabel2;     ///<
+        qfi_GlyphTextItem *_itemLabel3;     ///<
         QGraphicsSvgItem  *_itemGround;     ///<
         QGraphicsSvgItem  *_itemBugAlt;     ///<
         QGraphicsSvgItem  *_itemFrame;      ///<
-        QGraphicsTextItem *_itemAltitude;   ///<
-        QGraphicsTextItem *_itemPressure;   ///<
-        QGraphicsTextItem *_itemSetpoint;   ///<
+        qfi_GlyphTextItem *_itemAltitude;   ///<
+        qfi_GlyphTextItem *_itemPressure;   ///<
+        qfi_GlyphTextItem *_itemSetpoint;   ///<
 
         double _altitude;                   ///<
         double _pressure;                   ///<
         double _altitude_sel;               ///<
 
+        double _altitude_old;               ///< altitude currently drawn
+        double _altitude_sel_old;           ///< selected altitude currently drawn
+
         qfi_EADI::PressureMode _pressureMode;
 
         double _scale1DeltaY_new;           ///<
@@ -501,6 +645,8 @@ private:
         double _bugDeltaY_new;              ///<
         double _bugDeltaY_old;              ///<
 
+        bool _dirty;                        ///<
+
         double _scaleX;                     ///<
         double _scaleY;                     ///<
 
@@ -546,6 +692,9 @@ private:
         void init( double scaleX, double scaleY );
         void update( double scaleX, double scaleY );
 
+        inline bool isDirty() const { return _dirty; }
+        inline void setDirty() { _dirty = true; }
+
         void setAirspeed( double airspeed );
         void setMachNo( double machNo );
         void setAirspeedSel( double airspeed );
@@ -559,20 +708,20 @@ private:
         QGraphicsSvgItem  *_itemBack;       ///<
         QGraphicsSvgItem  *_itemScale1;     ///<
         QGraphicsSvgItem  *_itemScale2;     ///<
-        QGraphicsTextItem *_itemLabel1;     ///<
-        QGraphicsTextItem *_itemLabel2;     ///<
-        QGraphicsTextItem *_itemLabel3;     ///<
-        QGraphicsTextItem *_itemLabel4;     ///<
-        QGraphicsTextItem *_itemLabel5;     ///<
-        QGraphicsTextItem *_itemLabel6;     ///<
-        QGraphicsTextItem *_itemLabel7;     ///<
+        qfi_GlyphTextItem *_itemLabel1;     ///<
+        qfi_GlyphTextItem *_itemLabel2;     ///<
+        qfi_GlyphTextItem *_itemLabel3;     ///<
+        qfi_GlyphTextItem *_itemLabel4;     ///<
+        qfi_GlyphTextItem *_itemLabel5;     ///<
+        qfi_GlyphTextItem *_itemLabel6;     ///<
+        qfi_GlyphTextItem *_itemLabel7;     ///<
         QGraphicsSvgItem  *_itemBugIAS;     ///<
         QGraphicsSvgItem  *_itemFrame;      ///<
         QGraphicsRectItem *_itemVfe;        ///<
         QGraphicsSvgItem  *_itemVne;        ///<
-        QGraphicsTextItem *_itemAirspeed;   ///<
-        QGraphicsTextItem *_itemMachNo;     ///<
-        QGraphicsTextItem *_itemSetpoint;   ///<
+        qfi_GlyphTextItem *_itemAirspeed;   ///<
+        qfi_GlyphTextItem *_itemMachNo;     ///<
+        qfi_GlyphTextItem *_itemSetpoint;   ///<
 
         QBrush _vfeBrush;                   ///<
         QPen _vfePen;                       ///<
@@ -583,6 +732,11 @@ private:
         double _vfe;                        ///<
         double _vne;                        ///<
 
+        double _airspeed_old;               ///< airspeed currently drawn
+        double _airspeed_sel_old;           ///< selected airspeed currently drawn
+        double _vfe_old;                    ///< Vfe currently drawn
+        double _vne_old;                    ///< Vne currently drawn
+
         double _scale1DeltaY_new;           ///<
         double _scale1DeltaY_old;           ///<
         double _scale2DeltaY_new;           ///<
@@ -594,6 +748,8 @@ private:
         double _vneDeltaY_new;              ///<
         double _vneDeltaY_old;              ///<
 
+        bool _dirty;                        ///<
+
         double _scaleX;                     ///<
         double _scaleY;                     ///<
 
@@ -646,6 +802,9 @@ private:
         void init( double scaleX, double scaleY );
         void update( double scaleX, double scaleY );
 
+        inline bool isDirty() const { return _dirty; }
+        inline void setDirty() { _dirty = true; }
+
         void setHeading( double heading );
         void setHeadingSel( double heading );
 
@@ -657,14 +816,21 @@ private:
         QGraphicsSvgItem  *_itemFace;       ///< heading face
         QGraphicsSvgItem  *_itemHdgBug;     ///<
         QGraphicsSvgItem  *_itemMarks;      ///< HSI markings
-        QGraphicsTextItem *_itemFrameText;  ///<
+        qfi_GlyphTextItem *_itemFrameText;  ///<
 
         double _heading;                    ///< [deg]
         double _heading_sel;                ///< [deg]
 
+        double _heading_old;                ///< [deg] heading currently drawn
+        double _heading_sel_old;            ///< [deg] selected heading currently drawn
+
+        bool _dirty;                        ///<
+
         double _scaleX;                     ///<
         double _scaleY;                     ///<
 
+        const double _originalFaceRadius;   ///< [px]
+
         QPointF _originalHsiCtr;            ///<
         QPointF _originalBackPos;           ///<
         QPointF _originalFacePos;           ///<
@@ -692,6 +858,9 @@ private:
         void init( double scaleX, double scaleY );
         void update( double scaleX, double scaleY );
 
+        inline bool isDirty() const { return _dirty; }
+        inline void setDirty() { _dirty = true; }
+
         void setClimbRate( double climbRate );
 
     private:
@@ -702,6 +871,9 @@ private:
         QGraphicsRectItem *_itemMarker;     ///<
 
         double _climbRate;                  ///<
+        double _climbRate_old;              ///< climb rate currently drawn
+
+        bool _dirty;                        ///<
 
         double _scaleX;                     ///<
         double _scaleY;                     ///<
@@ -29,8 +29,16 @@
 #include <cmath>
 #include <cstdio>
 
+#include <qfi/qfi_Cache.h>
+#include <qfi/qfi_CachedSvgItem.h>
 #include <qfi/qfi_Colors.h>
 #include <qfi/qfi_Fonts.h>
+#include <qfi/qfi_Interpolation.h>
+#include <qfi/qfi_Latency.h>
+#include <qfi/qfi_Offscreen.h>
+#include <qfi/qfi_Profiler.h>
+#include <qfi/qfi_Renderers.h>
+#include <qfi/qfi_Trace.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -39,6 +47,8 @@ qfi_EHSI::qfi_EHSI( QWidget *parent ) :
 
     _scene ( Q_NULLPTR ),
 
+    _resizeTimer ( Q_NULLPTR ),
+
     _itemBack ( Q_NULLPTR ),
     _itemMask ( Q_NULLPTR ),
     _itemMark ( Q_NULLPTR ),
@@ -64,6 +74,13 @@ qfi_EHSI::qfi_EHSI( QWidget *parent ) :
 
     _heading_sel ( 0.0 ),
 
+    _heading_old     ( 0.0 ),
+    _course_old      ( 0.0 ),
+    _bearing_old     ( 0.0 ),
+    _deviation_old   ( 0.0 ),
+    _distance_old    ( 0.0 ),
+    _heading_sel_old ( 0.0 ),
+
     _cdi ( CDI::Off ),
 
     _bearingVisible   ( true ),
@@ -74,11 +91,19 @@ qfi_EHSI::qfi_EHSI( QWidget *parent ) :
     _devBarDeltaY_new ( 0.0 ),
     _devBarDeltaY_old ( 0.0 ),
 
+    _navDirty  ( true ),
+    _textDirty ( true ),
+
+    _suppressedRedraws ( 0 ),
+
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
 
     _originalPixPerDev ( 52.5 ),
 
+    _originalScaleRadius ( 131.0 ),
+    _originalArrowRadius ( 104.0 ),
+
     _originalNavCtr ( 150.0, 150.0 ),
 
     _originalCrsTextCtr ( 250.0,  25.0 ),
@@ -107,6 +132,11 @@ qfi_EHSI::qfi_EHSI( QWidget *parent ) :
     _scene = new QGraphicsScene( this );
     setScene( _scene );
 
+    _resizeTimer = new QTimer( this );
+    _resizeTimer->setSingleShot( true );
+    _resizeTimer->setInterval( 200 );
+    connect( _resizeTimer, &QTimer::timeout, this, &qfi_EHSI::reinit );
+
     _scene->clear();
 
     init();
@@ -132,6 +162,10 @@ void qfi_EHSI::reinit()
 {
     if ( _scene )
     {
+        _resizeTimer->stop();
+
+        resetTransform();
+
         _scene->clear();
 
         init();
@@ -144,71 +178,197 @@ void qfi_EHSI::redraw()
 {
     if ( isVisible() )
     {
-        updateView();
+        State state;
 
-        _devBarDeltaX_old = _devBarDeltaX_new;
-        _devBarDeltaY_old = _devBarDeltaY_new;
+        if ( _stateBuffer.consume( &state ) ) setState( state );
+
+        if ( _navDirty || _textDirty )
+        {
+            updateView();
+        }
+        else
+        {
+            _suppressedRedraws++;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_EHSI::renderImage( QImage &image )
+{
+    QSize size = qfi_Offscreen::size( image );
+
+    if ( size.isEmpty() ) return;
+
+    State state;
+
+    if ( _stateBuffer.consume( &state ) ) setState( state );
+
+    if ( !isVisible() && size != this->size() )
+    {
+        resize( size );
+        reinit();
+    }
+
+    if ( _navDirty || _textDirty )
+    {
+        updateView();
     }
+
+    qfi_Offscreen::render( _scene,
+                           QRectF( 0.0, 0.0, _scaleX * _originalWidth, _scaleY * _originalHeight ),
+                           image, renderHints() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_EHSI::setState( const State &state )
+{
+    if ( _stateHook ) _stateHook( state );
+
+    setHeading    ( state.heading );
+    setCourse     ( state.course );
+    setBearing    ( state.bearing, state.bearingVisible );
+    setDeviation  ( state.deviation, state.cdi );
+    setDistance   ( state.distance, state.distanceVisible );
+    setHeadingSel ( state.headingSel );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_EHSI::State::interpolate( const State &s0, const State &s1, double ratio, State *result )
+{
+    *result = ( ratio < 0.5 ) ? s0 : s1;
+
+    result->heading    = qfi_Interpolation::angle ( s0.heading, s1.heading, ratio );
+    result->course     = qfi_Interpolation::angle ( s0.course, s1.course, ratio );
+    result->bearing    = qfi_Interpolation::angle ( s0.bearing, s1.bearing, ratio );
+    result->deviation  = qfi_Interpolation::linear( s0.deviation, s1.deviation, ratio );
+    result->distance   = qfi_Interpolation::linear( s0.distance, s1.distance, ratio );
+    result->headingSel = qfi_Interpolation::angle ( s0.headingSel, s1.headingSel, ratio );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EHSI::setHeading( double heading )
 {
+    heading = fmod( heading, 360.0 );
+    if ( heading < 0.0 ) heading += 360.0;
+
+    // heading rotates everything, the scale has the largest radius
+    double pxPerDeg = qfi_Dirty::pxPerDeg( _originalScaleRadius * qMin( _scaleX, _scaleY ) );
+
     _heading = heading;
 
-    while ( _heading <   0.0 ) _heading += 360.0;
-    while ( _heading > 360.0 ) _heading -= 360.0;
+    if ( qfi_Dirty::isChanged( _heading, _heading_old, pxPerDeg ) )
+    {
+        _navDirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EHSI::setCourse( double course )
 {
+    course = fmod( course, 360.0 );
+    if ( course < 0.0 ) course += 360.0;
+
+    double pxPerDeg = qfi_Dirty::pxPerDeg( _originalArrowRadius * qMin( _scaleX, _scaleY ) );
+
     _course = course;
 
-    while ( _course <   0.0 ) _course += 360.0;
-    while ( _course > 360.0 ) _course -= 360.0;
+    bool changed = qfi_Dirty::isChanged( _course, _course_old, pxPerDeg );
+    bool readout = qfi_Dirty::isReadoutChanged( _course, _course_old, 1.0 );
+
+    // arrow is updated along with the readout, so both are compared
+    // with the same drawn value
+    _navDirty  = _navDirty  || changed || readout;
+    _textDirty = _textDirty || readout;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EHSI::setBearing( double bearing, bool visible )
 {
+    bearing = fmod( bearing, 360.0 );
+    if ( bearing < 0.0 ) bearing += 360.0;
+
+    double pxPerDeg = qfi_Dirty::pxPerDeg( _originalArrowRadius * qMin( _scaleX, _scaleY ) );
+
+    if ( visible != _bearingVisible )
+    {
+        _navDirty = true;
+    }
+
     _bearing        = bearing;
     _bearingVisible = visible;
 
-    while ( _bearing <   0.0 ) _bearing += 360.0;
-    while ( _bearing > 360.0 ) _bearing -= 360.0;
+    if ( qfi_Dirty::isChanged( _bearing, _bearing_old, pxPerDeg ) )
+    {
+        _navDirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EHSI::setDeviation( double deviation, CDI cdi )
 {
+    if ( deviation < -1.0 ) deviation = -1.0;
+    if ( deviation >  1.0 ) deviation =  1.0;
+
+    double pxPerDev = _originalPixPerDev * qMin( _scaleX, _scaleY );
+
+    if ( cdi != _cdi )
+    {
+        _navDirty = true;
+    }
+
     _deviation = deviation;
-    _cdi = cdi;
+    _cdi       = cdi;
 
-    if ( _deviation < -1.0 ) _deviation = -1.0;
-    if ( _deviation >  1.0 ) _deviation =  1.0;
+    if ( qfi_Dirty::isChanged( _deviation, _deviation_old, pxPerDev ) )
+    {
+        _navDirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EHSI::setDistance( double distance, bool visible )
 {
-    _distance        = fabs( distance );
+    distance = fabs( distance );
+
+    if ( visible != _distanceVisible )
+    {
+        _textDirty = true;
+    }
+
+    _distance        = distance;
     _distanceVisible = visible;
+
+    if ( qfi_Dirty::isReadoutChanged( _distance, _distance_old, 0.1 ) )
+    {
+        _textDirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EHSI::setHeadingSel( double heading )
 {
+    heading = fmod( heading, 360.0 );
+    if ( heading < 0.0 ) heading += 360.0;
+
+    double pxPerDeg = qfi_Dirty::pxPerDeg( _originalArrowRadius * qMin( _scaleX, _scaleY ) );
+
     _heading_sel = heading;
 
-    while ( _heading_sel <   0.0 ) _heading_sel += 360.0;
-    while ( _heading_sel > 360.0 ) _heading_sel -= 360.0;
+    bool changed = qfi_Dirty::isChanged( _heading_sel, _heading_sel_old, pxPerDeg );
+    bool readout = qfi_Dirty::isReadoutChanged( _heading_sel, _heading_sel_old, 1.0 );
+
+    _navDirty  = _navDirty  || changed || readout;
+    _textDirty = _textDirty || readout;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -219,7 +379,33 @@ void qfi_EHSI::resizeEvent( QResizeEvent *event )
     QGraphicsView::resizeEvent( event );
     ////////////////////////////////////
 
-    reinit();
+    if ( isVisible() && _itemBack )
+    {
+        rescale();
+    }
+    else
+    {
+        reinit();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_EHSI::rescale()
+{
+    // items and their state are kept, the scene is rebuilt at the new scale
+    // once the size settles
+    setTransform( QTransform::fromScale( width()  / ( _scaleX * _originalWidth  ),
+                                         height() / ( _scaleY * _originalHeight ) ) );
+
+    centerOn( _scaleX * _originalWidth / 2.0 , _scaleY * _originalHeight / 2.0 );
+
+    // changes too small to be visible at the previous size may be visible now
+    _navDirty = true;
+
+    qfi_Cache::deferRebuilds( _resizeTimer->interval() );
+
+    _resizeTimer->start();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -231,74 +417,74 @@ void qfi_EHSI::init()
 
     reset();
 
-    _itemBack = new QGraphicsSvgItem( ":/qfi/images/ehsi/ehsi_back.svg" );
+    _itemBack = new qfi_CachedSvgItem( ":/qfi/images/ehsi/ehsi_back.svg" );
     _itemBack->setCacheMode( QGraphicsItem::NoCache );
     _itemBack->setZValue( _backZ );
     _itemBack->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _scene->addItem( _itemBack );
 
-    _itemMask = new QGraphicsSvgItem( ":/qfi/images/ehsi/ehsi_mask.svg" );
+    _itemMask = new qfi_CachedSvgItem( ":/qfi/images/ehsi/ehsi_mask.svg" );
     _itemMask->setCacheMode( QGraphicsItem::NoCache );
     _itemMask->setZValue( _maskZ );
     _itemMask->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _scene->addItem( _itemMask );
 
-    _itemMark = new QGraphicsSvgItem( ":/qfi/images/ehsi/ehsi_mark.svg" );
+    _itemMark = new qfi_CachedSvgItem( ":/qfi/images/ehsi/ehsi_mark.svg" );
     _itemMark->setCacheMode( QGraphicsItem::NoCache );
     _itemMark->setZValue( _markZ );
     _itemMark->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _scene->addItem( _itemMark );
 
-    _itemBrgArrow = new QGraphicsSvgItem( ":/qfi/images/ehsi/ehsi_brg_arrow.svg" );
+    _itemBrgArrow = qfi_Renderers::createItem( ":/qfi/images/ehsi/ehsi_brg_arrow.svg" );
     _itemBrgArrow->setCacheMode( QGraphicsItem::NoCache );
     _itemBrgArrow->setZValue( _brgArrowZ );
     _itemBrgArrow->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemBrgArrow->setTransformOriginPoint( _originalNavCtr );
     _scene->addItem( _itemBrgArrow );
 
-    _itemCrsArrow = new QGraphicsSvgItem( ":/qfi/images/ehsi/ehsi_crs_arrow.svg" );
+    _itemCrsArrow = qfi_Renderers::createItem( ":/qfi/images/ehsi/ehsi_crs_arrow.svg" );
     _itemCrsArrow->setCacheMode( QGraphicsItem::NoCache );
     _itemCrsArrow->setZValue( _crsArrowZ );
     _itemCrsArrow->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemCrsArrow->setTransformOriginPoint( _originalNavCtr );
     _scene->addItem( _itemCrsArrow );
 
-    _itemDevBar = new QGraphicsSvgItem( ":/qfi/images/ehsi/ehsi_dev_bar.svg" );
+    _itemDevBar = qfi_Renderers::createItem( ":/qfi/images/ehsi/ehsi_dev_bar.svg" );
     _itemDevBar->setCacheMode( QGraphicsItem::NoCache );
     _itemDevBar->setZValue( _devBarZ );
     _itemDevBar->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemDevBar->setTransformOriginPoint( _originalNavCtr );
     _scene->addItem( _itemDevBar );
 
-    _itemDevScale = new QGraphicsSvgItem( ":/qfi/images/ehsi/ehsi_dev_scale.svg" );
+    _itemDevScale = qfi_Renderers::createItem( ":/qfi/images/ehsi/ehsi_dev_scale.svg" );
     _itemDevScale->setCacheMode( QGraphicsItem::NoCache );
     _itemDevScale->setZValue( _devScaleZ );
     _itemDevScale->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemDevScale->setTransformOriginPoint( _originalNavCtr );
     _scene->addItem( _itemDevScale );
 
-    _itemHdgBug = new QGraphicsSvgItem( ":/qfi/images/ehsi/ehsi_hdg_bug.svg" );
+    _itemHdgBug = qfi_Renderers::createItem( ":/qfi/images/ehsi/ehsi_hdg_bug.svg" );
     _itemHdgBug->setCacheMode( QGraphicsItem::NoCache );
     _itemHdgBug->setZValue( _hdgBugZ );
     _itemHdgBug->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemHdgBug->setTransformOriginPoint( _originalNavCtr );
     _scene->addItem( _itemHdgBug );
 
-    _itemHdgScale = new QGraphicsSvgItem( ":/qfi/images/ehsi/ehsi_hdg_scale.svg" );
+    _itemHdgScale = qfi_Renderers::createItem( ":/qfi/images/ehsi/ehsi_hdg_scale.svg" );
     _itemHdgScale->setCacheMode( QGraphicsItem::NoCache );
     _itemHdgScale->setZValue( _hdgScaleZ );
     _itemHdgScale->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemHdgScale->setTransformOriginPoint( _originalNavCtr );
     _scene->addItem( _itemHdgScale );
 
-    _itemCdiTo = new QGraphicsSvgItem( ":/qfi/images/ehsi/ehsi_cdi_to.svg" );
+    _itemCdiTo = qfi_Renderers::createItem( ":/qfi/images/ehsi/ehsi_cdi_to.svg" );
     _itemCdiTo->setCacheMode( QGraphicsItem::NoCache );
     _itemCdiTo->setZValue( _crsArrowZ );
     _itemCdiTo->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemCdiTo->setTransformOriginPoint( _originalNavCtr );
     _scene->addItem( _itemCdiTo );
 
-    _itemCdiFrom = new QGraphicsSvgItem( ":/qfi/images/ehsi/ehsi_cdi_from.svg" );
+    _itemCdiFrom = qfi_Renderers::createItem( ":/qfi/images/ehsi/ehsi_cdi_from.svg" );
     _itemCdiFrom->setCacheMode( QGraphicsItem::NoCache );
     _itemCdiFrom->setZValue( _crsArrowZ );
     _itemCdiFrom->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -307,7 +493,7 @@ void qfi_EHSI::init()
 
     _itemCrsText = 0;
 
-    _itemCrsText = new QGraphicsTextItem( QString( "CRS 999" ) );
+    _itemCrsText = new qfi_GlyphTextItem( QString( "CRS 999" ) );
     _itemCrsText->setCacheMode( QGraphicsItem::NoCache );
     _itemCrsText->setZValue( _crsTextZ );
     _itemCrsText->setDefaultTextColor( qfi_Colors::_lime );
@@ -317,7 +503,7 @@ void qfi_EHSI::init()
                           _scaleY * ( _originalCrsTextCtr.y() - _itemCrsText->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemCrsText );
 
-    _itemHdgText = new QGraphicsTextItem( QString( "HDG 999" ) );
+    _itemHdgText = new qfi_GlyphTextItem( QString( "HDG 999" ) );
     _itemHdgText->setCacheMode( QGraphicsItem::NoCache );
     _itemHdgText->setZValue( _hdgTextZ );
     _itemHdgText->setDefaultTextColor( qfi_Colors::_magenta );
@@ -327,7 +513,7 @@ void qfi_EHSI::init()
                           _scaleY * ( _originalHdgTextCtr.y() - _itemHdgText->boundingRect().height() / 2.0 ) );
     _scene->addItem( _itemHdgText );
 
-    _itemDmeText = new QGraphicsTextItem( QString( "99.9 NM" ) );
+    _itemDmeText = new qfi_GlyphTextItem( QString( "99.9 NM" ) );
     _itemDmeText->setCacheMode( QGraphicsItem::NoCache );
     _itemDmeText->setZValue( _dmeTextZ );
     _itemDmeText->setDefaultTextColor( qfi_Colors::_white );
@@ -357,32 +543,45 @@ void qfi_EHSI::reset()
     _itemHdgText = 0;
     _itemDmeText = 0;
 
-    _heading   = 0.0;
-    _course    = 0.0;
-    _bearing   = 0.0;
-    _deviation = 0.0;
-    _distance  = 0.0;
-
-    _heading_sel = 0.0;
-
-    _cdi = CDI::Off;
-
-    _bearingVisible  = true;
-    _distanceVisible = true;
-
     _devBarDeltaX_new = 0.0;
     _devBarDeltaX_old = 0.0;
     _devBarDeltaY_new = 0.0;
     _devBarDeltaY_old = 0.0;
+
+    _navDirty  = true;
+    _textDirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_EHSI::updateView()
 {
-    _scaleX = static_cast< double >( width()  ) / static_cast< double >( _originalWidth  );
-    _scaleY = static_cast< double >( height() ) / static_cast< double >( _originalHeight );
+    QFI_PROFILE( "qfi_EHSI::updateView" );
+    QFI_TRACE( "updateView", "qfi_EHSI" );
+    qfi_Latency::updated( this );
+
+    if ( _navDirty )
+    {
+        updateNav();
+    }
 
+    if ( _textDirty )
+    {
+        updateText();
+    }
+
+    _navDirty  = false;
+    _textDirty = false;
+
+    _scene->update();
+
+    centerOn( _scaleX * _originalWidth / 2.0 , _scaleY * _originalHeight / 2.0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_EHSI::updateNav()
+{
     _itemCrsArrow->setRotation( -_heading + _course );
     _itemHdgBug->setRotation( -_heading + _heading_sel );
     _itemHdgScale->setRotation( -_heading );
@@ -445,6 +644,9 @@ void qfi_EHSI::updateView()
         _itemDevBar  ->moveBy( x, y );
         _itemCdiTo   ->moveBy( x, y );
         _itemCdiFrom ->moveBy( x, y );
+
+        _devBarDeltaX_old = _devBarDeltaX_new;
+        _devBarDeltaY_old = _devBarDeltaY_new;
     }
     else
     {
@@ -457,20 +659,29 @@ void qfi_EHSI::updateView()
         _devBarDeltaY_new = _devBarDeltaY_old;
     }
 
-    _itemCrsText->setPlainText( QString("CRS %1").arg( _course      , 3, 'f', 0, QChar('0') ) );
-    _itemHdgText->setPlainText( QString("HDG %1").arg( _heading_sel , 3, 'f', 0, QChar('0') ) );
+    _heading_old     = _heading;
+    _course_old      = _course;
+    _bearing_old     = _bearing;
+    _deviation_old   = _deviation;
+    _heading_sel_old = _heading_sel;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_EHSI::updateText()
+{
+    _itemCrsText->setNumber( _course      , 3, 0, '0', "CRS " );
+    _itemHdgText->setNumber( _heading_sel , 3, 0, '0', "HDG " );
 
     if ( _distanceVisible )
     {
         _itemDmeText->setVisible( true );
-        _itemDmeText->setPlainText( QString("%1 NM").arg( _distance, 5, 'f', 1, QChar(' ') ) );
+        _itemDmeText->setNumber( _distance, 5, 1, ' ', Q_NULLPTR, " NM" );
     }
     else
     {
         _itemDmeText->setVisible( false );
     }
 
-    _scene->update();
-
-    centerOn( width() / 2.0 , height() / 2.0 );
+    _distance_old = _distance;
 }
@@ -28,8 +28,15 @@
 
 #include <QGraphicsView>
 #include <QGraphicsSvgItem>
+#include <QImage>
+#include <QTimer>
+
+#include <functional>
 
 #include <qfi/qfi_defs.h>
+#include <qfi/qfi_Dirty.h>
+#include <qfi/qfi_GlyphTextItem.h>
+#include <qfi/qfi_TripleBuffer.h>
 #include <qfi/qfi_enums.h>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -43,6 +50,36 @@ class QFIAPI qfi_EHSI : public QGraphicsView
 
 public:
 
+    /**
+     * Instrument state, applied at once with setState(). Plain data
+     * structure, it can be copied between threads with memcpy().
+     */
+    struct State
+    {
+        double heading;       ///< [deg] heading
+        double course;        ///< [deg] course
+        double bearing;       ///< [deg] bearing
+        double deviation;     ///< [-] deviation
+        double distance;      ///< [nm] distance
+        double headingSel;    ///< [deg] selected heading
+
+        CDI cdi;              ///< CDI flag
+
+        bool bearingVisible;  ///< bearing visibility
+        bool distanceVisible; ///< distance visibility
+
+        /**
+         * Interpolates (ratio from 0.0 to 1.0) or extrapolates (ratio greater
+         * than 1.0) between states, see qfi_StateHistory. Discrete values
+         * (flags, modes) are taken from the nearer state.
+         * @param s0 first state
+         * @param s1 second state
+         * @param ratio interpolation ratio
+         * @param result output state
+         */
+        static void interpolate( const State &s0, const State &s1, double ratio, State *result );
+    };
+
     /** @brief Constructor. */
     explicit qfi_EHSI( QWidget *parent = Q_NULLPTR );
 
@@ -55,6 +92,14 @@ public:
     /** Refreshes (redraws) widget. */
     void redraw();
 
+    /**
+     * Renders widget into the image, also when the widget is not shown
+     * (e.g. with the offscreen platform plugin). Hidden widget is resized
+     * to the image size, image itself is never reallocated.
+     * @param image target image
+     */
+    void renderImage( QImage &image );
+
     /** @param heading [deg] */
     void setHeading( double heading );
 
@@ -73,6 +118,30 @@ public:
     /** @param heading [deg] */
     void setHeadingSel( double heading );
 
+    /**
+     * Applies all values of the state at once, only the visibly changed ones
+     * mark the instrument dirty.
+     * @param state instrument state
+     */
+    void setState( const State &state );
+
+    /**
+     * Other threads (e.g. simulation) may publish state into this buffer
+     * without blocking, the newest state is applied on redraw.
+     * @return state buffer
+     */
+    inline qfi_TripleBuffer< State >& stateBuffer() { return _stateBuffer; }
+
+    /**
+     * Sets function called with every state passed to setState(), also with
+     * states taken from stateBuffer(), e.g. by qfi_Recorder.
+     * @param hook state hook, empty function removes hook
+     */
+    inline void setStateHook( const std::function< void( const State& ) > &hook ) { _stateHook = hook; }
+
+    /** @return number of redraws skipped because nothing has changed */
+    inline qint64 suppressedRedraws() const { return _suppressedRedraws; }
+
 protected:
 
     /** */
@@ -81,6 +150,7 @@ protected:
 private:
 
     QGraphicsScene *_scene;             ///< graphics scene
+    QTimer *_resizeTimer;               ///< debounces rebuilding the scene after resizing
 
     QGraphicsSvgItem *_itemBack;        ///< NAV background
     QGraphicsSvgItem *_itemMask;        ///< NAV mask
@@ -95,9 +165,9 @@ private:
     QGraphicsSvgItem *_itemCdiTo;       ///<
     QGraphicsSvgItem *_itemCdiFrom;     ///<
 
-    QGraphicsTextItem *_itemCrsText;    ///<
-    QGraphicsTextItem *_itemHdgText;    ///<
-    QGraphicsTextItem *_itemDmeText;    ///<
+    qfi_GlyphTextItem *_itemCrsText;    ///<
+    qfi_GlyphTextItem *_itemHdgText;    ///<
+    qfi_GlyphTextItem *_itemDmeText;    ///<
 
     double _heading;                    ///< [deg]
     double _course;                     ///<
@@ -107,6 +177,13 @@ private:
 
     double _heading_sel;                ///< [deg]
 
+    double _heading_old;                ///< [deg] heading currently drawn
+    double _course_old;                 ///< [deg] course currently drawn
+    double _bearing_old;                ///< [deg] bearing currently drawn
+    double _deviation_old;              ///< deviation currently drawn
+    double _distance_old;               ///< [nm] distance currently drawn
+    double _heading_sel_old;            ///< [deg] selected heading currently drawn
+
     CDI _cdi;                           ///<
 
     bool _bearingVisible;               ///<
@@ -117,11 +194,23 @@ private:
     double _devBarDeltaY_new;           ///<
     double _devBarDeltaY_old;           ///<
 
+    bool _navDirty;                     ///< scales, arrows or deviation bar need update
+    bool _textDirty;                    ///< readouts need update
+
+    qint64 _suppressedRedraws;          ///<
+
+    qfi_TripleBuffer< State > _stateBuffer; ///< state published by other threads
+
+    std::function< void( const State& ) > _stateHook; ///< state hook
+
     double _scaleX;                     ///<
     double _scaleY;                     ///<
 
     double _originalPixPerDev;          ///<
 
+    const double _originalScaleRadius;  ///< [px] heading scale radius
+    const double _originalArrowRadius;  ///< [px] course and bearing arrows radius
+
     QPointF _originalNavCtr;            ///<
 
     QPointF _originalCrsTextCtr;        ///<
@@ -151,8 +240,17 @@ private:
     /** */
     void reset();
 
+    /** Scales the view to the current size until the scene is rebuilt. */
+    void rescale();
+
     /** */
     void updateView();
+
+    /** Updates scales, arrows and deviation bar. */
+    void updateNav();
+
+    /** Updates CRS, HDG and DME readouts. */
+    void updateText();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,308 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_FlightLog.h>
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+const qint64 fileHeaderSize  = 16;
+const qint64 chunkHeaderSize = 32;
+
+inline qint64 padded( qint64 size )
+{
+    return ( size + 7 ) & ~static_cast< qint64 >( 7 );
+}
+
+const char *names[] =
+{
+    "roll",
+    "pitch",
+    "heading",
+    "airspeed",
+    "altitude",
+    "pressure",
+    "climbRate",
+    "turnRate",
+    "slipSkid",
+    "aoa",
+    "sideslip",
+    "machNo",
+    "airspeedSel",
+    "altitudeSel",
+    "headingSel",
+    "course",
+    "bearing",
+    "deviation",
+    "distance",
+    "dotH",
+    "dotV",
+    "fdRoll",
+    "fdPitch",
+    "vfe",
+    "vne",
+    "fltMode",
+    "spdMode",
+    "lnav",
+    "vnav",
+    "pressureMode",
+    "cdi",
+    "flags"
+};
+
+static_assert( sizeof( names ) / sizeof( names[ 0 ] ) == qfi_FlightLog::_columns,
+               "column names do not match columns" );
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_FlightLog::isAngle( Column column )
+{
+    switch ( column )
+    {
+        case Column::Roll:
+        case Column::Heading:
+        case Column::HeadingSel:
+        case Column::Course:
+        case Column::Bearing:
+        case Column::FdRoll:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_FlightLog::isDiscrete( Column column )
+{
+    return column >= Column::FltMode && column < Column::Count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const char* qfi_FlightLog::name( Column column )
+{
+    int i = static_cast< int >( column );
+
+    return ( i >= 0 && i < _columns ) ? names[ i ] : "";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_FlightLog::qfi_FlightLog() :
+    _data ( Q_NULLPTR ),
+
+    _samples ( 0 )
+{
+    std::fill( _logged, _logged + _columns, false );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_FlightLog::~qfi_FlightLog()
+{
+    close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_FlightLog::open( const QString &fileName, quint32 source )
+{
+    close();
+
+    _file.setFileName( fileName );
+
+    if ( !_file.open( QIODevice::ReadOnly ) ) return false;
+
+    const qint64 size = _file.size();
+
+    // mapping does not read the file, pages are loaded on access
+    if ( size >= fileHeaderSize ) _data = _file.map( 0, size );
+
+    const quint32 *header = reinterpret_cast< const quint32* >( _data );
+
+    if ( !_data
+      || header[ 0 ] != _magicFile
+      || header[ 1 ] != _version
+      || header[ 2 ] != _byteOrder )
+    {
+        close();
+        return false;
+    }
+
+    qint64 offset = fileHeaderSize;
+
+    while ( offset + chunkHeaderSize <= size )
+    {
+        const uchar *chunkData = _data + offset;
+
+        const quint32 *chunkHeader = reinterpret_cast< const quint32* >( chunkData );
+        const qint64  *chunkSizes  = reinterpret_cast< const qint64*  >( chunkData + 16 );
+
+        const quint32 columns   = chunkHeader[ 0 ] == _magicChunk ? chunkHeader[ 1 ] : 0;
+        const qint64  count     = chunkSizes[ 0 ];
+        const qint64  chunkSize = chunkSizes[ 1 ];
+
+        // chunk being written or damaged, the rest of the log is ignored
+        if ( chunkHeader[ 0 ] != _magicChunk
+          || columns > 4096 || count < 0 || count > size / 8
+          || chunkSize > size - offset ) break;
+
+        const qint64 idsSize    = padded( 4 * columns );
+        const qint64 valuesSize = 8 * count;
+
+        if ( chunkSize != chunkHeaderSize + idsSize + 8 * count + columns * valuesSize ) break;
+
+        if ( !_sources.contains( chunkHeader[ 2 ] ) ) _sources.push_back( chunkHeader[ 2 ] );
+
+        if ( chunkHeader[ 2 ] == source && count > 0 )
+        {
+            const quint32 *ids = reinterpret_cast< const quint32* >( chunkData + chunkHeaderSize );
+
+            Chunk chunk;
+
+            chunk.first = _samples;
+            chunk.count = count;
+            chunk.time  = reinterpret_cast< const qint64* >( chunkData + chunkHeaderSize + idsSize );
+
+            std::fill( chunk.values, chunk.values + _columns, Q_NULLPTR );
+
+            const uchar *values = chunkData + chunkHeaderSize + idsSize + 8 * count;
+
+            for ( quint32 i = 0; i < columns; i++ )
+            {
+                // columns unknown to this version are skipped
+                if ( ids[ i ] < static_cast< quint32 >( _columns ) )
+                {
+                    chunk.values[ ids[ i ] ] = reinterpret_cast< const double* >( values + i * valuesSize );
+                    _logged[ ids[ i ] ] = true;
+                }
+            }
+
+            // samples have to be in time order for searching, the rest of
+            // the log is ignored otherwise
+            if ( !_chunks.isEmpty() )
+            {
+                const Chunk &last = _chunks.last();
+
+                if ( chunk.time[ 0 ] < last.time[ last.count - 1 ] ) break;
+            }
+
+            if ( !std::is_sorted( chunk.time, chunk.time + chunk.count ) ) break;
+
+            _chunks.push_back( chunk );
+            _samples += count;
+        }
+
+        offset += chunkSize;
+    }
+
+    std::sort( _sources.begin(), _sources.end() );
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_FlightLog::close()
+{
+    if ( _data ) _file.unmap( _data );
+    _data = Q_NULLPTR;
+
+    _file.close();
+
+    _chunks.clear();
+    _sources.clear();
+    _samples = 0;
+
+    std::fill( _logged, _logged + _columns, false );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_FlightLog::startTime() const
+{
+    return _chunks.isEmpty() ? 0 : _chunks.first().time[ 0 ];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_FlightLog::endTime() const
+{
+    return _chunks.isEmpty() ? 0 : _chunks.last().time[ _chunks.last().count - 1 ];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_FlightLog::find( qint64 time ) const
+{
+    if ( _chunks.isEmpty() || time < _chunks.first().time[ 0 ] ) return -1;
+
+    // last chunk starting not later than time
+    QVector< Chunk >::const_iterator chunk =
+            std::upper_bound( _chunks.constBegin(), _chunks.constEnd(), time,
+                              []( qint64 t, const Chunk &c ) { return t < c.time[ 0 ]; } ) - 1;
+
+    const qint64 *sample = std::upper_bound( chunk->time, chunk->time + chunk->count, time );
+
+    return chunk->first + ( sample - chunk->time ) - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_FlightLog::time( qint64 index ) const
+{
+    const Chunk &chunk = _chunks.at( findChunk( index ) );
+
+    return chunk.time[ index - chunk.first ];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_FlightLog::read( qint64 index, double *values ) const
+{
+    const Chunk &chunk = _chunks.at( findChunk( index ) );
+
+    const qint64 i = index - chunk.first;
+
+    for ( int c = 0; c < _columns; c++ )
+    {
+        values[ c ] = chunk.values[ c ] ? chunk.values[ c ][ i ] : 0.0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int qfi_FlightLog::findChunk( qint64 index ) const
+{
+    QVector< Chunk >::const_iterator chunk =
+            std::upper_bound( _chunks.constBegin(), _chunks.constEnd(), index,
+                              []( qint64 i, const Chunk &c ) { return i < c.first; } ) - 1;
+
+    return static_cast< int >( chunk - _chunks.constBegin() );
+}
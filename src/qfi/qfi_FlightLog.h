@@ -0,0 +1,222 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_FLIGHTLOG_H
+#define QFI_FLIGHTLOG_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Binary flight log reader class.
+ *
+ * Flight log is a sequence of chunks, each chunk holds a number of samples
+ * stored column by column: timestamps first, then one array of values per
+ * logged quantity. Chunks may log different sets of columns, missing columns
+ * read as 0. Every chunk belongs to a source, 0 is the whole aircraft,
+ * other sources are used e.g. for logs of separate instruments.
+ *
+ * The file is memory mapped and only chunk headers and timestamps are read
+ * when opening, so even multi-gigabyte logs open quickly and pages of values
+ * are loaded as they are needed. Incomplete last chunk (e.g. of a log being
+ * written) is ignored, as well as the rest of the log from the first chunk
+ * of samples out of time order (e.g. of a damaged file).
+ *
+ * File layout (native byte order, all arrays 8 bytes aligned):
+ * @code
+ * file header:  quint32 magic, quint32 version, quint32 byte order mark, quint32 reserved
+ * chunk header: quint32 magic, quint32 columns count, quint32 source, quint32 reserved,
+ *               qint64 samples count, qint64 chunk size in bytes (with header)
+ * chunk data:   quint32 column ids[ columns ]     (padded)
+ *               qint64 time[ samples ]            [us]
+ *               double values[ samples ]          (for each column)
+ * @endcode
+ *
+ * @see qfi_FlightLogWriter, qfi_Replay
+ */
+class QFIAPI qfi_FlightLog
+{
+public:
+
+    /** Logged quantities, ids are stored in files and must not change. */
+    enum class Column
+    {
+        Roll = 0,       ///< [deg] roll angle
+        Pitch,          ///< [deg] pitch angle
+        Heading,        ///< [deg] heading
+        Airspeed,       ///< [kts] airspeed
+        Altitude,       ///< [ft] altitude
+        Pressure,       ///< [inHg] pressure
+        ClimbRate,      ///< [ft/min] climb rate
+        TurnRate,       ///< [deg/s] turn rate
+        SlipSkid,       ///< normalized slip or skid (range from -1.0 to 1.0)
+        AngleOfAttack,  ///< [deg] angle of attack
+        Sideslip,       ///< [deg] angle of sideslip
+        MachNo,         ///< Mach number
+        AirspeedSel,    ///< [kts] selected airspeed
+        AltitudeSel,    ///< [ft] selected altitude
+        HeadingSel,     ///< [deg] selected heading
+        Course,         ///< [deg] course
+        Bearing,        ///< [deg] bearing
+        Deviation,      ///< normalized course deviation
+        Distance,       ///< [nm] distance
+        DotH,           ///< normalized horizontal deviation dot position
+        DotV,           ///< normalized vertical deviation dot position
+        FdRoll,         ///< [deg] FD roll angle
+        FdPitch,        ///< [deg] FD pitch angle
+        Vfe,            ///< [kts] vfe
+        Vne,            ///< [kts] vne
+        FltMode,        ///< qfi_EADI::FltMode
+        SpdMode,        ///< qfi_EADI::SpdMode
+        LNAV,           ///< qfi_EADI::LNAV
+        VNAV,           ///< qfi_EADI::VNAV
+        PressureMode,   ///< qfi_EADI::PressureMode
+        CDI,            ///< CDI
+        Flags,          ///< flags, see Flag
+
+        Count           ///< number of columns
+    };
+
+    /** Bits of Column::Flags values. */
+    enum Flag
+    {
+        Stall           = 0x01,     ///< stall flag
+        FpmVisible      = 0x02,     ///< flight path marker visibility
+        FdVisible       = 0x04,     ///< FD visibility
+        DotVisibleH     = 0x08,     ///< horizontal deviation dot visibility
+        DotVisibleV     = 0x10,     ///< vertical deviation dot visibility
+        BearingVisible  = 0x20,     ///< bearing visibility
+        DistanceVisible = 0x40      ///< distance visibility
+    };
+
+    static const quint32 _magicFile  = 0x474F4C51;  ///< "QLOG"
+    static const quint32 _magicChunk = 0x4B484351;  ///< "QCHK"
+    static const quint32 _version    = 2;           ///< format version
+    static const quint32 _byteOrder  = 0x01020304;  ///< byte order mark
+
+    static const int _columns = static_cast< int >( Column::Count );
+
+    /** @return true if column holds angle, which wraps around */
+    static bool isAngle( Column column );
+
+    /** @return true if column holds discrete values (modes, flags) */
+    static bool isDiscrete( Column column );
+
+    /** @return column name, as used e.g. in CSV headers */
+    static const char* name( Column column );
+
+    /** Constructor. */
+    qfi_FlightLog();
+
+    /** Destructor. */
+    virtual ~qfi_FlightLog();
+
+    /**
+     * Maps file and indexes chunks of the given source.
+     * @param fileName log file name
+     * @param source source id
+     * @return true on success, false otherwise
+     */
+    bool open( const QString &fileName, quint32 source = 0 );
+
+    /** Unmaps file. */
+    void close();
+
+    /** @return true if log is open */
+    inline bool isOpen() const { return _data != Q_NULLPTR; }
+
+    /** @return number of samples */
+    inline qint64 samples() const { return _samples; }
+
+    /** @return number of chunks */
+    inline int chunks() const { return _chunks.size(); }
+
+    /** @return ids of all sources found in the file, in ascending order */
+    inline const QVector< quint32 >& sources() const { return _sources; }
+
+    /** @return [us] first sample time, 0 if log is empty */
+    qint64 startTime() const;
+
+    /** @return [us] last sample time, 0 if log is empty */
+    qint64 endTime() const;
+
+    /** @return true if at least one chunk logs the column */
+    inline bool hasColumn( Column column ) const
+    {
+        return _logged[ static_cast< int >( column ) ];
+    }
+
+    /**
+     * Finds sample in O(log n) time.
+     * @param time [us] time
+     * @return index of the last sample not later than time, -1 if time is
+     * before the first sample
+     */
+    qint64 find( qint64 time ) const;
+
+    /**
+     * @param index sample index
+     * @return [us] sample time
+     */
+    qint64 time( qint64 index ) const;
+
+    /**
+     * Reads all columns of the sample without any allocation.
+     * @param index sample index
+     * @param values output array of Column::Count values
+     */
+    void read( qint64 index, double *values ) const;
+
+private:
+
+    /** Indexed chunk. */
+    struct Chunk
+    {
+        qint64 first;                       ///< index of the first sample
+        qint64 count;                       ///< number of samples
+        const qint64 *time;                 ///< timestamps
+        const double *values[ _columns ];   ///< columns, null if not logged
+    };
+
+    QFile _file;                    ///< log file
+
+    uchar *_data;                   ///< mapped file
+
+    QVector< Chunk > _chunks;       ///< indexed chunks
+    QVector< quint32 > _sources;    ///< all sources
+
+    qint64 _samples;                ///< number of samples
+
+    bool _logged[ _columns ];       ///< specifies if column is logged
+
+    int findChunk( qint64 index ) const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_FLIGHTLOG_H
@@ -0,0 +1,177 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_FlightLogWriter.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_FlightLogWriter::qfi_FlightLogWriter( int chunkSize ) :
+    _chunkSize ( qMax( 1, chunkSize ) ),
+
+    _count ( 0 )
+{
+    _time   .resize( _chunkSize );
+    _values .resize( _chunkSize * qfi_FlightLog::_columns );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_FlightLogWriter::~qfi_FlightLogWriter()
+{
+    close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_FlightLogWriter::open( const QString &fileName )
+{
+    close();
+
+    _file.setFileName( fileName );
+
+    if ( !_file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ) return false;
+
+    const quint32 header[] =
+    {
+        qfi_FlightLog::_magicFile,
+        qfi_FlightLog::_version,
+        qfi_FlightLog::_byteOrder,
+        0
+    };
+
+    if ( _file.write( reinterpret_cast< const char* >( header ), sizeof( header ) ) != sizeof( header ) )
+    {
+        _file.close();
+        return false;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_FlightLogWriter::close()
+{
+    if ( !_file.isOpen() ) return;
+
+    flush();
+
+    _file.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_FlightLogWriter::write( qint64 time, const double *values )
+{
+    if ( !_file.isOpen() ) return false;
+
+    _time[ _count ] = time;
+
+    for ( int c = 0; c < qfi_FlightLog::_columns; c++ )
+    {
+        _values[ c * _chunkSize + _count ] = values[ c ];
+    }
+
+    _count++;
+
+    return ( _count < _chunkSize ) ? true : flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_FlightLogWriter::flush()
+{
+    if ( _count == 0 ) return true;
+
+    qfi_FlightLog::Column columns[ qfi_FlightLog::_columns ];
+    const double *values[ qfi_FlightLog::_columns ];
+
+    for ( int c = 0; c < qfi_FlightLog::_columns; c++ )
+    {
+        columns [ c ] = static_cast< qfi_FlightLog::Column >( c );
+        values  [ c ] = _values.constData() + c * _chunkSize;
+    }
+
+    bool result = writeChunk( 0, columns, qfi_FlightLog::_columns,
+                              _time.constData(), values, _count );
+
+    _count = 0;
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_FlightLogWriter::writeChunk( quint32 source,
+                                      const qfi_FlightLog::Column *columns, int columnCount,
+                                      const qint64 *time, const double *const *values, qint64 count )
+{
+    if ( !_file.isOpen() || columnCount < 0 || count < 0 ) return false;
+
+    const qint64 idsSize    = ( 4 * columnCount + 7 ) & ~static_cast< qint64 >( 7 );
+    const qint64 valuesSize = 8 * count;
+
+    const quint32 header[] =
+    {
+        qfi_FlightLog::_magicChunk,
+        static_cast< quint32 >( columnCount ),
+        source,
+        0
+    };
+
+    const qint64 sizes[] =
+    {
+        count,
+        static_cast< qint64 >( sizeof( header ) + 2 * sizeof( qint64 ) )
+            + idsSize + 8 * count + columnCount * valuesSize
+    };
+
+    QVector< quint32 > ids( columnCount );
+
+    for ( int i = 0; i < columnCount; i++ )
+    {
+        ids[ i ] = static_cast< quint32 >( columns[ i ] );
+    }
+
+    bool result = writePadded( header, sizeof( header ) )
+               && writePadded( sizes, sizeof( sizes ) )
+               && writePadded( ids.constData(), 4 * columnCount )
+               && writePadded( time, 8 * count );
+
+    for ( int i = 0; i < columnCount && result; i++ )
+    {
+        result = writePadded( values[ i ], valuesSize );
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_FlightLogWriter::writePadded( const void *data, qint64 size )
+{
+    static const char zeros[ 8 ] = { 0 };
+
+    const qint64 padding = ( 8 - size % 8 ) % 8;
+
+    return _file.write( static_cast< const char* >( data ), size ) == size
+        && _file.write( zeros, padding ) == padding;
+}
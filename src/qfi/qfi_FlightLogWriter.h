@@ -0,0 +1,113 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_FLIGHTLOGWRITER_H
+#define QFI_FLIGHTLOGWRITER_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+#include <qfi/qfi_defs.h>
+#include <qfi/qfi_FlightLog.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Binary flight log writer class.
+ *
+ * Writes logs in the format read by qfi_FlightLog. Samples passed to write()
+ * are buffered and written as chunks of all columns, writeChunk() writes
+ * chunk of any columns and source at once.
+ */
+class QFIAPI qfi_FlightLogWriter
+{
+public:
+
+    /**
+     * Constructor.
+     * @param chunkSize number of samples per chunk written by write()
+     */
+    explicit qfi_FlightLogWriter( int chunkSize = 4096 );
+
+    /** Destructor, closes the log. */
+    virtual ~qfi_FlightLogWriter();
+
+    /**
+     * Creates log file, existing file is truncated.
+     * @param fileName log file name
+     * @return true on success, false otherwise
+     */
+    bool open( const QString &fileName );
+
+    /** Writes buffered samples and closes the log. */
+    void close();
+
+    /** @return true if log is open */
+    inline bool isOpen() const { return _file.isOpen(); }
+
+    /**
+     * Buffers sample of the source 0, samples have to be in time order.
+     * @param time [us] sample time
+     * @param values array of qfi_FlightLog::Column::Count values
+     * @return true on success, false otherwise
+     */
+    bool write( qint64 time, const double *values );
+
+    /**
+     * Writes buffered samples as a chunk.
+     * @return true on success, false otherwise
+     */
+    bool flush();
+
+    /**
+     * Writes chunk at once.
+     * @param source source id
+     * @param columns logged columns
+     * @param columnCount number of logged columns
+     * @param time [us] sample times
+     * @param values arrays of values, one for each logged column
+     * @param count number of samples
+     * @return true on success, false otherwise
+     */
+    bool writeChunk( quint32 source,
+                     const qfi_FlightLog::Column *columns, int columnCount,
+                     const qint64 *time, const double *const *values, qint64 count );
+
+private:
+
+    QFile _file;                    ///< log file
+
+    const int _chunkSize;           ///< number of samples per chunk
+
+    int _count;                     ///< number of buffered samples
+
+    QVector< qint64 > _time;        ///< buffered sample times
+    QVector< double > _values;      ///< buffered values, column by column
+
+    bool writePadded( const void *data, qint64 size );
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_FLIGHTLOGWRITER_H
@@ -0,0 +1,254 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_FrameScheduler.h>
+
+#include <QGuiApplication>
+#include <QScreen>
+
+#include <qfi/qfi_PaintHook.h>
+#include <qfi/qfi_ParallelRenderer.h>
+#include <qfi/qfi_Trace.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_FrameScheduler::qfi_FrameScheduler( QObject *parent ) :
+    QObject ( parent ),
+
+    _timer ( Q_NULLPTR ),
+
+    _targetRate ( 0.0 ),
+
+    _next              ( 0 ),
+    _frames            ( 0 ),
+    _coalescedRequests ( 0 ),
+    _droppedFrames     ( 0 ),
+    _frameTime         ( 0 ),
+    _frameCost         ( 0 ),
+    _paintTime         ( 0 ),
+
+    _requested  ( false ),
+    _continuous ( false )
+{
+    _timer = new QTimer( this );
+    _timer->setSingleShot( true );
+    _timer->setTimerType( Qt::PreciseTimer );
+    connect( _timer, &QTimer::timeout, this, &qfi_FrameScheduler::onTimeout );
+
+    _clock.start();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_FrameScheduler::~qfi_FrameScheduler()
+{
+    for ( int i = 0; i < _instruments.size(); i++ )
+    {
+        if ( _instruments.at( i ).view )
+        {
+            qfi_PaintHook::unsubscribe( _instruments.at( i ).view->viewport(), this );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_FrameScheduler::removeInstrument( QGraphicsView *instrument )
+{
+    for ( int i = _instruments.size() - 1; i >= 0; i-- )
+    {
+        if ( _instruments.at( i ).view == instrument )
+        {
+            qfi_PaintHook::unsubscribe( instrument->viewport(), this );
+            _instruments.removeAt( i );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_FrameScheduler::setDivider( QGraphicsView *instrument, int divider )
+{
+    for ( int i = 0; i < _instruments.size(); i++ )
+    {
+        if ( _instruments.at( i ).view == instrument )
+        {
+            _instruments[ i ].divider = qMax( 1, divider );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_FrameScheduler::setRenderer( qfi_ParallelRenderer *renderer )
+{
+    _renderer = renderer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_FrameScheduler::setTargetRate( double rate )
+{
+    _targetRate = qMax( 0.0, rate );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double qfi_FrameScheduler::targetRate() const
+{
+    if ( _targetRate > 0.0 ) return _targetRate;
+
+    QScreen *screen = QGuiApplication::primaryScreen();
+
+    double rate = screen ? screen->refreshRate() : 0.0;
+
+    return ( rate > 0.0 ) ? rate : 60.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_FrameScheduler::setContinuous( bool continuous )
+{
+    _continuous = continuous;
+
+    if ( _continuous ) schedule();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_FrameScheduler::requestFrame()
+{
+    if ( _requested )
+    {
+        _coalescedRequests++;
+        return;
+    }
+
+    _requested = true;
+
+    schedule();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_FrameScheduler::addView( QGraphicsView *view, const std::function< void() > &redraw )
+{
+    if ( !view ) return;
+
+    removeInstrument( view );
+
+    Instrument instrument;
+
+    instrument.view    = view;
+    instrument.redraw  = redraw;
+    instrument.divider = 1;
+    instrument.skipped = false;
+
+    _instruments.push_back( instrument );
+
+    qfi_PaintHook::subscribe( view->viewport(), this, [ this ]( qint64 duration )
+    {
+        _paintTime += duration;
+    } );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_FrameScheduler::schedule()
+{
+    if ( _timer->isActive() ) return;
+
+    qint64 period = static_cast< qint64 >( 1.0e9 / targetRate() );
+    qint64 now    = _clock.nsecsElapsed();
+
+    // after being idle the next frame is put back on the grid
+    if ( _next < now )
+    {
+        _next += ( ( now - _next ) / period + 1 ) * period;
+    }
+
+    _timer->start( static_cast< int >( ( _next - now + 999999 ) / 1000000 ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_FrameScheduler::onTimeout()
+{
+    qint64 start = _clock.nsecsElapsed();
+
+    _frameCost = _frameTime + _paintTime / 1000;
+    _paintTime = 0;
+
+    // frame only catching up with skipped instruments does not skip any more
+    // of them, so it is followed by at most (divider - 1) frames
+    const bool catchUp = !_requested && !_continuous;
+
+    bool skipped = false;
+
+    {
+        QFI_TRACE( "frame", Q_NULLPTR );
+
+        _requested = false;
+
+        emit frame();
+
+        for ( int i = 0; i < _instruments.size(); i++ )
+        {
+            Instrument &instrument = _instruments[ i ];
+
+            if ( !instrument.view ) continue;
+
+            // instruments with reduced update rate take turns
+            if ( ( _frames + i ) % instrument.divider == 0 )
+            {
+                instrument.redraw();
+                instrument.skipped = false;
+            }
+            else if ( !catchUp )
+            {
+                instrument.skipped = true;
+            }
+
+            skipped = skipped || instrument.skipped;
+        }
+
+        if ( _renderer ) _renderer->render();
+    }
+
+    qint64 period = static_cast< qint64 >( 1.0e9 / targetRate() );
+    qint64 now    = _clock.nsecsElapsed();
+
+    _frames++;
+    _frameTime = ( now - start ) / 1000;
+
+    _next += period;
+
+    // frame took longer than the time left to the next one
+    if ( _next <= now )
+    {
+        qint64 dropped = ( now - _next ) / period + 1;
+
+        _droppedFrames += dropped;
+        _next += dropped * period;
+    }
+
+    if ( _continuous || _requested || skipped ) schedule();
+}
@@ -0,0 +1,198 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_FRAMESCHEDULER_H
+#define QFI_FRAMESCHEDULER_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QElapsedTimer>
+#include <QGraphicsView>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+#include <functional>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+class qfi_ParallelRenderer;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Frame scheduler class.
+ *
+ * Drives all registered instruments from one timer running at the screen
+ * refresh rate (or at the given target rate) instead of an event loop busy
+ * loop. Frames are put on a fixed time grid, so the average rate does not
+ * drift and late frames are dropped rather than bunched. Any number of
+ * requestFrame() calls between two frames results in a single frame, and
+ * when no frame is requested (and continuous mode is off) the timer is
+ * stopped, so an idle panel costs no CPU time. Painting of the registered
+ * instruments is timed, so the whole frame cost is known (see frameCost()).
+ *
+ * Usage:
+ * @code
+ * scheduler->addInstrument( ai );
+ * scheduler->addInstrument( alt );
+ * ...
+ * connect( scheduler, &qfi_FrameScheduler::frame, this, &MainWindow::updateStates );
+ *
+ * // new data arrived
+ * scheduler->requestFrame();
+ * @endcode
+ */
+class QFIAPI qfi_FrameScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /** Constructor. */
+    explicit qfi_FrameScheduler( QObject *parent = Q_NULLPTR );
+
+    /** Destructor. */
+    virtual ~qfi_FrameScheduler();
+
+    /**
+     * Registers instrument, it is redrawn every frame (redraw() itself skips
+     * instruments with nothing changed).
+     * @param instrument instrument (qfi_AI, qfi_EADI, etc.)
+     */
+    template < class T >
+    inline void addInstrument( T *instrument )
+    {
+        addView( instrument, [ instrument ]() { instrument->redraw(); } );
+    }
+
+    /** @param instrument instrument not to be redrawn anymore */
+    void removeInstrument( QGraphicsView *instrument );
+
+    /**
+     * Reduces instrument update rate, instrument is redrawn every n-th
+     * frame only. Instruments with the same divider are redrawn in different
+     * frames, so the load is spread evenly. Instrument skipped in a frame
+     * is redrawn in its next turn even if no more frames are requested.
+     * @param instrument registered instrument
+     * @param divider update rate divider, 1 means every frame (default)
+     */
+    void setDivider( QGraphicsView *instrument, int divider );
+
+    /**
+     * Sets parallel renderer to be run after instruments are redrawn.
+     * @param renderer parallel renderer, null disables (default)
+     */
+    void setRenderer( qfi_ParallelRenderer *renderer );
+
+    /**
+     * @param rate [Hz] target frame rate, 0 means the primary screen
+     * refresh rate (default)
+     */
+    void setTargetRate( double rate );
+
+    /** @return [Hz] effective target frame rate */
+    double targetRate() const;
+
+    /**
+     * In continuous mode frames are produced at the target rate even if
+     * none has been requested, e.g. for animation or for states published
+     * by other threads.
+     * @param continuous specifies if continuous mode is enabled
+     */
+    void setContinuous( bool continuous );
+
+    /** @return true if continuous mode is enabled */
+    inline bool isContinuous() const { return _continuous; }
+
+    /** @return number of produced frames */
+    inline qint64 frames() const { return _frames; }
+
+    /** @return number of frame requests merged into already requested frames */
+    inline qint64 coalescedRequests() const { return _coalescedRequests; }
+
+    /** @return number of frames dropped because the previous one was late */
+    inline qint64 droppedFrames() const { return _droppedFrames; }
+
+    /** @return [us] duration of the last frame (without painting) */
+    inline qint64 frameTime() const { return _frameTime; }
+
+    /**
+     * Frame cost is known at the beginning of the next frame, as instruments
+     * are painted after the frame.
+     * @return [us] duration of the previous frame including painting
+     */
+    inline qint64 frameCost() const { return _frameCost; }
+
+public slots:
+
+    /** Requests frame, several requests before the frame make one frame. */
+    void requestFrame();
+
+signals:
+
+    /** Emitted at the beginning of every frame, instruments states should be set here. */
+    void frame();
+
+private:
+
+    /** Registered instrument. */
+    struct Instrument
+    {
+        QPointer< QGraphicsView > view;     ///< instrument
+        std::function< void() > redraw;     ///< instrument redraw function
+        int divider;                        ///< update rate divider
+        bool skipped;                       ///< specifies if instrument has been skipped and waits for its turn
+    };
+
+    QList< Instrument > _instruments;           ///< registered instruments
+
+    QPointer< qfi_ParallelRenderer > _renderer; ///< parallel renderer
+
+    QTimer *_timer;                 ///< frame timer
+    QElapsedTimer _clock;           ///< frame grid clock
+
+    double _targetRate;             ///< [Hz] target frame rate, 0 means screen refresh rate
+
+    qint64 _next;                   ///< [ns] next frame time
+    qint64 _frames;                 ///< number of produced frames
+    qint64 _coalescedRequests;      ///< number of merged frame requests
+    qint64 _droppedFrames;          ///< number of dropped frames
+    qint64 _frameTime;              ///< [us] duration of the last frame
+    qint64 _frameCost;              ///< [us] duration of the previous frame including painting
+    qint64 _paintTime;              ///< [ns] painting time since the last frame
+
+    bool _requested;                ///< specifies if frame has been requested
+    bool _continuous;               ///< specifies if continuous mode is enabled
+
+    void addView( QGraphicsView *view, const std::function< void() > &redraw );
+
+    void schedule();
+
+    void onTimeout();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_FRAMESCHEDULER_H
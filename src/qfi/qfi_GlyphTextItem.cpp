@@ -0,0 +1,341 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+
+#include <qfi/qfi_GlyphTextItem.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <QFontMetricsF>
+#include <QImage>
+#include <QPainter>
+#include <QPaintDevice>
+#include <QtMath>
+
+#include <qfi/qfi_Cache.h>
+#include <qfi/qfi_Profiler.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+// QGraphicsTextItem document margin
+static const qreal margin = 4.0;
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_GlyphTextItem::_glyphsEnabled = true;
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_GlyphTextItem::qfi_GlyphTextItem( const QString &text,
+                                      QGraphicsItem *parent ) :
+    QGraphicsItem ( parent ),
+
+    _color ( Qt::black ),
+
+    _size ( 0 ),
+
+    _ascent     ( 0.0 ),
+    _descent    ( 0.0 ),
+    _lineHeight ( 0.0 ),
+    _textWidth  ( 0.0 ),
+
+    _cellBaseline ( 0 ),
+    _glyphsScaleX ( 0.0 ),
+    _glyphsScaleY ( 0.0 )
+{
+    _text[ 0 ] = '\0';
+
+    setFont( _font );
+    setPlainText( text );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_GlyphTextItem::setDefaultTextColor( const QColor &color )
+{
+    if ( color != _color )
+    {
+        _color  = color;
+        _glyphs = QImage();
+        _glyphsScaleX = 0.0;
+        _glyphsScaleY = 0.0;
+
+        update();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_GlyphTextItem::setFont( const QFont &font )
+{
+    prepareGeometryChange();
+
+    _font = font;
+
+    QFontMetricsF metrics( _font );
+
+    for ( int i = 0; i < _count; i++ )
+    {
+#       if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+        _advances[ i ] = metrics.horizontalAdvance( QChar( _first + i ) );
+#       else
+        _advances[ i ] = metrics.width( QChar( _first + i ) );
+#       endif
+    }
+
+    _ascent     = metrics.ascent();
+    _descent    = metrics.descent();
+    _lineHeight = qCeil( metrics.height() );
+
+    _textWidth = 0.0;
+
+    for ( int i = 0; i < _size; i++ )
+    {
+        _textWidth += _advances[ _text[ i ] - _first ];
+    }
+
+    _glyphs = QImage();
+    _glyphsScaleX = 0.0;
+    _glyphsScaleY = 0.0;
+
+    update();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_GlyphTextItem::setPlainText( const QString &text )
+{
+    char buffer[ _length ];
+
+    int size = static_cast< int >( text.size() );
+
+    if ( size > _length - 1 ) size = _length - 1;
+
+    for ( int i = 0; i < size; i++ )
+    {
+        buffer[ i ] = text.at( i ).toLatin1();
+    }
+
+    setBuffer( buffer, size );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_GlyphTextItem::setText( const char *text )
+{
+    int size = static_cast< int >( strlen( text ) );
+
+    setBuffer( text, qMin( size, _length - 1 ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_GlyphTextItem::setNumber( double value, int width, int precision, char fill,
+                                   const char *prefix, const char *suffix )
+{
+    char buffer[ _length ];
+
+    int size = snprintf( buffer, _length,
+                         ( fill == '0' ) ? "%s%0*.*f%s" : "%s%*.*f%s",
+                         prefix ? prefix : "",
+                         width, precision, value,
+                         suffix ? suffix : "" );
+
+    if ( size < 0 ) size = 0;
+
+    setBuffer( buffer, qMin( size, _length - 1 ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_GlyphTextItem::setGlyphsEnabled( bool enabled )
+{
+    _glyphsEnabled = enabled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QRectF qfi_GlyphTextItem::boundingRect() const
+{
+    return QRectF( 0.0, 0.0, _textWidth + 2.0 * margin, _lineHeight + 2.0 * margin );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_GlyphTextItem::paint( QPainter *painter,
+                               const QStyleOptionGraphicsItem *,
+                               QWidget * )
+{
+    QFI_PROFILE( "qfi_GlyphTextItem" );
+
+    if ( _size == 0 ) return;
+
+    const QTransform transform = painter->worldTransform();
+
+    qreal dpr = painter->device()->devicePixelRatioF();
+
+    qreal scaleX = fabs( transform.m11() );
+    qreal scaleY = fabs( transform.m22() );
+
+    bool rebuild = scaleX * dpr != _glyphsScaleX || scaleY * dpr != _glyphsScaleY;
+
+    if ( !_glyphsEnabled || transform.isRotating()
+      || ( rebuild && !_glyphs.isNull() && qfi_Cache::isDeferred() ) )
+    {
+        painter->setFont( _font );
+        painter->setPen( _color );
+        painter->drawText( QPointF( margin, margin + _ascent ),
+                           QString::fromLatin1( _text, _size ) );
+        return;
+    }
+
+    if ( rebuild )
+    {
+        updateGlyphs( scaleX * dpr, scaleY * dpr, dpr );
+    }
+
+    if ( _glyphs.isNull() ) return;
+
+    QPointF origin = transform.map( QPointF( margin, margin + _ascent ) );
+
+    // glyphs are drawn at whole device pixels, baseline is snapped the same
+    // way as by the text layout
+    qreal y = ( qRound( origin.y() * dpr ) - _cellBaseline ) / dpr;
+
+    qreal w = _cellSize.width()  / dpr;
+    qreal h = _cellSize.height() / dpr;
+
+    qreal pen = origin.x();
+
+    painter->save();
+    painter->setWorldTransform( QTransform() );
+
+    for ( int i = 0; i < _size; i++ )
+    {
+        int index = _text[ i ] - _first;
+
+        if ( _text[ i ] != ' ' )
+        {
+            qreal x = ( qRound( pen * dpr ) - _pad ) / dpr;
+
+            painter->drawImage( QRectF( x, y, w, h ), _glyphs,
+                                QRectF( index * _cellSize.width(), 0.0,
+                                        _cellSize.width(), _cellSize.height() ) );
+        }
+
+        pen += _advances[ index ] * scaleX;
+    }
+
+    painter->restore();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_GlyphTextItem::setBuffer( const char *text, int size )
+{
+    if ( size == _size && memcmp( text, _text, size ) == 0 ) return;
+
+    qreal textWidth = 0.0;
+
+    for ( int i = 0; i < size; i++ )
+    {
+        char c = text[ i ];
+
+        if ( c < _first || c >= _first + _count ) c = ' ';
+
+        _text[ i ] = c;
+
+        textWidth += _advances[ c - _first ];
+    }
+
+    _text[ size ] = '\0';
+    _size = size;
+
+    if ( textWidth != _textWidth )
+    {
+        prepareGeometryChange();
+        _textWidth = textWidth;
+    }
+
+    update();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_GlyphTextItem::updateGlyphs( qreal scaleX, qreal scaleY, qreal dpr )
+{
+    qreal advance = 0.0;
+
+    for ( int i = 0; i < _count; i++ )
+    {
+        advance = qMax( advance, _advances[ i ] );
+    }
+
+    int ascent  = qCeil( _ascent  * scaleY );
+    int descent = qCeil( _descent * scaleY );
+
+    _cellSize = QSize( qCeil( advance * scaleX ) + 2 * _pad,
+                       ascent + descent + 2 * _pad );
+
+    _cellBaseline = _pad + ascent;
+
+    _glyphsScaleX = scaleX;
+    _glyphsScaleY = scaleY;
+
+    QSize size( _cellSize.width() * _count, _cellSize.height() );
+
+    // strip is keyed by scale, as strips of different scales may have
+    // the same (rounded up) size
+    QString key = QString( "glyphs:%1:%2@%3x%4@%5" )
+            .arg( _font.key() )
+            .arg( _color.rgba() )
+            .arg( scaleX, 0, 'g', 17 )
+            .arg( scaleY, 0, 'g', 17 )
+            .arg( dpr );
+
+    if ( !qfi_Cache::find( key, &_glyphs ) )
+    {
+        QImage image( size, QImage::Format_ARGB32_Premultiplied );
+        image.fill( Qt::transparent );
+
+        QPainter imagePainter( &image );
+        imagePainter.setFont( _font );
+        imagePainter.setPen( _color );
+
+        for ( int i = 0; i < _count; i++ )
+        {
+            imagePainter.setTransform( QTransform::fromTranslate( i * _cellSize.width() + _pad,
+                                                                  _cellBaseline ) );
+            imagePainter.scale( scaleX, scaleY );
+            imagePainter.drawText( QPointF( 0.0, 0.0 ), QString( QChar( _first + i ) ) );
+        }
+
+        imagePainter.end();
+
+        image.setDevicePixelRatio( dpr );
+
+        _glyphs = image;
+
+        qfi_Cache::insert( key, _glyphs );
+    }
+}
@@ -0,0 +1,137 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_GLYPHTEXTITEM_H
+#define QFI_GLYPHTEXTITEM_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QColor>
+#include <QFont>
+#include <QGraphicsItem>
+#include <QImage>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Single line text item composed of pre-rendered glyphs.
+ *
+ * Lightweight replacement of QGraphicsTextItem for numeric readouts and
+ * annunciators. Printable ASCII characters of the item's font and color are
+ * rasterized once per pixel scale into a strip shared through qfi_Cache;
+ * text is then drawn by blitting glyphs. Setting text does not allocate and
+ * does nothing if the text has not changed.
+ *
+ * Bounding rectangle and text position match QGraphicsTextItem (including
+ * its 4 px document margin), so existing layout code can be kept.
+ *
+ * Glyphs can be disabled for comparison, text is then drawn with
+ * QPainter::drawText() every time (see setGlyphsEnabled()).
+ */
+class QFIAPI qfi_GlyphTextItem : public QGraphicsItem
+{
+public:
+
+    /** Constructor. */
+    explicit qfi_GlyphTextItem( const QString &text,
+                                QGraphicsItem *parent = Q_NULLPTR );
+
+    /** */
+    void setDefaultTextColor( const QColor &color );
+
+    /** */
+    void setFont( const QFont &font );
+
+    /** @param text text, characters outside printable ASCII are drawn as spaces */
+    void setPlainText( const QString &text );
+
+    /** @param text null terminated text */
+    void setText( const char *text );
+
+    /**
+     * Sets text to the formatted number, same as
+     * QString( "%1" ).arg( value, width, 'f', precision, fill ).
+     * @param value number
+     * @param width minimum field width
+     * @param precision number of decimal places
+     * @param fill fill character, either ' ' or '0'
+     * @param prefix text before the number
+     * @param suffix text after the number
+     */
+    void setNumber( double value, int width, int precision = 0, char fill = ' ',
+                    const char *prefix = Q_NULLPTR, const char *suffix = Q_NULLPTR );
+
+    /**
+     * Enables or disables drawing text with pre-rendered glyphs in all
+     * items, it should be set before instruments are painted.
+     * @param enabled specifies if glyphs are enabled (default)
+     */
+    static void setGlyphsEnabled( bool enabled );
+
+    /** @return true if glyphs are enabled */
+    static inline bool glyphsEnabled() { return _glyphsEnabled; }
+
+    /** */
+    QRectF boundingRect() const override;
+
+    /** */
+    void paint( QPainter *painter,
+                const QStyleOptionGraphicsItem *option,
+                QWidget *widget = Q_NULLPTR ) override;
+
+private:
+
+    static const int _first  = 32;      ///< first glyph (space)
+    static const int _count  = 95;      ///< number of glyphs (printable ASCII)
+    static const int _length = 32;      ///< text buffer length
+
+    static const int _pad = 2;          ///< [px] glyph cell padding
+
+    static bool _glyphsEnabled;         ///< specifies if glyphs are enabled
+
+    QFont  _font;                       ///<
+    QColor _color;                      ///<
+
+    char _text[ _length ];              ///< current text (null terminated)
+    int  _size;                         ///< current text length
+
+    qreal _advances[ _count ];          ///< glyph advances
+    qreal _ascent;                      ///<
+    qreal _descent;                     ///<
+    qreal _lineHeight;                  ///<
+    qreal _textWidth;                   ///< current text width
+
+    QImage  _glyphs;                    ///< glyph strip
+    QSize   _cellSize;                  ///< [px] glyph cell size
+    int     _cellBaseline;              ///< [px] baseline within the glyph cell
+    qreal   _glyphsScaleX;              ///< strip horizontal scale
+    qreal   _glyphsScaleY;              ///< strip vertical scale
+
+    void setBuffer( const char *text, int size );
+
+    void updateGlyphs( qreal scaleX, qreal scaleY, qreal dpr );
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_GLYPHTEXTITEM_H
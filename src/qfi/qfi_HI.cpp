@@ -28,6 +28,14 @@
 
 #include <cmath>
 
+#include <qfi/qfi_Cache.h>
+#include <qfi/qfi_CachedSvgItem.h>
+#include <qfi/qfi_Interpolation.h>
+#include <qfi/qfi_Latency.h>
+#include <qfi/qfi_Offscreen.h>
+#include <qfi/qfi_Profiler.h>
+#include <qfi/qfi_Trace.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 
 qfi_HI::qfi_HI( QWidget *parent ) :
@@ -35,17 +43,29 @@ qfi_HI::qfi_HI( QWidget *parent ) :
 
     _scene ( Q_NULLPTR ),
 
+    _resizeTimer ( Q_NULLPTR ),
+
     _itemFace ( Q_NULLPTR ),
     _itemCase ( Q_NULLPTR ),
 
     _heading ( 0.0 ),
 
+    _heading_old ( 0.0 ),
+
+    _dirty ( true ),
+
+    _suppressedRedraws ( 0 ),
+
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
 
+    _atlasStep ( 0.0 ),
+
     _originalHeight ( 240 ),
     _originalWidth  ( 240 ),
 
+    _originalFaceRadius ( 112.0 ),
+
     _originalHsiCtr ( 120.0 , 120.0 ),
 
     _faceZ ( -20 ),
@@ -56,6 +76,11 @@ qfi_HI::qfi_HI( QWidget *parent ) :
     _scene = new QGraphicsScene( this );
     setScene( _scene );
 
+    _resizeTimer = new QTimer( this );
+    _resizeTimer->setSingleShot( true );
+    _resizeTimer->setInterval( 200 );
+    connect( _resizeTimer, &QTimer::timeout, this, &qfi_HI::reinit );
+
     _scene->clear();
 
     init();
@@ -81,6 +106,10 @@ void qfi_HI::reinit()
 {
     if ( _scene )
     {
+        _resizeTimer->stop();
+
+        resetTransform();
+
         _scene->clear();
 
         init();
@@ -92,16 +121,98 @@ void qfi_HI::reinit()
 void qfi_HI::redraw()
 {
     if ( isVisible() )
+    {
+        State state;
+
+        if ( _stateBuffer.consume( &state ) ) setState( state );
+
+        if ( _dirty )
+        {
+            updateView();
+        }
+        else
+        {
+            _suppressedRedraws++;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_HI::renderImage( QImage &image )
+{
+    QSize size = qfi_Offscreen::size( image );
+
+    if ( size.isEmpty() ) return;
+
+    State state;
+
+    if ( _stateBuffer.consume( &state ) ) setState( state );
+
+    if ( !isVisible() && size != this->size() )
+    {
+        resize( size );
+        reinit();
+    }
+
+    if ( _dirty )
     {
         updateView();
     }
+
+    qfi_Offscreen::render( _scene,
+                           QRectF( 0.0, 0.0, _scaleX * _originalWidth, _scaleY * _originalHeight ),
+                           image, renderHints() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_HI::setState( const State &state )
+{
+    if ( _stateHook ) _stateHook( state );
+
+    setHeading( state.heading );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_HI::State::interpolate( const State &s0, const State &s1, double ratio, State *result )
+{
+    result->heading = qfi_Interpolation::angle ( s0.heading, s1.heading, ratio );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_HI::setHeading( double heading )
 {
+    double pxPerDeg = qfi_Dirty::pxPerDeg( _originalFaceRadius * qMin( _scaleX, _scaleY ) );
+
     _heading = heading;
+
+    if ( qfi_Dirty::isChanged( _heading, _heading_old, pxPerDeg ) )
+    {
+        _dirty = true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_HI::setAtlasStep( double step )
+{
+    _atlasStep = step;
+
+    if ( _itemFace ) _itemFace->setAngleStep( _atlasStep );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_HI::atlasBytes() const
+{
+    qint64 bytes = 0;
+
+    if ( _itemFace ) bytes += _itemFace->atlasBytes();
+
+    return bytes;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -112,7 +223,33 @@ void qfi_HI::resizeEvent( QResizeEvent *event )
     QGraphicsView::resizeEvent( event );
     ////////////////////////////////////
 
-    reinit();
+    if ( isVisible() && _itemCase )
+    {
+        rescale();
+    }
+    else
+    {
+        reinit();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_HI::rescale()
+{
+    // items and their state are kept, the scene is rebuilt at the new scale
+    // once the size settles
+    setTransform( QTransform::fromScale( width()  / ( _scaleX * _originalWidth  ),
+                                         height() / ( _scaleY * _originalHeight ) ) );
+
+    centerOn( _scaleX * _originalWidth / 2.0 , _scaleY * _originalHeight / 2.0 );
+
+    // changes too small to be visible at the previous size may be visible now
+    _dirty = true;
+
+    qfi_Cache::deferRebuilds( _resizeTimer->interval() );
+
+    _resizeTimer->start();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -124,14 +261,15 @@ void qfi_HI::init()
 
     reset();
 
-    _itemFace = new QGraphicsSvgItem( ":/qfi/images/hi/hi_face.svg" );
+    _itemFace = new qfi_AtlasSvgItem( ":/qfi/images/hi/hi_face.svg" );
     _itemFace->setCacheMode( QGraphicsItem::NoCache );
     _itemFace->setZValue( _faceZ );
     _itemFace->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
+    _itemFace->setAngleStep( _atlasStep );
     _itemFace->setTransformOriginPoint( _originalHsiCtr );
     _scene->addItem( _itemFace );
 
-    _itemCase = new QGraphicsSvgItem( ":/qfi/images/hi/hi_case.svg" );
+    _itemCase = new qfi_CachedSvgItem( ":/qfi/images/hi/hi_case.svg" );
     _itemCase->setCacheMode( QGraphicsItem::NoCache );
     _itemCase->setZValue( _caseZ );
     _itemCase->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -149,14 +287,22 @@ void qfi_HI::reset()
     _itemFace = Q_NULLPTR;
     _itemCase = Q_NULLPTR;
 
-    _heading = 0.0;
+    _dirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_HI::updateView()
 {
+    QFI_PROFILE( "qfi_HI::updateView" );
+    QFI_TRACE( "updateView", "qfi_HI" );
+    qfi_Latency::updated( this );
+
     _itemFace->setRotation( - _heading );
 
+    _heading_old = _heading;
+
+    _dirty = false;
+
     _scene->update();
 }
@@ -28,6 +28,15 @@
 
 #include <cmath>
 
+#include <qfi/qfi_Cache.h>
+#include <qfi/qfi_CachedSvgItem.h>
+#include <qfi/qfi_Interpolation.h>
+#include <qfi/qfi_Latency.h>
+#include <qfi/qfi_Offscreen.h>
+#include <qfi/qfi_Profiler.h>
+#include <qfi/qfi_Renderers.h>
+#include <qfi/qfi_Trace.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 
 qfi_ILS::qfi_ILS( QWidget *parent ) :
@@ -35,10 +44,10 @@ qfi_ILS::qfi_ILS( QWidget *parent ) :
 
     _scene ( Q_NULLPTR ),
 
+    _resizeTimer ( Q_NULLPTR ),
+
     _itemFaceFixed ( Q_NULLPTR ),
     _itemFace ( Q_NULLPTR ),
-    _itemFlagNav ( Q_NULLPTR ),
-    _itemFlagGs ( Q_NULLPTR ),
     _itemHandNav ( Q_NULLPTR ),
     _itemHandGs ( Q_NULLPTR ),
     _itemCase ( Q_NULLPTR ),
@@ -49,17 +58,28 @@ qfi_ILS::qfi_ILS( QWidget *parent ) :
     _visibleH (false),
     _visibleV (false),
 
+    _course_old ( 0.0 ),
+    _dotH_old ( 0.0 ),
+    _dotV_old ( 0.0 ),
+
     _dotVPos( 0.0 ),
     _dotVPos_old ( 0.0 ),
     _dotHPos ( 0.0 ),
     _dotHPos_old ( 0.0 ),
 
+    _dirty ( true ),
+
+    _suppressedRedraws ( 0 ),
+
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
 
     _originalHeight ( 240 ),
     _originalWidth  ( 240 ),
 
+    _originalFaceRadius ( 93.0 ),
+    _originalPixPerDot  ( 38.0 ),
+
     _originalVorCtr ( 120.0 , 120.0 ),
     _originalHandCtr( 120, 68 ),
 
@@ -67,8 +87,6 @@ qfi_ILS::qfi_ILS( QWidget *parent ) :
     _handNavZ ( -40 ),
     _handGsZ ( -30 ),
     _faceZ ( -20 ),
-    _flagNavZ ( -60 ),
-    _flagGsZ ( -50 ),
     _caseZ (  10 )
 {
     reset();
@@ -76,6 +94,11 @@ qfi_ILS::qfi_ILS( QWidget *parent ) :
     _scene = new QGraphicsScene( this );
     setScene( _scene );
 
+    _resizeTimer = new QTimer( this );
+    _resizeTimer->setSingleShot( true );
+    _resizeTimer->setInterval( 200 );
+    connect( _resizeTimer, &QTimer::timeout, this, &qfi_ILS::reinit );
+
     _scene->clear();
 
     init();
@@ -101,6 +124,10 @@ void qfi_ILS::reinit()
 {
     if ( _scene )
     {
+        _resizeTimer->stop();
+
+        resetTransform();
+
         _scene->clear();
 
         init();
@@ -112,31 +139,109 @@ void qfi_ILS::reinit()
 void qfi_ILS::redraw()
 {
     if ( isVisible() )
+    {
+        State state;
+
+        if ( _stateBuffer.consume( &state ) ) setState( state );
+
+        if ( _dirty )
+        {
+            updateView();
+        }
+        else
+        {
+            _suppressedRedraws++;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ILS::renderImage( QImage &image )
+{
+    QSize size = qfi_Offscreen::size( image );
+
+    if ( size.isEmpty() ) return;
+
+    State state;
+
+    if ( _stateBuffer.consume( &state ) ) setState( state );
+
+    if ( !isVisible() && size != this->size() )
+    {
+        resize( size );
+        reinit();
+    }
+
+    if ( _dirty )
     {
         updateView();
     }
+
+    qfi_Offscreen::render( _scene,
+                           QRectF( 0.0, 0.0, _scaleX * _originalWidth, _scaleY * _originalHeight ),
+                           image, renderHints() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ILS::setState( const State &state )
+{
+    if ( _stateHook ) _stateHook( state );
+
+    setCourse( state.course );
+    setDots( state.dotH, state.dotV, state.visibleH, state.visibleV );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ILS::State::interpolate( const State &s0, const State &s1, double ratio, State *result )
+{
+    *result = ( ratio < 0.5 ) ? s0 : s1;
+
+    result->course = qfi_Interpolation::angle ( s0.course, s1.course, ratio );
+    result->dotH   = qfi_Interpolation::linear( s0.dotH, s1.dotH, ratio );
+    result->dotV   = qfi_Interpolation::linear( s0.dotV, s1.dotV, ratio );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_ILS::setCourse( double course )
 {
+    double pxPerDeg = qfi_Dirty::pxPerDeg( _originalFaceRadius * qMin( _scaleX, _scaleY ) );
+
     _course = course;
+
+    if ( qfi_Dirty::isChanged( _course, _course_old, pxPerDeg ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void  qfi_ILS::setDots( double dotH, double dotV, bool visibleH, bool visibleV )
 {
+    if ( dotH < -1.0 ) dotH = -1.0;
+    if ( dotH >  1.0 ) dotH =  1.0;
+    if ( dotV < -1.0 ) dotV = -1.0;
+    if ( dotV >  1.0 ) dotV =  1.0;
+
+    if ( visibleH != _visibleH || visibleH != _visibleV )
+    {
+        _dirty = true;
+    }
+
     _dotH = dotH;
     _dotV = dotV;
     _visibleH = visibleH;
     _visibleV = visibleH;
 
-    if ( _dotH < -1.0 ) _dotH = -1.0;
-    if ( _dotH >  1.0 ) _dotH =  1.0;
-    if ( _dotV < -1.0 ) _dotV = -1.0;
-    if ( _dotV >  1.0 ) _dotV =  1.0;
+    if ( qfi_Dirty::isChanged( _dotH, _dotH_old, _originalPixPerDot * _scaleX )
+      || qfi_Dirty::isChanged( _dotV, _dotV_old, _originalPixPerDot * _scaleY ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -147,7 +252,33 @@ void qfi_ILS::resizeEvent( QResizeEvent *event )
     QGraphicsView::resizeEvent( event );
     ////////////////////////////////////
 
-    reinit();
+    if ( isVisible() && _itemCase )
+    {
+        rescale();
+    }
+    else
+    {
+        reinit();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ILS::rescale()
+{
+    // items and their state are kept, the scene is rebuilt at the new scale
+    // once the size settles
+    setTransform( QTransform::fromScale( width()  / ( _scaleX * _originalWidth  ),
+                                         height() / ( _scaleY * _originalHeight ) ) );
+
+    centerOn( _scaleX * _originalWidth / 2.0 , _scaleY * _originalHeight / 2.0 );
+
+    // changes too small to be visible at the previous size may be visible now
+    _dirty = true;
+
+    qfi_Cache::deferRebuilds( _resizeTimer->interval() );
+
+    _resizeTimer->start();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -159,49 +290,38 @@ void qfi_ILS::init()
 
     reset();
 
-    _itemFaceFixed = new QGraphicsSvgItem( ":/qfi/images/ils/ils_case_fixed.svg" );
+    // flags are static and share the Z value of the fixed face
+    _itemFaceFixed = new qfi_CachedSvgItem( ":/qfi/images/ils/ils_case_fixed.svg" );
+    _itemFaceFixed->addLayer( ":/qfi/images/ils/ils_flag_nav.svg" );
+    _itemFaceFixed->addLayer( ":/qfi/images/ils/ils_flag_gs.svg" );
     _itemFaceFixed->setCacheMode( QGraphicsItem::NoCache );
     _itemFaceFixed->setZValue( _faceFixedZ );
     _itemFaceFixed->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemFaceFixed->setTransformOriginPoint( _originalVorCtr );
     _scene->addItem( _itemFaceFixed );
 
-    _itemFace = new QGraphicsSvgItem( ":/qfi/images/ils/ils_face.svg" );
+    _itemFace = qfi_Renderers::createItem( ":/qfi/images/ils/ils_face.svg" );
     _itemFace->setCacheMode( QGraphicsItem::NoCache );
     _itemFace->setZValue( _faceZ );
     _itemFace->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemFace->setTransformOriginPoint( _originalVorCtr );
     _scene->addItem( _itemFace );
 
-    _itemFlagNav = new QGraphicsSvgItem( ":/qfi/images/ils/ils_flag_nav.svg" );
-    _itemFlagNav->setCacheMode( QGraphicsItem::NoCache );
-    _itemFlagNav->setZValue( _flagGsZ );
-    _itemFlagNav->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
-    _itemFlagNav->setTransformOriginPoint( _originalVorCtr );
-    _scene->addItem( _itemFlagNav );
-
-    _itemFlagGs = new QGraphicsSvgItem( ":/qfi/images/ils/ils_flag_gs.svg" );
-    _itemFlagGs->setCacheMode( QGraphicsItem::NoCache );
-    _itemFlagGs->setZValue( _flagGsZ );
-    _itemFlagGs->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
-    _itemFlagGs->setTransformOriginPoint( _originalVorCtr );
-    _scene->addItem( _itemFlagGs );
-
-    _itemHandNav = new QGraphicsSvgItem( ":/qfi/images/ils/ils_hand_nav.svg" );
+    _itemHandNav = qfi_Renderers::createItem( ":/qfi/images/ils/ils_hand_nav.svg" );
     _itemHandNav->setCacheMode( QGraphicsItem::NoCache );
     _itemHandNav->setZValue( _handNavZ );
     _itemHandNav->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemHandNav->setTransformOriginPoint( _originalHandCtr );
     _scene->addItem( _itemHandNav );
 
-    _itemHandGs = new QGraphicsSvgItem( ":/qfi/images/ils/ils_hand_gs.svg" );
+    _itemHandGs = qfi_Renderers::createItem( ":/qfi/images/ils/ils_hand_gs.svg" );
     _itemHandGs->setCacheMode( QGraphicsItem::NoCache );
     _itemHandGs->setZValue( _handGsZ );
     _itemHandGs->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemHandGs->setTransformOriginPoint( _originalHandCtr );
     _scene->addItem( _itemHandGs );
 
-    _itemCase = new QGraphicsSvgItem( ":/qfi/images/ils/ils_case.svg" );
+    _itemCase = new qfi_CachedSvgItem( ":/qfi/images/ils/ils_case.svg" );
     _itemCase->setCacheMode( QGraphicsItem::NoCache );
     _itemCase->setZValue( _caseZ );
     _itemCase->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -219,27 +339,38 @@ void qfi_ILS::reset()
     _itemFace = Q_NULLPTR;
     _itemCase = Q_NULLPTR;
 
-    _course = 0.0;
     _dotVPos_old = 0.0;
     _dotVPos = 0.0;
     _dotHPos_old = 0.0;
     _dotHPos = 0.0;
+
+    _dirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_ILS::updateView()
 {
+    QFI_PROFILE( "qfi_ILS::updateView" );
+    QFI_TRACE( "updateView", "qfi_ILS" );
+    qfi_Latency::updated( this );
+
     _itemFace->setRotation( - _course );
 
     _dotVPos_old = _dotVPos;
     _dotHPos_old = _dotHPos;
 
-    _dotVPos = -_dotV*38.0;
-    _dotHPos = _dotH*38.0;
+    _dotVPos = -_dotV*_originalPixPerDot;
+    _dotHPos = _dotH*_originalPixPerDot;
 
     _itemHandNav->moveBy(_dotHPos - _dotHPos_old, 0.0);
     _itemHandGs->moveBy(0.0, _dotVPos - _dotVPos_old);
 
+    _course_old = _course;
+    _dotH_old   = _dotH;
+    _dotV_old   = _dotV;
+
+    _dirty = false;
+
     _scene->update();
 }
@@ -26,8 +26,15 @@
 
 #include <QGraphicsView>
 #include <QGraphicsSvgItem>
+#include <QImage>
+#include <QTimer>
 
+#include <functional>
+
+#include <qfi/qfi_CachedSvgItem.h>
 #include <qfi/qfi_defs.h>
+#include <qfi/qfi_Dirty.h>
+#include <qfi/qfi_TripleBuffer.h>
 #include <qfi/qfi_enums.h>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -41,6 +48,31 @@ class QFIAPI qfi_ILS : public QGraphicsView
 
 public:
 
+    /**
+     * Instrument state, applied at once with setState(). Plain data
+     * structure, it can be copied between threads with memcpy().
+     */
+    struct State
+    {
+        double course;      ///< [deg] course
+        double dotH;        ///< normalized horizontal deviation dot position
+        double dotV;        ///< normalized vertical deviation dot position
+
+        bool visibleH;      ///< horizontal deviation dot visibility
+        bool visibleV;      ///< vertical deviation dot visibility
+
+        /**
+         * Interpolates (ratio from 0.0 to 1.0) or extrapolates (ratio greater
+         * than 1.0) between states, see qfi_StateHistory. Discrete values
+         * (flags, modes) are taken from the nearer state.
+         * @param s0 first state
+         * @param s1 second state
+         * @param ratio interpolation ratio
+         * @param result output state
+         */
+        static void interpolate( const State &s0, const State &s1, double ratio, State *result );
+    };
+
     /** Constructor. */
     explicit qfi_ILS( QWidget *parent = Q_NULLPTR );
 
@@ -53,6 +85,14 @@ public:
     /** Refreshes (redraws) widget. */
     void redraw();
 
+    /**
+     * Renders widget into the image, also when the widget is not shown
+     * (e.g. with the offscreen platform plugin). Hidden widget is resized
+     * to the image size, image itself is never reallocated.
+     * @param image target image
+     */
+    void renderImage( QImage &image );
+
     /** @param course [deg] */
     void setCourse( double course );
 
@@ -63,6 +103,30 @@ public:
      * @param deviation vertical dot visibility */
     void setDots( double dotH, double dotV, bool visibleH, bool visibleV );
 
+    /**
+     * Applies all values of the state at once, only the visibly changed ones
+     * mark the instrument dirty.
+     * @param state instrument state
+     */
+    void setState( const State &state );
+
+    /**
+     * Other threads (e.g. simulation) may publish state into this buffer
+     * without blocking, the newest state is applied on redraw.
+     * @return state buffer
+     */
+    inline qfi_TripleBuffer< State >& stateBuffer() { return _stateBuffer; }
+
+    /**
+     * Sets function called with every state passed to setState(), also with
+     * states taken from stateBuffer(), e.g. by qfi_Recorder.
+     * @param hook state hook, empty function removes hook
+     */
+    inline void setStateHook( const std::function< void( const State& ) > &hook ) { _stateHook = hook; }
+
+    /** @return number of redraws skipped because nothing has changed */
+    inline qint64 suppressedRedraws() const { return _suppressedRedraws; }
+
 protected:
 
     /** */
@@ -71,13 +135,12 @@ protected:
 private:
 
     QGraphicsScene *_scene;
+    QTimer *_resizeTimer;   ///< debounces rebuilding the scene after resizing
 
-    QGraphicsSvgItem *_itemFaceFixed;
+    qfi_CachedSvgItem *_itemFaceFixed;
     QGraphicsSvgItem *_itemFace;
     QGraphicsSvgItem *_itemTo;
     QGraphicsSvgItem *_itemFrom;
-    QGraphicsSvgItem *_itemFlagNav;
-    QGraphicsSvgItem *_itemFlagGs;
     QGraphicsSvgItem *_itemHandNav;
     QGraphicsSvgItem *_itemHandGs;
     QGraphicsSvgItem *_itemCase;
@@ -88,17 +151,32 @@ private:
     bool _visibleH;
     bool _visibleV;
 
+    double _course_old;     ///< [deg] course currently drawn
+    double _dotH_old;       ///< horizontal deviation dot position currently drawn
+    double _dotV_old;       ///< vertical deviation dot position currently drawn
+
     double _dotVPos;
     double _dotVPos_old;
     double _dotHPos;
     double _dotHPos_old;
 
+    bool _dirty;
+
+    qint64 _suppressedRedraws;
+
+    qfi_TripleBuffer< State > _stateBuffer;
+
+    std::function< void( const State& ) > _stateHook;
+
     double _scaleX;
     double _scaleY;
 
     const int _originalHeight;
     const int _originalWidth;
 
+    const double _originalFaceRadius;
+    const double _originalPixPerDot;
+
     QPointF _originalVorCtr;
     QPointF _originalHandCtr;
 
@@ -106,14 +184,15 @@ private:
     const int _handNavZ;
     const int _handGsZ;
     const int _faceZ;
-    const int _flagNavZ;
-    const int _flagGsZ;
     const int _caseZ;
 
     void init();
 
     void reset();
 
+    /** Scales the view to the current size until the scene is rebuilt. */
+    void rescale();
+
     void updateView();
 };
 
@@ -0,0 +1,91 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_INTERPOLATION_H
+#define QFI_INTERPOLATION_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Interpolation helpers used by instruments states.
+ *
+ * Ratio 0.0 gives the first value and 1.0 the second one, ratios greater
+ * than 1.0 extrapolate.
+ */
+class qfi_Interpolation
+{
+public:
+
+    /**
+     * @param v0 first value
+     * @param v1 second value
+     * @param ratio interpolation ratio
+     * @return linearly interpolated value
+     */
+    static inline double linear( double v0, double v1, double ratio )
+    {
+        return v0 + ratio * ( v1 - v0 );
+    }
+
+    /**
+     * Interpolates angle along the shorter arc, e.g. from 350 deg to 10 deg
+     * through 0 deg rather than through 180 deg. Result is not normalized.
+     * @param a0 [deg] first angle
+     * @param a1 [deg] second angle
+     * @param ratio interpolation ratio
+     * @return [deg] interpolated angle
+     */
+    static inline double angle( double a0, double a1, double ratio )
+    {
+        double delta = fmod( a1 - a0, 360.0 );
+
+        if      ( delta >  180.0 ) delta -= 360.0;
+        else if ( delta < -180.0 ) delta += 360.0;
+
+        return a0 + ratio * delta;
+    }
+
+    /**
+     * Interpolates roll angle along the shorter arc, result is normalized
+     * to range from -180 deg to 180 deg, as roll setters clamp rather than
+     * wrap it.
+     * @param a0 [deg] first angle
+     * @param a1 [deg] second angle
+     * @param ratio interpolation ratio
+     * @return [deg] interpolated angle
+     */
+    static inline double roll( double a0, double a1, double ratio )
+    {
+        double result = fmod( angle( a0, a1, ratio ) + 180.0, 360.0 );
+
+        if ( result < 0.0 ) result += 360.0;
+
+        return result - 180.0;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_INTERPOLATION_H
@@ -0,0 +1,248 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_Latency.h>
+
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <chrono>
+
+#include <qfi/qfi_PaintHook.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+QAtomicInteger< int > qfi_Latency::_active( 0 );
+
+QMutex qfi_Latency::_mutex;
+
+QHash< QObject*, qfi_Latency::Record* > qfi_Latency::_records;
+
+int qfi_Latency::_maxSamples = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+inline qint64 median( QVector< qint64 > values )
+{
+    if ( values.isEmpty() ) return 0;
+
+    std::nth_element( values.begin(), values.begin() + values.size() / 2, values.end() );
+
+    return values.at( values.size() / 2 );
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_Latency::now()
+{
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(
+                std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Latency::addView( QGraphicsView *view )
+{
+    if ( !view ) return;
+
+    QMutexLocker locker( &_mutex );
+
+    if ( _records.contains( view ) ) return;
+
+    Record *record = new Record();
+
+    record->name       = view->metaObject()->className();
+    record->stamp      = 0;
+    record->consumed   = 0;
+    record->inFlight   = 0;
+    record->updateTime = 0;
+
+    _records.insert( view, record );
+
+    // samples are recorded when painting of the view is finished
+    qfi_PaintHook::subscribe( view->viewport(), instance(), [ view ]( qint64 )
+    {
+        if ( !isActive() ) return;
+
+        const qint64 painted = now();
+
+        QMutexLocker locker( &_mutex );
+
+        Record *record = _records.value( view, Q_NULLPTR );
+
+        if ( record && record->inFlight > 0 && record->latency.size() < _maxSamples )
+        {
+            record->latency .push_back( painted - record->inFlight );
+            record->update  .push_back( record->updateTime - record->inFlight );
+            record->paint   .push_back( painted - record->updateTime );
+        }
+
+        if ( record ) record->inFlight = 0;
+    } );
+
+    // views are not accessed when being destroyed
+    connect( view, &QObject::destroyed, instance(), [ view ]()
+    {
+        QMutexLocker locker( &_mutex );
+        delete _records.take( view );
+    } );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Latency::removeView( QGraphicsView *view )
+{
+    if ( !view ) return;
+
+    QMutexLocker locker( &_mutex );
+
+    if ( !_records.contains( view ) ) return;
+
+    qfi_PaintHook::unsubscribe( view->viewport(), instance() );
+    view->disconnect( instance() );
+
+    delete _records.take( view );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Latency::start( int maxSamples )
+{
+    QMutexLocker locker( &_mutex );
+
+    _maxSamples = qMax( 1, maxSamples );
+
+    for ( QHash< QObject*, Record* >::iterator it = _records.begin(); it != _records.end(); ++it )
+    {
+        Record *record = it.value();
+
+        record->stamp      = 0;
+        record->consumed   = 0;
+        record->inFlight   = 0;
+        record->updateTime = 0;
+
+        record->latency .clear();
+        record->update  .clear();
+        record->paint   .clear();
+
+        record->latency .reserve( qMin( _maxSamples, 65536 ) );
+        record->update  .reserve( qMin( _maxSamples, 65536 ) );
+        record->paint   .reserve( qMin( _maxSamples, 65536 ) );
+    }
+
+    _active.storeRelease( 1 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Latency::stop()
+{
+    _active.storeRelease( 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Latency::stamp( QGraphicsView *view, qint64 time )
+{
+    if ( !isActive() ) return;
+
+    QMutexLocker locker( &_mutex );
+
+    Record *record = _records.value( view, Q_NULLPTR );
+
+    if ( record && time > record->stamp ) record->stamp = time;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Latency::updated( QGraphicsView *view )
+{
+    if ( !isActive() ) return;
+
+    QMutexLocker locker( &_mutex );
+
+    Record *record = _records.value( view, Q_NULLPTR );
+
+    if ( record )
+    {
+        if ( record->stamp > record->consumed )
+        {
+            record->consumed   = record->stamp;
+            record->inFlight   = record->stamp;
+            record->updateTime = now();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QList< qfi_Latency::Stats > qfi_Latency::snapshot()
+{
+    QMutexLocker locker( &_mutex );
+
+    QList< Stats > stats;
+
+    for ( QHash< QObject*, Record* >::const_iterator it = _records.constBegin();
+          it != _records.constEnd(); ++it )
+    {
+        const Record *record = it.value();
+
+        QVector< qint64 > values = record->latency;
+
+        std::sort( values.begin(), values.end() );
+
+        const int count = static_cast< int >( values.size() );
+
+        Stats instrument;
+
+        instrument.name      = record->name;
+        instrument.count     = count;
+        instrument.p50       = count > 0 ? values.at( qMin( count - 1, count * 50 / 100 ) ) / 1000 : 0;
+        instrument.p95       = count > 0 ? values.at( qMin( count - 1, count * 95 / 100 ) ) / 1000 : 0;
+        instrument.p99       = count > 0 ? values.at( qMin( count - 1, count * 99 / 100 ) ) / 1000 : 0;
+        instrument.max       = count > 0 ? values.last() / 1000 : 0;
+        instrument.updateP50 = median( record->update ) / 1000;
+        instrument.paintP50  = median( record->paint  ) / 1000;
+
+        stats.push_back( instrument );
+    }
+
+    return stats;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Latency::qfi_Latency() :
+    QObject ( Q_NULLPTR )
+{}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Latency* qfi_Latency::instance()
+{
+    static qfi_Latency latency;
+    return &latency;
+}
@@ -0,0 +1,159 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_LATENCY_H
+#define QFI_LATENCY_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QAtomicInteger>
+#include <QGraphicsView>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief End-to-end latency measurement class.
+ *
+ * Measures time from data ingestion to the end of painting the frame which
+ * displays it, per instrument. Data source stamps the instrument when data
+ * are given to it (setters called or state published, see stamp()), the
+ * stamp is taken over by the next updateView() of the instrument and
+ * a sample is recorded when painting of the instrument view is finished.
+ * When several stamps precede one updateView(), the newest one is taken,
+ * so the latency is the age of the displayed data. With the offscreen
+ * platform plugin painting ends in the offscreen backing store, so it can
+ * be measured headless.
+ *
+ * Measurement is off by default and costs a single atomic load per
+ * updateView() then.
+ *
+ * Usage:
+ * @code
+ * qfi_Latency::addView( ai );
+ * qfi_Latency::start();
+ *
+ * // new data arrived
+ * ai->setRoll( roll );
+ * qfi_Latency::stamp( ai );
+ * ...
+ * QList< qfi_Latency::Stats > stats = qfi_Latency::snapshot();
+ * @endcode
+ */
+class QFIAPI qfi_Latency : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /** Instrument latency statistics. */
+    struct Stats
+    {
+        QString name;       ///< instrument class name
+        int count;          ///< number of samples
+        qint64 p50;         ///< [us] median latency
+        qint64 p95;         ///< [us] 95th percentile latency
+        qint64 p99;         ///< [us] 99th percentile latency
+        qint64 max;         ///< [us] maximum latency
+        qint64 updateP50;   ///< [us] median time from stamp to updateView()
+        qint64 paintP50;    ///< [us] median time from updateView() to the end of painting
+    };
+
+    /** @return [ns] latency clock time (steady clock), valid across threads */
+    static qint64 now();
+
+    /**
+     * Measures latency of the view.
+     * @param view instrument
+     */
+    static void addView( QGraphicsView *view );
+
+    /** @param view instrument not to be measured anymore */
+    static void removeView( QGraphicsView *view );
+
+    /**
+     * Starts measurement, discards previously recorded samples.
+     * @param maxSamples maximum number of recorded samples per instrument
+     */
+    static void start( int maxSamples = 100000 );
+
+    /** Stops measurement, recorded samples are kept. */
+    static void stop();
+
+    /** @return true if measurement is active */
+    static inline bool isActive() { return _active.loadAcquire() != 0; }
+
+    /**
+     * Stamps data given to the instrument, it may be called from any thread.
+     * Stamp should follow setting or publishing data, so latency is rather
+     * overestimated than underestimated.
+     * @param view instrument
+     * @param time [ns] ingestion time, see now()
+     */
+    static void stamp( QGraphicsView *view, qint64 time = now() );
+
+    /**
+     * Takes over the newest stamp, called by instruments updateView().
+     * @param view instrument
+     */
+    static void updated( QGraphicsView *view );
+
+    /** @return statistics of all measured instruments */
+    static QList< Stats > snapshot();
+
+private:
+
+    /** Measured instrument. */
+    struct Record
+    {
+        QString name;                   ///< instrument class name
+        qint64 stamp;                   ///< [ns] newest stamp
+        qint64 consumed;                ///< [ns] stamp taken over by updateView()
+        qint64 inFlight;                ///< [ns] stamp waiting for painting, 0 if none
+        qint64 updateTime;              ///< [ns] time of taking over the stamp
+        QVector< qint64 > latency;      ///< [ns] latency samples
+        QVector< qint64 > update;       ///< [ns] stamp to updateView() samples
+        QVector< qint64 > paint;        ///< [ns] updateView() to painted samples
+    };
+
+    static QAtomicInteger< int > _active;
+
+    static QMutex _mutex;           ///< guards records
+
+    static QHash< QObject*, Record* > _records; ///< records indexed with views
+
+    static int _maxSamples;
+
+    qfi_Latency();
+
+    static qfi_Latency* instance();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_LATENCY_H
@@ -0,0 +1,66 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_Offscreen.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+QSize qfi_Offscreen::size( const QImage &image )
+{
+    qreal dpr = image.devicePixelRatio();
+
+    return QSize( qRound( image.width()  / dpr ),
+                  qRound( image.height() / dpr ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Offscreen::render( QGraphicsScene *scene, const QRectF &source,
+                            QImage &image, QPainter::RenderHints hints )
+{
+    if ( image.isNull() ) return;
+
+    image.fill( Qt::transparent );
+
+    QRectF target( QPointF( 0.0, 0.0 ), QSizeF( size( image ) ) );
+
+    QPainter painter( &image );
+    painter.setRenderHints( hints );
+
+    scene->render( &painter, target, source, Qt::IgnoreAspectRatio );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Offscreen::render( const qfi_DirectPainter &items, const QRectF &source,
+                            QImage &image, QPainter::RenderHints hints )
+{
+    if ( image.isNull() ) return;
+
+    image.fill( Qt::transparent );
+
+    QRectF target( QPointF( 0.0, 0.0 ), QSizeF( size( image ) ) );
+
+    QPainter painter( &image );
+    painter.setRenderHints( hints );
+
+    items.render( &painter, target, source );
+}
@@ -0,0 +1,78 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_OFFSCREEN_H
+#define QFI_OFFSCREEN_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QGraphicsScene>
+#include <QImage>
+#include <QPainter>
+#include <QRectF>
+#include <QSize>
+
+#include <qfi/qfi_defs.h>
+#include <qfi/qfi_DirectPainter.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Offscreen rendering helper class.
+ *
+ * Used by instruments to render their scenes into caller supplied images,
+ * which works without a display (e.g. with the offscreen platform plugin).
+ */
+class QFIAPI qfi_Offscreen
+{
+public:
+
+    /**
+     * @param image target image
+     * @return [px] image size in device independent pixels
+     */
+    static QSize size( const QImage &image );
+
+    /**
+     * Renders scene into the whole image. Image is cleared first but never
+     * reallocated, so the same image can be reused for every frame.
+     * @param scene scene to be rendered
+     * @param source scene rectangle to be rendered
+     * @param image target image
+     * @param hints render hints
+     */
+    static void render( QGraphicsScene *scene, const QRectF &source,
+                        QImage &image, QPainter::RenderHints hints );
+
+    /**
+     * Renders directly painted items into the whole image, see above.
+     * @param items items to be rendered
+     * @param source items rectangle to be rendered
+     * @param image target image
+     * @param hints render hints
+     */
+    static void render( const qfi_DirectPainter &items, const QRectF &source,
+                        QImage &image, QPainter::RenderHints hints );
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_OFFSCREEN_H
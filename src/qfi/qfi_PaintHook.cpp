@@ -0,0 +1,142 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_PaintHook.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_PaintHook::subscribe( QWidget *widget, QObject *subscriber, const Callback &callback )
+{
+    if ( !widget || !subscriber ) return;
+
+    qfi_PaintHook *hook = instance();
+
+    if ( !hook->_subscriptions.contains( widget ) )
+    {
+        widget->installEventFilter( hook );
+
+        // widgets are not accessed when being destroyed
+        connect( widget, &QObject::destroyed, hook, [ hook, widget ]()
+        {
+            hook->_subscriptions.remove( widget );
+        } );
+    }
+
+    QList< Subscription > &subscriptions = hook->_subscriptions[ widget ];
+
+    for ( int i = 0; i < subscriptions.size(); i++ )
+    {
+        if ( subscriptions.at( i ).subscriber == subscriber )
+        {
+            subscriptions[ i ].callback = callback;
+            return;
+        }
+    }
+
+    Subscription subscription;
+
+    subscription.subscriber = subscriber;
+    subscription.callback   = callback;
+
+    subscriptions.push_back( subscription );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_PaintHook::unsubscribe( QWidget *widget, QObject *subscriber )
+{
+    if ( !widget ) return;
+
+    qfi_PaintHook *hook = instance();
+
+    if ( !hook->_subscriptions.contains( widget ) ) return;
+
+    QList< Subscription > &subscriptions = hook->_subscriptions[ widget ];
+
+    for ( int i = subscriptions.size() - 1; i >= 0; i-- )
+    {
+        if ( subscriptions.at( i ).subscriber == subscriber )
+        {
+            subscriptions.removeAt( i );
+        }
+    }
+
+    if ( subscriptions.isEmpty() )
+    {
+        widget->removeEventFilter( hook );
+        widget->disconnect( hook );
+
+        hook->_subscriptions.remove( widget );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_PaintHook::eventFilter( QObject *object, QEvent *event )
+{
+    if ( event->type() == QEvent::Paint && !_painting )
+    {
+        // event is delivered again to the remaining filters and the widget
+        // itself, so painting can be timed as a whole
+        _painting = true;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QCoreApplication::sendEvent( object, event );
+
+        const qint64 duration = timer.nsecsElapsed();
+
+        _painting = false;
+
+        // callbacks may unsubscribe, so they are called on a copy
+        const QList< Subscription > subscriptions = _subscriptions.value( object );
+
+        for ( int i = 0; i < subscriptions.size(); i++ )
+        {
+            subscriptions.at( i ).callback( duration );
+        }
+
+        return true;
+    }
+
+    return QObject::eventFilter( object, event );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_PaintHook::qfi_PaintHook() :
+    QObject ( Q_NULLPTR ),
+
+    _painting ( false )
+{}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_PaintHook* qfi_PaintHook::instance()
+{
+    static qfi_PaintHook hook;
+    return &hook;
+}
@@ -0,0 +1,99 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_PAINTHOOK_H
+#define QFI_PAINTHOOK_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QWidget>
+
+#include <functional>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Paint timing hook class.
+ *
+ * Times painting of widgets (usually instruments viewports) and reports
+ * the duration to all subscribers of the widget. Paint event is delivered
+ * again from a single event filter to the remaining filters and the widget
+ * itself, so painting is timed as a whole and only once, no matter how many
+ * subscribers there are. Callbacks are called in the GUI thread right after
+ * painting, in the order of subscription.
+ */
+class QFIAPI qfi_PaintHook : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /** Paint callback, its argument is [ns] painting duration. */
+    typedef std::function< void( qint64 ) > Callback;
+
+    /**
+     * Subscribes to painting of the widget, a subscriber has one callback
+     * per widget, subscribing again replaces it.
+     * @param widget timed widget
+     * @param subscriber subscriber, used to unsubscribe
+     * @param callback paint callback
+     */
+    static void subscribe( QWidget *widget, QObject *subscriber, const Callback &callback );
+
+    /**
+     * Unsubscribes from painting of the widget, it has to be done before
+     * the subscriber is destroyed.
+     * @param widget timed widget
+     * @param subscriber subscriber
+     */
+    static void unsubscribe( QWidget *widget, QObject *subscriber );
+
+protected:
+
+    /** Times paint events of subscribed widgets. */
+    bool eventFilter( QObject *object, QEvent *event ) override;
+
+private:
+
+    /** Subscription. */
+    struct Subscription
+    {
+        QObject *subscriber;        ///< subscriber
+        Callback callback;          ///< paint callback
+    };
+
+    QHash< QObject*, QList< Subscription > > _subscriptions; ///< subscriptions indexed with widgets
+
+    bool _painting;                 ///< specifies if paint event is being timed
+
+    qfi_PaintHook();
+
+    static qfi_PaintHook* instance();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_PAINTHOOK_H
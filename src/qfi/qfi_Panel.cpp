@@ -0,0 +1,279 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_Panel.h>
+
+#include <QGraphicsItem>
+#include <QPainter>
+#include <QPointer>
+#include <QStyleOptionGraphicsItem>
+
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////////////
+
+class qfi_Panel::Item : public QGraphicsItem
+{
+public:
+
+    explicit Item( QGraphicsView *instrument ) :
+        _instrument ( instrument ),
+        _size ( 0.0 )
+    {
+        setFlag( QGraphicsItem::ItemUsesExtendedStyleOption );
+    }
+
+    inline QGraphicsView* instrument() const { return _instrument; }
+
+    void setSize( double size )
+    {
+        prepareGeometryChange();
+        _size = size;
+    }
+
+    QRectF boundingRect() const override
+    {
+        return QRectF( 0.0, 0.0, _size, _size );
+    }
+
+    void paint( QPainter *painter,
+                const QStyleOptionGraphicsItem *option,
+                QWidget * ) override
+    {
+        QRectF source = sourceRect();
+
+        if ( source.isEmpty() ) return;
+
+        // only the exposed part of the instrument scene is rendered
+        QRectF target = option->exposedRect & boundingRect();
+
+        if ( target.isEmpty() ) return;
+
+        double sx = source.width()  / _size;
+        double sy = source.height() / _size;
+
+        QRectF exposed( source.x() + target.x() * sx,
+                        source.y() + target.y() * sy,
+                        target.width()  * sx,
+                        target.height() * sy );
+
+        _instrument->scene()->render( painter, target, exposed, Qt::IgnoreAspectRatio );
+    }
+
+    void sceneChanged( const QList< QRectF > &rects )
+    {
+        QRectF source = sourceRect();
+
+        if ( source.isEmpty() ) return;
+
+        double sx = _size / source.width();
+        double sy = _size / source.height();
+
+        for ( int i = 0; i < rects.size(); i++ )
+        {
+            const QRectF &rect = rects.at( i );
+
+            // 1 px margin for antialiasing
+            update( QRectF( ( rect.x() - source.x() ) * sx - 1.0,
+                            ( rect.y() - source.y() ) * sy - 1.0,
+                            rect.width()  * sx + 2.0,
+                            rect.height() * sy + 2.0 ) );
+        }
+    }
+
+private:
+
+    QPointer< QGraphicsView > _instrument;
+
+    double _size;
+
+    QRectF sourceRect() const
+    {
+        if ( !_instrument || !_instrument->scene() || _size <= 0.0 ) return QRectF();
+
+        return _instrument->mapToScene( _instrument->viewport()->rect() ).boundingRect();
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Panel::qfi_Panel( QWidget *parent ) :
+    QGraphicsView ( parent ),
+
+    _scene ( Q_NULLPTR ),
+
+    _columns ( 0 )
+{
+    _scene = new QGraphicsScene( this );
+    setScene( _scene );
+
+    setHorizontalScrollBarPolicy( Qt::ScrollBarAlwaysOff );
+    setVerticalScrollBarPolicy( Qt::ScrollBarAlwaysOff );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Panel::~qfi_Panel()
+{
+    for ( int i = 0; i < _items.size(); i++ )
+    {
+        QGraphicsView *instrument = _items.at( i )->instrument();
+
+        if ( instrument ) delete instrument;
+    }
+
+    _items.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_Panel::addInstrument( QGraphicsView *instrument )
+{
+    if ( !instrument || !instrument->scene() ) return false;
+
+    for ( int i = 0; i < _items.size(); i++ )
+    {
+        if ( _items.at( i )->instrument() == instrument ) return true;
+    }
+
+    // instrument view is "shown" but never appears on the screen nor paints,
+    // so the instrument keeps redrawing its scene
+    instrument->setParent( Q_NULLPTR );
+    instrument->setAttribute( Qt::WA_DontShowOnScreen );
+    instrument->setAttribute( Qt::WA_QuitOnClose, false );
+    instrument->setUpdatesEnabled( false );
+
+    Item *item = new Item( instrument );
+    _scene->addItem( item );
+    _items.push_back( item );
+
+    connect( instrument->scene(), &QGraphicsScene::changed, this,
+             [ item ]( const QList< QRectF > &rects ) { item->sceneChanged( rects ); } );
+
+    updateLayout();
+
+    instrument->show();
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Panel::removeInstrument( QGraphicsView *instrument )
+{
+    for ( int i = 0; i < _items.size(); i++ )
+    {
+        Item *item = _items.at( i );
+
+        if ( item->instrument() == instrument )
+        {
+            disconnect( instrument->scene(), Q_NULLPTR, this, Q_NULLPTR );
+
+            _items.removeAt( i );
+            delete item;
+
+            instrument->hide();
+            instrument->setAttribute( Qt::WA_DontShowOnScreen, false );
+            instrument->setAttribute( Qt::WA_QuitOnClose, true );
+            instrument->setUpdatesEnabled( true );
+
+            updateLayout();
+
+            return;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QGraphicsView* qfi_Panel::instrument( int index ) const
+{
+    if ( index < 0 || index >= _items.size() ) return Q_NULLPTR;
+
+    return _items.at( index )->instrument();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Panel::setColumns( int columns )
+{
+    _columns = qMax( 0, columns );
+
+    updateLayout();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int qfi_Panel::columns() const
+{
+    if ( _columns > 0 ) return _columns;
+
+    int columns = static_cast< int >( ceil( sqrt( static_cast< double >( _items.size() ) ) ) );
+
+    return qMax( 1, columns );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Panel::resizeEvent( QResizeEvent *event )
+{
+    ////////////////////////////////////
+    QGraphicsView::resizeEvent( event );
+    ////////////////////////////////////
+
+    updateLayout();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Panel::updateLayout()
+{
+    QRectF rect( viewport()->rect() );
+
+    _scene->setSceneRect( rect );
+
+    if ( _items.isEmpty() ) return;
+
+    int columns = this->columns();
+    int rows    = ( _items.size() + columns - 1 ) / columns;
+
+    double cellW = rect.width()  / columns;
+    double cellH = rect.height() / rows;
+
+    // square instruments centered in cells, as in LayoutSquare
+    int size = qMax( 1, static_cast< int >( qMin( cellW, cellH ) ) );
+
+    for ( int i = 0; i < _items.size(); i++ )
+    {
+        Item *item = _items.at( i );
+
+        double x = ( i % columns ) * cellW + 0.5 * ( cellW - size );
+        double y = ( i / columns ) * cellH + 0.5 * ( cellH - size );
+
+        item->setPos( qRound( x ), qRound( y ) );
+        item->setSize( size );
+
+        if ( item->instrument() && item->instrument()->size() != QSize( size, size ) )
+        {
+            item->instrument()->resize( size, size );
+        }
+    }
+}
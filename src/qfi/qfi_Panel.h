@@ -0,0 +1,117 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_PANEL_H
+#define QFI_PANEL_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QList>
+#include <QRectF>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Multi-instrument panel widget class.
+ *
+ * Shows any number of instruments in a single scene and a single viewport,
+ * so there is only one widget to be laid out and one paint event per frame
+ * no matter how many instruments there are, and all the instruments dirty
+ * regions are merged into one update of the panel.
+ *
+ * Instruments keep their own scenes and are used as usual (setters,
+ * redraw(), qfi_FrameScheduler, etc.), but their views are never shown on
+ * the screen: every instrument is drawn by a panel item which renders its
+ * scene and which is updated whenever the scene changes.
+ *
+ * Instruments are placed in a grid filled row by row. Like LayoutSquare in
+ * the example application every instrument is square, as large as its cell
+ * allows and centered in it.
+ */
+class QFIAPI qfi_Panel : public QGraphicsView
+{
+    Q_OBJECT
+
+public:
+
+    /** Constructor. */
+    explicit qfi_Panel( QWidget *parent = Q_NULLPTR );
+
+    /** Destructor, instruments are deleted. */
+    virtual ~qfi_Panel();
+
+    /**
+     * Adds instrument to the next grid cell, panel takes ownership.
+     * Instruments without a scene (RenderBackend::Painter) are not added and
+     * ownership stays with the caller.
+     * @param instrument instrument (qfi_AI, qfi_EADI, etc.)
+     * @return true if instrument has been added (or already was), false otherwise
+     */
+    bool addInstrument( QGraphicsView *instrument );
+
+    /**
+     * Removes instrument from the panel, ownership is passed to the caller.
+     * Instrument is hidden and has no parent.
+     * @param instrument instrument to be removed
+     */
+    void removeInstrument( QGraphicsView *instrument );
+
+    /** @return number of instruments */
+    inline int count() const { return _items.size(); }
+
+    /**
+     * @param index instrument index
+     * @return instrument
+     */
+    QGraphicsView* instrument( int index ) const;
+
+    /** @param columns number of grid columns, 0 means as square grid as possible (default) */
+    void setColumns( int columns );
+
+    /** @return number of grid columns */
+    int columns() const;
+
+protected:
+
+    /** */
+    void resizeEvent( QResizeEvent *event ) override;
+
+private:
+
+    /** Panel item drawing single instrument. */
+    class Item;
+
+    QGraphicsScene *_scene;     ///< panel scene
+
+    QList< Item* > _items;      ///< instruments items
+
+    int _columns;               ///< number of grid columns, 0 means as square grid as possible
+
+    void updateLayout();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_PANEL_H
@@ -0,0 +1,238 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_ParallelRenderer.h>
+
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QPainter>
+#include <QRunnable>
+
+#include <qfi/qfi_Offscreen.h>
+#include <qfi/qfi_Trace.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+class qfi_ParallelRenderer::Task : public QRunnable
+{
+public:
+
+    Task( QGraphicsScene *scene, qfi_ParallelRenderer::Target *target ) :
+        _scene  ( scene  ),
+        _target ( target ),
+        _name   ( target->view->metaObject()->className() )
+    {}
+
+    void run() override
+    {
+        QFI_TRACE( "render", _name );
+
+        qfi_Offscreen::render( _scene, _target->source,
+                               _target->image, _target->hints );
+    }
+
+private:
+
+    QGraphicsScene *_scene;
+    qfi_ParallelRenderer::Target *_target;
+    const char *_name;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_ParallelRenderer::qfi_ParallelRenderer( QObject *parent ) :
+    QObject ( parent ),
+
+    _pool ( Q_NULLPTR ),
+
+    _frameTime ( 0 )
+{
+    _pool = new QThreadPool( this );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_ParallelRenderer::~qfi_ParallelRenderer()
+{
+    _pool->waitForDone();
+
+    for ( int i = 0; i < _targets.size(); i++ )
+    {
+        if ( _targets.at( i )->view )
+        {
+            _targets.at( i )->view->viewport()->removeEventFilter( this );
+        }
+
+        delete _targets.at( i );
+    }
+
+    _targets.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ParallelRenderer::addView( QGraphicsView *view )
+{
+    if ( !view || find( view->viewport() ) ) return;
+
+    Target *target = new Target();
+
+    target->view  = view;
+    target->ready = false;
+
+    _targets.push_back( target );
+
+    view->viewport()->installEventFilter( this );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ParallelRenderer::removeView( QGraphicsView *view )
+{
+    if ( !view ) return;
+
+    Target *target = find( view->viewport() );
+
+    if ( target )
+    {
+        view->viewport()->removeEventFilter( this );
+        view->viewport()->update();
+
+        _targets.removeAll( target );
+        delete target;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ParallelRenderer::setMaxThreads( int maxThreads )
+{
+    _pool->setMaxThreadCount( maxThreads );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int qfi_ParallelRenderer::maxThreads() const
+{
+    return _pool->maxThreadCount();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_ParallelRenderer::render()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for ( int i = 0; i < _targets.size(); i++ )
+    {
+        Target *target = _targets.at( i );
+
+        target->ready = false;
+
+        if ( !target->view || !target->view->scene() || !target->view->isVisible() )
+        {
+            continue;
+        }
+
+        QWidget *viewport = target->view->viewport();
+
+        qreal dpr = viewport->devicePixelRatioF();
+
+        QSize size( qRound( viewport->width()  * dpr ),
+                    qRound( viewport->height() * dpr ) );
+
+        if ( size.isEmpty() ) continue;
+
+        // back buffer is reallocated only when the view is resized
+        if ( target->image.size() != size )
+        {
+            target->image = QImage( size, QImage::Format_ARGB32_Premultiplied );
+        }
+
+        target->image.setDevicePixelRatio( dpr );
+
+        target->source = target->view->mapToScene( viewport->rect() ).boundingRect();
+        target->hints  = target->view->renderHints();
+
+        _pool->start( new Task( target->view->scene(), target ) );
+    }
+
+    _pool->waitForDone();
+
+    for ( int i = 0; i < _targets.size(); i++ )
+    {
+        Target *target = _targets.at( i );
+
+        if ( target->view && target->view->isVisible() && !target->image.isNull() )
+        {
+            target->ready = true;
+            target->view->viewport()->update();
+        }
+    }
+
+    _frameTime = timer.nsecsElapsed() / 1000;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_ParallelRenderer::eventFilter( QObject *object, QEvent *event )
+{
+    if ( event->type() == QEvent::Paint )
+    {
+        Target *target = find( object );
+
+        if ( target && target->ready )
+        {
+            QWidget *viewport = target->view->viewport();
+
+            // view resized since the frame has been rendered, it paints itself
+            if ( qfi_Offscreen::size( target->image ) != viewport->size() )
+            {
+                return QObject::eventFilter( object, event );
+            }
+
+            QFI_TRACE( "present", target->view->metaObject()->className() );
+
+            QPainter painter( viewport );
+            painter.drawImage( QPointF( 0.0, 0.0 ), target->image );
+
+            return true;
+        }
+    }
+
+    return QObject::eventFilter( object, event );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_ParallelRenderer::Target* qfi_ParallelRenderer::find( QObject *viewport )
+{
+    for ( int i = 0; i < _targets.size(); i++ )
+    {
+        if ( _targets.at( i )->view && _targets.at( i )->view->viewport() == viewport )
+        {
+            return _targets.at( i );
+        }
+    }
+
+    return Q_NULLPTR;
+}
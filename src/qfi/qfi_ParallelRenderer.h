@@ -0,0 +1,127 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_PARALLELRENDERER_H
+#define QFI_PARALLELRENDERER_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QGraphicsView>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QRectF>
+#include <QThreadPool>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Parallel renderer class.
+ *
+ * Renders scenes of several instruments at once, one worker thread task per
+ * instrument, each into its own back buffer. The views then only present
+ * finished frames instead of painting their scenes on the GUI thread.
+ *
+ * Usage:
+ * @code
+ * qfi_Renderers::setShared( false );   // before creating instruments
+ * ...
+ * renderer->addView( ai );
+ * renderer->addView( alt );
+ * ...
+ * // every frame
+ * ai->setRoll( roll );
+ * ai->redraw();
+ * ...
+ * renderer->render();
+ * @endcode
+ *
+ * Scenes must not be modified while render() is running, it returns when
+ * all frames are done. Renderers sharing must be disabled (see
+ * qfi_Renderers::setShared()) as QSvgRenderer is not thread safe. Items
+ * rasterize and draw QImage only (see qfi_Cache), QPixmap is not used on
+ * worker threads.
+ */
+class QFIAPI qfi_ParallelRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /** Constructor. */
+    explicit qfi_ParallelRenderer( QObject *parent = Q_NULLPTR );
+
+    /** Destructor. */
+    virtual ~qfi_ParallelRenderer();
+
+    /** @param view view to be rendered */
+    void addView( QGraphicsView *view );
+
+    /** @param view view not to be rendered anymore */
+    void removeView( QGraphicsView *view );
+
+    /** @param maxThreads maximum number of worker threads */
+    void setMaxThreads( int maxThreads );
+
+    /** @return maximum number of worker threads */
+    int maxThreads() const;
+
+    /** Renders all visible views, blocks until all frames are done. */
+    void render();
+
+    /** @return [us] duration of the last render() call */
+    inline qint64 frameTime() const { return _frameTime; }
+
+protected:
+
+    /** Presents finished frames instead of painting the scenes. */
+    bool eventFilter( QObject *object, QEvent *event ) override;
+
+private:
+
+    /** Render target. */
+    struct Target
+    {
+        QPointer< QGraphicsView > view;     ///< rendered view
+        QImage image;                       ///< back buffer
+        QRectF source;                      ///< rendered scene rectangle
+        QPainter::RenderHints hints;        ///< render hints
+        bool ready;                         ///< specifies if frame is ready to present
+    };
+
+    /** Worker thread task. */
+    class Task;
+
+    QList< Target* > _targets;  ///< render targets
+
+    QThreadPool *_pool;         ///< worker threads pool
+
+    qint64 _frameTime;          ///< [us] duration of the last render() call
+
+    Target* find( QObject *viewport );
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_PARALLELRENDERER_H
@@ -0,0 +1,138 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_Profiler.h>
+
+#include <QMutexLocker>
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Profiler::Sample qfi_Profiler::_samples[ _capacity ];
+
+QAtomicInteger< quint32 > qfi_Profiler::_next( 0 );
+
+QMutex qfi_Profiler::_mutex;
+
+QStringList qfi_Profiler::_names;
+QHash< QString, int > qfi_Profiler::_ids;
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_Profiler::isEnabled()
+{
+#   ifdef QFI_PROFILING
+    return true;
+#   else
+    return false;
+#   endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int qfi_Profiler::id( const QString &name )
+{
+    QMutexLocker locker( &_mutex );
+
+    QHash< QString, int >::const_iterator it = _ids.constFind( name );
+
+    if ( it != _ids.constEnd() ) return it.value();
+
+    int id = static_cast< int >( _names.size() );
+
+    _names.push_back( name );
+    _ids.insert( name, id );
+
+    return id;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Profiler::record( int id, qint64 nsec )
+{
+    if ( id < 0 ) return;
+
+    Sample &sample = _samples[ _next.fetchAndAddRelaxed( 1 ) % _capacity ];
+
+    // invalidated while being written, so readers skip it
+    sample.id.storeRelaxed( -1 );
+    sample.nsec = nsec;
+    sample.id.storeRelease( id + 1 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QList< qfi_Profiler::Stats > qfi_Profiler::snapshot()
+{
+    QHash< int, QList< qint64 > > durations;
+
+    for ( int i = 0; i < _capacity; i++ )
+    {
+        int id = _samples[ i ].id.loadAcquire() - 1;
+
+        if ( id >= 0 )
+        {
+            durations[ id ].push_back( _samples[ i ].nsec );
+        }
+    }
+
+    QStringList names;
+    {
+        QMutexLocker locker( &_mutex );
+        names = _names;
+    }
+
+    QList< Stats > stats;
+
+    for ( QHash< int, QList< qint64 > >::iterator it = durations.begin();
+          it != durations.end(); ++it )
+    {
+        QList< qint64 > &values = it.value();
+
+        std::sort( values.begin(), values.end() );
+
+        const int count = static_cast< int >( values.size() );
+
+        Stats layer;
+
+        layer.name  = it.key() < names.size() ? names.at( it.key() ) : QString();
+        layer.count = count;
+        layer.p50   = values.at( qMin( count - 1, count * 50 / 100 ) );
+        layer.p95   = values.at( qMin( count - 1, count * 95 / 100 ) );
+        layer.p99   = values.at( qMin( count - 1, count * 99 / 100 ) );
+        layer.max   = values.last();
+
+        stats.push_back( layer );
+    }
+
+    return stats;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Profiler::reset()
+{
+    for ( int i = 0; i < _capacity; i++ )
+    {
+        _samples[ i ].id.storeRelease( 0 );
+    }
+}
@@ -0,0 +1,137 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_PROFILER_H
+#define QFI_PROFILER_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef QFI_PROFILING
+#   define QFI_PROFILE( name ) \
+        static const int qfi_profile_id = qfi_Profiler::id( name ); \
+        qfi_Profiler::Scope qfi_profile_scope( qfi_profile_id )
+#   define QFI_PROFILE_ID( id ) \
+        qfi_Profiler::Scope qfi_profile_scope( id )
+#else
+#   define QFI_PROFILE( name )
+#   define QFI_PROFILE_ID( id )
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Paint time profiler class.
+ *
+ * Records durations of painting instruments layers and of instruments
+ * updateView() calls into a lock-free ring buffer. Recording is compiled in
+ * only when QFI_PROFILING is defined (CONFIG += qfi_profiling), otherwise
+ * snapshots are always empty.
+ *
+ * Samples written concurrently with taking a snapshot may be missed or
+ * attributed to a wrong layer, which is acceptable for statistics.
+ */
+class QFIAPI qfi_Profiler
+{
+public:
+
+    /** Layer statistics. */
+    struct Stats
+    {
+        QString name;   ///< layer name
+        int count;      ///< number of samples
+        qint64 p50;     ///< [ns] median duration
+        qint64 p95;     ///< [ns] 95th percentile duration
+        qint64 p99;     ///< [ns] 99th percentile duration
+        qint64 max;     ///< [ns] maximum duration
+    };
+
+    /** Records duration of the enclosing scope. */
+    class QFIAPI Scope
+    {
+    public:
+
+        explicit Scope( int id ) : _id ( id ) { _timer.start(); }
+
+        ~Scope() { record( _id, _timer.nsecsElapsed() ); }
+
+    private:
+
+        int _id;                ///< layer ID
+        QElapsedTimer _timer;   ///< timer
+    };
+
+    /** @return true if profiling is compiled in */
+    static bool isEnabled();
+
+    /**
+     * @param name layer name, e.g. resource path
+     * @return layer ID, the same for the same names
+     */
+    static int id( const QString &name );
+
+    /**
+     * @param id layer ID
+     * @param nsec [ns] duration
+     */
+    static void record( int id, qint64 nsec );
+
+    /** @return statistics of all layers recorded in the ring buffer */
+    static QList< Stats > snapshot();
+
+    /** Discards all recorded samples. */
+    static void reset();
+
+private:
+
+    /** Ring buffer sample. */
+    struct Sample
+    {
+        QAtomicInteger< int > id;   ///< layer ID plus 1, 0 if empty
+        qint64 nsec;                ///< [ns] duration
+    };
+
+    static const int _capacity = 65536; ///< ring buffer capacity
+
+    static Sample _samples[ _capacity ];
+
+    static QAtomicInteger< quint32 > _next;
+
+    static QMutex _mutex;           ///< guards layers names
+
+    static QStringList _names;
+    static QHash< QString, int > _ids;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_PROFILER_H
@@ -0,0 +1,221 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_QualityGovernor.h>
+
+#include <qfi/qfi_FrameScheduler.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_QualityGovernor::qfi_QualityGovernor( qfi_FrameScheduler *scheduler,
+                                          QObject *parent ) :
+    QObject ( parent ),
+
+    _scheduler ( scheduler ),
+
+    _budget          ( 0 ),
+    _coarseAtlasStep ( 6.0 ),
+    _frameCost       ( 0.0 ),
+
+    _level      ( 0 ),
+    _holdFrames ( 30 ),
+    _heldFrames ( 0 )
+{
+    if ( _scheduler )
+    {
+        connect( _scheduler, &qfi_FrameScheduler::frame, this, &qfi_QualityGovernor::onFrame );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_QualityGovernor::~qfi_QualityGovernor()
+{
+    for ( int i = 0; i < _instruments.size(); i++ )
+    {
+        apply( _instruments.at( i ), 0 );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_QualityGovernor::removeInstrument( QGraphicsView *instrument )
+{
+    for ( int i = _instruments.size() - 1; i >= 0; i-- )
+    {
+        if ( _instruments.at( i ).view == instrument )
+        {
+            apply( _instruments.at( i ), 0 );
+            _instruments.removeAt( i );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_QualityGovernor::setBudget( qint64 budget )
+{
+    _budget = qMax( Q_INT64_C( 0 ), budget );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_QualityGovernor::budget() const
+{
+    if ( _budget > 0 || !_scheduler ) return _budget;
+
+    return static_cast< qint64 >( 0.8e6 / _scheduler->targetRate() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_QualityGovernor::setCoarseAtlasStep( double step )
+{
+    _coarseAtlasStep = qMax( 0.0, step );
+
+    for ( int i = 0; i < _instruments.size(); i++ )
+    {
+        apply( _instruments.at( i ), _level );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_QualityGovernor::setHoldFrames( int frames )
+{
+    _holdFrames = qMax( 1, frames );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_QualityGovernor::setLevel( int level )
+{
+    level = qBound( 0, level, maxLevel() );
+
+    _heldFrames = 0;
+
+    if ( level == _level ) return;
+
+    _level = level;
+
+    for ( int i = 0; i < _instruments.size(); i++ )
+    {
+        apply( _instruments.at( i ), _level );
+    }
+
+    emit levelChanged( _level );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_QualityGovernor::addView( QGraphicsView *view, Priority priority,
+                                   const std::function< void( double ) > &setAtlasStep )
+{
+    if ( !view ) return;
+
+    removeInstrument( view );
+
+    Instrument instrument;
+
+    instrument.view         = view;
+    instrument.priority     = priority;
+    instrument.hints        = view->renderHints();
+    instrument.setAtlasStep = setAtlasStep;
+
+    _instruments.push_back( instrument );
+
+    apply( instrument, _level );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_QualityGovernor::apply( const Instrument &instrument, int level )
+{
+    if ( !instrument.view ) return;
+
+    bool fastHints   = false;
+    bool coarseAtlas = false;
+    int  divider     = 1;
+
+    switch ( instrument.priority )
+    {
+        case Priority::Primary:
+            break;
+
+        case Priority::Secondary:
+            fastHints   = level >= 2;
+            coarseAtlas = level >= 3;
+            divider     = level >= 4 ? 2 : 1;
+            break;
+
+        case Priority::Low:
+            fastHints   = level >= 1;
+            coarseAtlas = level >= 1;
+            divider     = level >= 3 ? 4 : ( level >= 2 ? 2 : 1 );
+            break;
+    }
+
+    QPainter::RenderHints hints = instrument.hints;
+
+    if ( fastHints )
+    {
+        hints &= ~( QPainter::Antialiasing | QPainter::SmoothPixmapTransform );
+    }
+
+    if ( instrument.view->renderHints() != hints )
+    {
+        instrument.view->setRenderHints( hints );
+    }
+
+    if ( instrument.setAtlasStep )
+    {
+        instrument.setAtlasStep( coarseAtlas ? _coarseAtlasStep : 0.0 );
+    }
+
+    if ( _scheduler )
+    {
+        _scheduler->setDivider( instrument.view, divider );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_QualityGovernor::onFrame()
+{
+    qint64 cost = _scheduler->frameCost();
+
+    if ( cost <= 0 ) return;
+
+    _frameCost = ( _frameCost > 0.0 ) ? 0.9 * _frameCost + 0.1 * cost : cost;
+
+    if ( ++_heldFrames < _holdFrames ) return;
+
+    double budget = static_cast< double >( this->budget() );
+
+    if ( _frameCost > budget && _level < maxLevel() )
+    {
+        setLevel( _level + 1 );
+    }
+    else if ( _frameCost < 0.6 * budget && _level > 0 )
+    {
+        setLevel( _level - 1 );
+    }
+}
@@ -0,0 +1,190 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_QUALITYGOVERNOR_H
+#define QFI_QUALITYGOVERNOR_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QGraphicsView>
+#include <QList>
+#include <QObject>
+#include <QPainter>
+#include <QPointer>
+
+#include <functional>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+class qfi_FrameScheduler;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Quality governor class.
+ *
+ * Watches frame cost reported by qfi_FrameScheduler against the frame budget
+ * and, when the budget is exceeded, switches instruments to cheaper paths
+ * step by step, low priority instruments first:
+ *
+ * | level | Low                                | Secondary                          |
+ * |-------|------------------------------------|------------------------------------|
+ * | 1     | no antialiasing, coarse atlas      |                                    |
+ * | 2     | half update rate                   | no antialiasing                    |
+ * | 3     | quarter update rate                | coarse atlas                       |
+ * | 4     |                                    | half update rate                   |
+ *
+ * Primary instruments (e.g. qfi_EADI, qfi_AI) are always drawn at full
+ * quality and full rate. Quality is restored step by step when the frame
+ * cost falls well below the budget. Level is held for a number of frames
+ * after every change, so it does not oscillate.
+ *
+ * Coarse atlas applies to instruments drawn from pre-rotated frames
+ * (see e.g. qfi_HI::setAtlasStep()), the atlas step is increased to
+ * the coarse step or the atlas is enabled if it has been disabled.
+ */
+class QFIAPI qfi_QualityGovernor : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /** Instrument priority. */
+    enum class Priority
+    {
+        Primary = 0,    ///< never degraded, e.g. qfi_EADI, qfi_AI
+        Secondary,      ///< degraded after the low priority ones
+        Low             ///< degraded first, e.g. qfi_TC, qfi_VOR
+    };
+
+    /** @return maximum degradation level */
+    static inline int maxLevel() { return 4; }
+
+    /**
+     * Constructor.
+     * @param scheduler frame scheduler driving the governed instruments
+     */
+    explicit qfi_QualityGovernor( qfi_FrameScheduler *scheduler,
+                                  QObject *parent = Q_NULLPTR );
+
+    /** Destructor, full quality is restored. */
+    virtual ~qfi_QualityGovernor();
+
+    /**
+     * Adds governed instrument, it has to be registered in the scheduler.
+     * @param instrument instrument (qfi_AI, qfi_EADI, etc.)
+     * @param priority instrument priority
+     */
+    template < class T >
+    inline void addInstrument( T *instrument, Priority priority )
+    {
+        addView( instrument, priority, atlasSetter( instrument, 0 ) );
+    }
+
+    /** @param instrument instrument not to be governed anymore, full quality is restored */
+    void removeInstrument( QGraphicsView *instrument );
+
+    /**
+     * @param budget [us] frame budget, 0 means 80% of the scheduler frame
+     * period (default)
+     */
+    void setBudget( qint64 budget );
+
+    /** @return [us] effective frame budget */
+    qint64 budget() const;
+
+    /** @param step [deg] coarse atlas step (default 6 deg) */
+    void setCoarseAtlasStep( double step );
+
+    /** @param frames number of frames level is held after a change (default 30) */
+    void setHoldFrames( int frames );
+
+    /**
+     * Sets degradation level at once, e.g. when the load is known in advance.
+     * @param level degradation level from 0 (full quality) to maxLevel()
+     */
+    void setLevel( int level );
+
+    /** @return current degradation level */
+    inline int level() const { return _level; }
+
+    /** @return [us] smoothed frame cost */
+    inline double frameCost() const { return _frameCost; }
+
+signals:
+
+    /** Emitted when degradation level changes. */
+    void levelChanged( int level );
+
+private:
+
+    /** Governed instrument. */
+    struct Instrument
+    {
+        QPointer< QGraphicsView > view;                 ///< instrument
+        Priority priority;                              ///< instrument priority
+        QPainter::RenderHints hints;                    ///< original render hints
+        std::function< void( double ) > setAtlasStep;   ///< coarse atlas step setter, 0 restores original step
+    };
+
+    QList< Instrument > _instruments;       ///< governed instruments
+
+    QPointer< qfi_FrameScheduler > _scheduler;  ///< frame scheduler
+
+    qint64 _budget;             ///< [us] frame budget, 0 means 80% of the frame period
+    double _coarseAtlasStep;    ///< [deg] coarse atlas step
+    double _frameCost;          ///< [us] smoothed frame cost
+
+    int _level;                 ///< degradation level
+    int _holdFrames;            ///< number of frames level is held after a change
+    int _heldFrames;            ///< number of frames since the last level change
+
+    template < class T >
+    static auto atlasSetter( T *instrument, int )
+        -> decltype( instrument->setAtlasStep( 0.0 ), std::function< void( double ) >() )
+    {
+        double original = instrument->atlasStep();
+
+        return [ instrument, original ]( double step )
+        {
+            instrument->setAtlasStep( step > 0.0 ? qMax( original, step ) : original );
+        };
+    }
+
+    template < class T >
+    static std::function< void( double ) > atlasSetter( T *, long )
+    {
+        return std::function< void( double ) >();
+    }
+
+    void addView( QGraphicsView *view, Priority priority,
+                  const std::function< void( double ) > &setAtlasStep );
+
+    void apply( const Instrument &instrument, int level );
+
+    void onFrame();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_QUALITYGOVERNOR_H
@@ -0,0 +1,585 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_Recorder.h>
+
+#include <QMutexLocker>
+#include <QThread>
+
+#include <qfi/qfi_AI.h>
+#include <qfi/qfi_ALT.h>
+#include <qfi/qfi_ASI.h>
+#include <qfi/qfi_EADI.h>
+#include <qfi/qfi_EHSI.h>
+#include <qfi/qfi_HI.h>
+#include <qfi/qfi_ILS.h>
+#include <qfi/qfi_TC.h>
+#include <qfi/qfi_VOR.h>
+#include <qfi/qfi_VSI.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef qfi_FlightLog::Column Column;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+/** Writer thread. */
+class WriterThread : public QThread
+{
+public:
+
+    explicit WriterThread( const std::function< void() > &function ) :
+        _function ( function )
+    {}
+
+protected:
+
+    void run() override { _function(); }
+
+private:
+
+    std::function< void() > _function;
+};
+
+inline double toValue( double value )
+{
+    return value;
+}
+
+inline double toValue( int value )
+{
+    return static_cast< double >( value );
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Recorder::qfi_Recorder( int chunkSize, int maxChunks ) :
+    _chunkSize ( qMax( 1, chunkSize ) ),
+    _maxChunks ( qMax( 1, maxChunks ) ),
+
+    _thread ( Q_NULLPTR ),
+
+    _writer ( 1 ),
+
+    _samples        ( 0 ),
+    _droppedSamples ( 0 ),
+
+    _stopping ( false ),
+    _failed   ( false )
+{}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Recorder::~qfi_Recorder()
+{
+    stop();
+
+    for ( int i = 0; i < _hooks.size(); i++ )
+    {
+        if ( _hooks.at( i ).object ) _hooks.at( i ).remove();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+quint32 qfi_Recorder::addInstrument( qfi_AI *instrument )
+{
+    static const Column columns[] = { Column::Roll, Column::Pitch };
+
+    const quint32 source = addSource( columns, 2 );
+
+    instrument->setStateHook( [ this, source ]( const qfi_AI::State &state )
+    {
+        const double values[] = { toValue( state.roll ), toValue( state.pitch ) };
+        record( source, values );
+    } );
+
+    addHook( instrument, [ instrument ]() { instrument->setStateHook( Q_NULLPTR ); } );
+
+    return source;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+quint32 qfi_Recorder::addInstrument( qfi_ALT *instrument )
+{
+    static const Column columns[] = { Column::Altitude, Column::Pressure };
+
+    const quint32 source = addSource( columns, 2 );
+
+    instrument->setStateHook( [ this, source ]( const qfi_ALT::State &state )
+    {
+        const double values[] = { toValue( state.altitude ), toValue( state.pressure ) };
+        record( source, values );
+    } );
+
+    addHook( instrument, [ instrument ]() { instrument->setStateHook( Q_NULLPTR ); } );
+
+    return source;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+quint32 qfi_Recorder::addInstrument( qfi_ASI *instrument )
+{
+    static const Column columns[] = { Column::Airspeed };
+
+    const quint32 source = addSource( columns, 1 );
+
+    instrument->setStateHook( [ this, source ]( const qfi_ASI::State &state )
+    {
+        const double values[] = { toValue( state.airspeed ) };
+        record( source, values );
+    } );
+
+    addHook( instrument, [ instrument ]() { instrument->setStateHook( Q_NULLPTR ); } );
+
+    return source;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+quint32 qfi_Recorder::addInstrument( qfi_EADI *instrument )
+{
+    static const Column columns[] =
+    {
+        Column::Roll, Column::Pitch, Column::AngleOfAttack, Column::Sideslip,
+        Column::SlipSkid, Column::TurnRate, Column::DotH, Column::DotV,
+        Column::FdRoll, Column::FdPitch, Column::Altitude, Column::Pressure,
+        Column::Airspeed, Column::MachNo, Column::Heading, Column::ClimbRate,
+        Column::AirspeedSel, Column::AltitudeSel, Column::HeadingSel,
+        Column::Vfe, Column::Vne, Column::FltMode, Column::SpdMode,
+        Column::LNAV, Column::VNAV, Column::PressureMode, Column::Flags
+    };
+
+    const quint32 source = addSource( columns, sizeof( columns ) / sizeof( columns[ 0 ] ) );
+
+    instrument->setStateHook( [ this, source ]( const qfi_EADI::State &state )
+    {
+        const int flags = ( state.stall       ? qfi_FlightLog::Stall       : 0 )
+                        | ( state.fpmVisible  ? qfi_FlightLog::FpmVisible  : 0 )
+                        | ( state.fdVisible   ? qfi_FlightLog::FdVisible   : 0 )
+                        | ( state.dotVisibleH ? qfi_FlightLog::DotVisibleH : 0 )
+                        | ( state.dotVisibleV ? qfi_FlightLog::DotVisibleV : 0 );
+
+        // values are converted to column units, the reverse of qfi_States
+        const double pressureCoef = ( state.pressureMode == qfi_EADI::PressureMode::MB ) ? 33.86 : 1.0;
+
+        const double values[] =
+        {
+            toValue( state.roll        ), toValue( state.pitch       ),
+            toValue( state.aoa         ), toValue( state.sideslip    ),
+            toValue( state.slipSkid    ), toValue( state.turnRate * 6.0 ),
+            toValue( state.dotH        ), toValue( state.dotV        ),
+            toValue( state.fdRoll      ), toValue( state.fdPitch     ),
+            toValue( state.altitude    ), toValue( state.pressure / pressureCoef ),
+            toValue( state.airspeed    ), toValue( state.machNo      ),
+            toValue( state.heading     ), toValue( state.climbRate * 1000.0 ),
+            toValue( state.airspeedSel ), toValue( state.altitudeSel ),
+            toValue( state.headingSel  ),
+            toValue( state.vfe         ), toValue( state.vne         ),
+            toValue( static_cast< int >( state.fltMode      ) ),
+            toValue( static_cast< int >( state.spdMode      ) ),
+            toValue( static_cast< int >( state.lnav         ) ),
+            toValue( static_cast< int >( state.vnav         ) ),
+            toValue( static_cast< int >( state.pressureMode ) ),
+            toValue( flags )
+        };
+
+        record( source, values );
+    } );
+
+    addHook( instrument, [ instrument ]() { instrument->setStateHook( Q_NULLPTR ); } );
+
+    return source;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+quint32 qfi_Recorder::addInstrument( qfi_EHSI *instrument )
+{
+    static const Column columns[] =
+    {
+        Column::Heading, Column::Course, Column::Bearing, Column::Deviation,
+        Column::Distance, Column::HeadingSel, Column::CDI, Column::Flags
+    };
+
+    const quint32 source = addSource( columns, sizeof( columns ) / sizeof( columns[ 0 ] ) );
+
+    instrument->setStateHook( [ this, source ]( const qfi_EHSI::State &state )
+    {
+        const int flags = ( state.bearingVisible  ? qfi_FlightLog::BearingVisible  : 0 )
+                        | ( state.distanceVisible ? qfi_FlightLog::DistanceVisible : 0 );
+
+        const double values[] =
+        {
+            toValue( state.heading    ), toValue( state.course    ),
+            toValue( state.bearing    ), toValue( state.deviation ),
+            toValue( state.distance   ), toValue( state.headingSel ),
+            toValue( static_cast< int >( state.cdi ) ),
+            toValue( flags )
+        };
+
+        record( source, values );
+    } );
+
+    addHook( instrument, [ instrument ]() { instrument->setStateHook( Q_NULLPTR ); } );
+
+    return source;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+quint32 qfi_Recorder::addInstrument( qfi_HI *instrument )
+{
+    static const Column columns[] = { Column::Heading };
+
+    const quint32 source = addSource( columns, 1 );
+
+    instrument->setStateHook( [ this, source ]( const qfi_HI::State &state )
+    {
+        const double values[] = { toValue( state.heading ) };
+        record( source, values );
+    } );
+
+    addHook( instrument, [ instrument ]() { instrument->setStateHook( Q_NULLPTR ); } );
+
+    return source;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+quint32 qfi_Recorder::addInstrument( qfi_ILS *instrument )
+{
+    static const Column columns[] = { Column::Course, Column::DotH, Column::DotV, Column::Flags };
+
+    const quint32 source = addSource( columns, 4 );
+
+    instrument->setStateHook( [ this, source ]( const qfi_ILS::State &state )
+    {
+        const int flags = ( state.visibleH ? qfi_FlightLog::DotVisibleH : 0 )
+                        | ( state.visibleV ? qfi_FlightLog::DotVisibleV : 0 );
+
+        const double values[] =
+        {
+            toValue( state.course ), toValue( state.dotH ), toValue( state.dotV ), toValue( flags )
+        };
+
+        record( source, values );
+    } );
+
+    addHook( instrument, [ instrument ]() { instrument->setStateHook( Q_NULLPTR ); } );
+
+    return source;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+quint32 qfi_Recorder::addInstrument( qfi_TC *instrument )
+{
+    static const Column columns[] = { Column::TurnRate, Column::SlipSkid };
+
+    const quint32 source = addSource( columns, 2 );
+
+    instrument->setStateHook( [ this, source ]( const qfi_TC::State &state )
+    {
+        // TC ball angle of full scale slip or skid, see qfi_States
+        const double values[] = { toValue( state.turnRate ), toValue( state.slipSkid / 15.0 ) };
+        record( source, values );
+    } );
+
+    addHook( instrument, [ instrument ]() { instrument->setStateHook( Q_NULLPTR ); } );
+
+    return source;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+quint32 qfi_Recorder::addInstrument( qfi_VOR *instrument )
+{
+    static const Column columns[] = { Column::Course, Column::Deviation, Column::CDI };
+
+    const quint32 source = addSource( columns, 3 );
+
+    instrument->setStateHook( [ this, source ]( const qfi_VOR::State &state )
+    {
+        const double values[] =
+        {
+            toValue( state.course ), toValue( state.deviation ), toValue( static_cast< int >( state.cdi ) )
+        };
+
+        record( source, values );
+    } );
+
+    addHook( instrument, [ instrument ]() { instrument->setStateHook( Q_NULLPTR ); } );
+
+    return source;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+quint32 qfi_Recorder::addInstrument( qfi_VSI *instrument )
+{
+    static const Column columns[] = { Column::ClimbRate };
+
+    const quint32 source = addSource( columns, 1 );
+
+    instrument->setStateHook( [ this, source ]( const qfi_VSI::State &state )
+    {
+        const double values[] = { toValue( state.climbRate ) };
+        record( source, values );
+    } );
+
+    addHook( instrument, [ instrument ]() { instrument->setStateHook( Q_NULLPTR ); } );
+
+    return source;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_Recorder::start( const QString &fileName )
+{
+    stop();
+
+    if ( !_writer.open( fileName ) ) return false;
+
+    // all the memory used while recording is allocated here
+    _buffers.resize( _maxChunks );
+
+    for ( int i = 0; i < _buffers.size(); i++ )
+    {
+        Buffer &buffer = _buffers[ i ];
+
+        buffer.source = 0;
+        buffer.count  = 0;
+        buffer.time   .resize( _chunkSize );
+        buffer.values .resize( _chunkSize * qfi_FlightLog::_columns );
+
+        _free.push_back( &buffer );
+    }
+
+    for ( int i = 0; i < _sources.size(); i++ )
+    {
+        _sources[ i ].buffer = Q_NULLPTR;
+    }
+
+    _samples        = 0;
+    _droppedSamples = 0;
+
+    _stopping = false;
+    _failed   = false;
+
+    _clock.start();
+
+    _thread = new WriterThread( [ this ]() { write(); } );
+    _thread->start();
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Recorder::stop()
+{
+    if ( !_thread ) return;
+
+    flush();
+
+    {
+        QMutexLocker locker( &_mutex );
+
+        _stopping = true;
+        _condition.wakeAll();
+    }
+
+    _thread->wait();
+
+    delete _thread;
+    _thread = Q_NULLPTR;
+
+    _writer.close();
+
+    _free.clear();
+    _full.clear();
+
+    _buffers.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Recorder::flush()
+{
+    if ( !_thread ) return;
+
+    QMutexLocker locker( &_mutex );
+
+    for ( int i = 0; i < _sources.size(); i++ )
+    {
+        Buffer *buffer = _sources.at( i ).buffer;
+
+        if ( buffer && buffer->count > 0 )
+        {
+            _full.push_back( buffer );
+            _sources[ i ].buffer = Q_NULLPTR;
+        }
+    }
+
+    _condition.wakeOne();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Recorder::record( quint32 source, const double *values )
+{
+    if ( !_thread || source < 1 || source > static_cast< quint32 >( _sources.size() ) ) return;
+
+    Source &s = _sources[ source - 1 ];
+
+    if ( !s.buffer ) s.buffer = takeBuffer( source );
+
+    // all the buffers wait for writing
+    if ( !s.buffer )
+    {
+        _droppedSamples++;
+        return;
+    }
+
+    Buffer *buffer = s.buffer;
+
+    buffer->time[ buffer->count ] = _clock.nsecsElapsed() / 1000;
+
+    double *data = buffer->values.data() + buffer->count;
+
+    for ( int c = 0; c < s.columns.size(); c++ )
+    {
+        data[ c * _chunkSize ] = values[ c ];
+    }
+
+    buffer->count++;
+    _samples++;
+
+    if ( buffer->count == _chunkSize )
+    {
+        QMutexLocker locker( &_mutex );
+
+        _full.push_back( buffer );
+        _condition.wakeOne();
+
+        s.buffer = Q_NULLPTR;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_Recorder::hasFailed() const
+{
+    QMutexLocker locker( &_mutex );
+
+    return _failed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+quint32 qfi_Recorder::addSource( const Column *columns, int count )
+{
+    Source source;
+
+    source.buffer = Q_NULLPTR;
+
+    for ( int i = 0; i < count; i++ )
+    {
+        source.columns.push_back( columns[ i ] );
+    }
+
+    _sources.push_back( source );
+
+    // source 0 is the whole aircraft
+    return static_cast< quint32 >( _sources.size() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Recorder::addHook( QObject *object, const std::function< void() > &remove )
+{
+    Hook hook;
+
+    hook.object = object;
+    hook.remove = remove;
+
+    _hooks.push_back( hook );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Recorder::Buffer* qfi_Recorder::takeBuffer( quint32 source )
+{
+    QMutexLocker locker( &_mutex );
+
+    if ( _free.isEmpty() ) return Q_NULLPTR;
+
+    Buffer *buffer = _free.takeLast();
+
+    buffer->source  = source;
+    buffer->count   = 0;
+    buffer->columns = _sources.at( source - 1 ).columns;
+
+    return buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Recorder::write()
+{
+    QMutexLocker locker( &_mutex );
+
+    for ( ;; )
+    {
+        while ( _full.isEmpty() && !_stopping ) _condition.wait( &_mutex );
+
+        if ( _full.isEmpty() ) return;
+
+        Buffer *buffer = _full.takeFirst();
+
+        locker.unlock();
+
+        const double *values[ qfi_FlightLog::_columns ];
+
+        for ( int c = 0; c < buffer->columns.size(); c++ )
+        {
+            values[ c ] = buffer->values.constData() + c * _chunkSize;
+        }
+
+        bool result = _writer.writeChunk( buffer->source,
+                                          buffer->columns.constData(), buffer->columns.size(),
+                                          buffer->time.constData(), values, buffer->count );
+
+        locker.relock();
+
+        if ( !result ) _failed = true;
+
+        _free.push_back( buffer );
+    }
+}
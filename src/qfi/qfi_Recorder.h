@@ -0,0 +1,212 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_RECORDER_H
+#define QFI_RECORDER_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <functional>
+
+#include <qfi/qfi_defs.h>
+#include <qfi/qfi_FlightLog.h>
+#include <qfi/qfi_FlightLogWriter.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+class QThread;
+
+class qfi_AI;
+class qfi_ALT;
+class qfi_ASI;
+class qfi_EADI;
+class qfi_EHSI;
+class qfi_HI;
+class qfi_ILS;
+class qfi_TC;
+class qfi_VOR;
+class qfi_VSI;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Instrument state recorder class.
+ *
+ * Records every state passed to setState() of the registered instruments
+ * (see setStateHook()) into a flight log, every instrument is a separate
+ * source (see qfi_FlightLog). Values are converted from units of instruments
+ * states to units of log columns (e.g. EADI climb rate in thousands of ft/min
+ * is stored in ft/min), so every column means the same in all sources and
+ * qfi_States converts values back when replaying. Values are stored in double
+ * precision, so states are reproduced exactly, apart from rounding of the unit
+ * conversions. Samples are timestamped and put into preallocated chunk
+ * buffers, full buffers are written by a background thread. Recording never
+ * blocks: memory is bounded by the number of chunk buffers and when all of
+ * them wait for writing, samples are dropped and counted.
+ *
+ * Individual setters (e.g. qfi_AI::setRoll()) are not recorded. Instruments
+ * have to be used on one thread only (the GUI thread), as widgets anyway.
+ *
+ * Usage:
+ * @code
+ * recorder->addInstrument( eadi );
+ * recorder->addInstrument( ai );
+ * ...
+ * recorder->start( fileName );
+ * @endcode
+ */
+class QFIAPI qfi_Recorder
+{
+public:
+
+    /**
+     * Constructor.
+     * @param chunkSize number of samples per chunk
+     * @param maxChunks number of chunk buffers, at least one per source
+     * is needed while recording
+     */
+    explicit qfi_Recorder( int chunkSize = 512, int maxChunks = 128 );
+
+    /** Destructor, stops recording and removes hooks. */
+    virtual ~qfi_Recorder();
+
+    /**
+     * Hooks instrument state.
+     * @param instrument instrument
+     * @return source id
+     */
+    quint32 addInstrument( qfi_AI   *instrument );
+    quint32 addInstrument( qfi_ALT  *instrument );
+    quint32 addInstrument( qfi_ASI  *instrument );
+    quint32 addInstrument( qfi_EADI *instrument );
+    quint32 addInstrument( qfi_EHSI *instrument );
+    quint32 addInstrument( qfi_HI   *instrument );
+    quint32 addInstrument( qfi_ILS  *instrument );
+    quint32 addInstrument( qfi_TC   *instrument );
+    quint32 addInstrument( qfi_VOR  *instrument );
+    quint32 addInstrument( qfi_VSI  *instrument );
+
+    /**
+     * Creates log file and starts writer thread.
+     * @param fileName log file name
+     * @return true on success, false otherwise
+     */
+    bool start( const QString &fileName );
+
+    /** Writes all recorded samples and stops writer thread. */
+    void stop();
+
+    /** @return true if recording */
+    inline bool isRecording() const { return _thread != Q_NULLPTR; }
+
+    /** Passes partially filled chunks to the writer thread. */
+    void flush();
+
+    /**
+     * Records sample.
+     * @param source source id
+     * @param values values of the source columns
+     */
+    void record( quint32 source, const double *values );
+
+    /** @return number of recorded samples */
+    inline qint64 samples() const { return _samples; }
+
+    /** @return number of samples dropped because writing was late */
+    inline qint64 droppedSamples() const { return _droppedSamples; }
+
+    /** @return true if writing to the log file has failed */
+    bool hasFailed() const;
+
+private:
+
+    /** Chunk buffer. */
+    struct Buffer
+    {
+        quint32 source;                 ///< source id
+        qint64 count;                   ///< number of samples
+        QVector< qfi_FlightLog::Column > columns;   ///< source columns
+        QVector< qint64 > time;         ///< [us] sample times
+        QVector< double > values;       ///< values, column by column
+    };
+
+    /** Recorded source. */
+    struct Source
+    {
+        QVector< qfi_FlightLog::Column > columns;   ///< source columns
+        Buffer *buffer;                             ///< buffer being filled
+    };
+
+    /** Hooked instrument. */
+    struct Hook
+    {
+        QPointer< QObject > object;     ///< instrument
+        std::function< void() > remove; ///< hook removing function
+    };
+
+    const int _chunkSize;               ///< number of samples per chunk
+    const int _maxChunks;               ///< number of chunk buffers
+
+    QVector< Source > _sources;         ///< recorded sources, indexed with source id - 1
+
+    QList< Hook > _hooks;               ///< hooked instruments
+
+    QVector< Buffer > _buffers;         ///< chunk buffers
+
+    QList< Buffer* > _free;             ///< free buffers
+    QList< Buffer* > _full;             ///< buffers waiting for writing
+
+    mutable QMutex _mutex;              ///< free and full buffers mutex
+    QWaitCondition _condition;          ///< full buffers condition
+
+    QThread *_thread;                   ///< writer thread
+
+    qfi_FlightLogWriter _writer;        ///< log writer, chunks are written at once
+
+    QElapsedTimer _clock;               ///< recording clock
+
+    qint64 _samples;                    ///< number of recorded samples
+    qint64 _droppedSamples;             ///< number of dropped samples
+
+    bool _stopping;                     ///< specifies if writer thread has to finish
+    bool _failed;                       ///< specifies if writing has failed
+
+    quint32 addSource( const qfi_FlightLog::Column *columns, int count );
+
+    void addHook( QObject *object, const std::function< void() > &remove );
+
+    Buffer* takeBuffer( quint32 source );
+
+    void write();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_RECORDER_H
@@ -0,0 +1,219 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_Renderers.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+#include <qfi/qfi_Profiler.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef QFI_PROFILING
+/** SVG item recording its paint time. */
+class qfi_ProfiledSvgItem : public QGraphicsSvgItem
+{
+public:
+
+    qfi_ProfiledSvgItem( const QString &file, QGraphicsItem *parent ) :
+        QGraphicsSvgItem ( parent ),
+        _profileId ( qfi_Profiler::id( file ) )
+    {}
+
+    void paint( QPainter *painter,
+                const QStyleOptionGraphicsItem *option,
+                QWidget *widget = Q_NULLPTR ) override
+    {
+        QFI_PROFILE_ID( _profileId );
+        QGraphicsSvgItem::paint( painter, option, widget );
+    }
+
+private:
+
+    int _profileId;
+};
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+QHash< QString, qfi_Renderers::Entry > qfi_Renderers::_entries;
+
+QMutex qfi_Renderers::_mutex;
+
+bool qfi_Renderers::_shared = true;
+bool qfi_Renderers::_inited = false;
+
+////////////////////////////////////////////////////////////////////////////////
+
+QSvgRenderer* qfi_Renderers::get( const QString &file, QObject *owner )
+{
+    QMutexLocker locker( &_mutex );
+
+    if ( !_inited ) init();
+
+    QHash< QString, Entry >::iterator it = _entries.find( file );
+
+    if ( it == _entries.end() )
+    {
+        Entry entry;
+
+        entry.renderer = Q_NULLPTR;
+
+        entry.stats.file      = file;
+        entry.stats.parseTime = 0;
+        entry.stats.fileSize  = 0;
+        entry.stats.uses      = 0;
+        entry.stats.renderers = 0;
+
+        it = _entries.insert( file, entry );
+    }
+
+    Entry &entry = it.value();
+
+    entry.stats.uses++;
+
+    if ( _shared && entry.renderer ) return entry.renderer;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // private renderers are deleted with their owners, so reinit() does not
+    // accumulate them
+    QSvgRenderer *renderer = new QSvgRenderer( file, _shared ? Q_NULLPTR : owner );
+
+    entry.stats.parseTime += timer.nsecsElapsed() / 1000;
+    entry.stats.fileSize  += QFileInfo( file ).size();
+    entry.stats.renderers++;
+
+    if ( _shared ) entry.renderer = renderer;
+
+    return renderer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QGraphicsSvgItem* qfi_Renderers::createItem( const QString &file,
+                                             QGraphicsItem *parent )
+{
+#   ifdef QFI_PROFILING
+    QGraphicsSvgItem *item = new qfi_ProfiledSvgItem( file, parent );
+#   else
+    QGraphicsSvgItem *item = new QGraphicsSvgItem( parent );
+#   endif
+    item->setSharedRenderer( get( file, item ) );
+
+    return item;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Renderers::setShared( bool shared )
+{
+    QMutexLocker locker( &_mutex );
+    _shared = shared;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_Renderers::isShared()
+{
+    QMutexLocker locker( &_mutex );
+    return _shared;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QList< qfi_Renderers::Stats > qfi_Renderers::stats()
+{
+    QMutexLocker locker( &_mutex );
+
+    QList< Stats > stats;
+
+    for ( QHash< QString, Entry >::const_iterator it = _entries.constBegin();
+          it != _entries.constEnd(); ++it )
+    {
+        stats.push_back( it.value().stats );
+    }
+
+    return stats;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_Renderers::totalParseTime()
+{
+    QMutexLocker locker( &_mutex );
+
+    qint64 parseTime = 0;
+
+    for ( QHash< QString, Entry >::const_iterator it = _entries.constBegin();
+          it != _entries.constEnd(); ++it )
+    {
+        parseTime += it.value().stats.parseTime;
+    }
+
+    return parseTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_Renderers::totalFileSize()
+{
+    QMutexLocker locker( &_mutex );
+
+    qint64 fileSize = 0;
+
+    for ( QHash< QString, Entry >::const_iterator it = _entries.constBegin();
+          it != _entries.constEnd(); ++it )
+    {
+        fileSize += it.value().stats.fileSize;
+    }
+
+    return fileSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Renderers::init()
+{
+    _inited = true;
+
+    // renderers must not outlive the application object
+    qAddPostRoutine( qfi_Renderers::clear );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Renderers::clear()
+{
+    QMutexLocker locker( &_mutex );
+
+    for ( QHash< QString, Entry >::iterator it = _entries.begin();
+          it != _entries.end(); ++it )
+    {
+        delete it.value().renderer;
+    }
+
+    _entries.clear();
+}
@@ -0,0 +1,123 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_RENDERERS_H
+#define QFI_RENDERERS_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QGraphicsSvgItem>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QSvgRenderer>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Process-wide SVG renderers registry class.
+ *
+ * Each SVG document is parsed once and its renderer is shared by all items
+ * displaying it, in all instances of all instruments. Renderers are kept
+ * for the lifetime of the application.
+ *
+ * QSvgRenderer must not be used by several threads at once, so sharing has
+ * to be disabled before creating instruments which are painted by worker
+ * threads, see qfi_ParallelRenderer. Private renderers are owned by the
+ * requesting item and deleted with it.
+ */
+class QFIAPI qfi_Renderers
+{
+public:
+
+    /** Document statistics. */
+    struct Stats
+    {
+        QString file;       ///< resource path
+        qint64 parseTime;   ///< [us] time spent parsing the document
+        qint64 fileSize;    ///< [B] document file size (times number of parsed renderers)
+        qint64 uses;        ///< number of times the renderer has been handed out
+        int renderers;      ///< number of parsed renderers (1 unless sharing is disabled)
+    };
+
+    /**
+     * @param file resource path
+     * @param owner requesting item, owns the renderer if sharing is disabled
+     * @return shared renderer, document is parsed on first use, or private
+     * renderer parsed every time if sharing is disabled
+     */
+    static QSvgRenderer* get( const QString &file, QObject *owner );
+
+    /**
+     * Creates graphics item using shared renderer.
+     * @param file resource path
+     * @param parent parent item
+     * @return new graphics item
+     */
+    static QGraphicsSvgItem* createItem( const QString &file,
+                                         QGraphicsItem *parent = Q_NULLPTR );
+
+    /**
+     * Renderers handed out afterwards are shared (default) or private
+     * to the requesting item.
+     * @param shared specifies if renderers are shared
+     */
+    static void setShared( bool shared );
+
+    /** @return true if renderers are shared */
+    static bool isShared();
+
+    /** @return statistics of all parsed documents */
+    static QList< Stats > stats();
+
+    /** @return [us] total time spent parsing documents */
+    static qint64 totalParseTime();
+
+    /** @return [B] total file size of parsed documents, not memory used by renderers */
+    static qint64 totalFileSize();
+
+private:
+
+    /** Registry entry. */
+    struct Entry
+    {
+        QSvgRenderer *renderer;             ///< shared renderer
+        Stats stats;                        ///< document statistics
+    };
+
+    static QHash< QString, Entry > _entries;
+
+    static QMutex _mutex;
+
+    static bool _shared;
+    static bool _inited;
+
+    static void init();
+
+    static void clear();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_RENDERERS_H
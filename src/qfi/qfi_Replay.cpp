@@ -0,0 +1,269 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_Replay.h>
+
+#include <algorithm>
+
+#include <qfi/qfi_Interpolation.h>
+#include <qfi/qfi_States.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef qfi_FlightLog::Column Column;
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Replay::qfi_Replay( qfi_FrameScheduler *scheduler, QObject *parent ) :
+    QObject ( parent ),
+
+    _scheduler ( scheduler ),
+
+    _speed ( 1.0 ),
+
+    _time      ( 0 ),
+    _clockTime ( 0 ),
+
+    _playing ( false ),
+    _seeked  ( false )
+{
+    std::fill( _v0     , _v0     + qfi_FlightLog::_columns, 0.0 );
+    std::fill( _v1     , _v1     + qfi_FlightLog::_columns, 0.0 );
+    std::fill( _values , _values + qfi_FlightLog::_columns, 0.0 );
+
+    if ( _scheduler )
+    {
+        connect( _scheduler, &qfi_FrameScheduler::frame, this, &qfi_Replay::onFrame );
+    }
+
+    _clock.start();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Replay::~qfi_Replay()
+{
+    close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_Replay::open( const QString &fileName, quint32 source )
+{
+    close();
+
+    if ( !_log.open( fileName, source ) ) return false;
+
+    // nothing to be played, e.g. source not found
+    if ( _log.samples() == 0 )
+    {
+        _log.close();
+        return false;
+    }
+
+    seek( _log.startTime() );
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Replay::close()
+{
+    pause();
+
+    _log.close();
+
+    _time   = 0;
+    _seeked = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Replay::removeInstrument( QObject *instrument )
+{
+    for ( int i = _instruments.size() - 1; i >= 0; i-- )
+    {
+        if ( _instruments.at( i ).object == instrument )
+        {
+            _instruments.removeAt( i );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Replay::setSpeed( double speed )
+{
+    _speed = qBound( 0.1, speed, 100.0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Replay::seek( qint64 time )
+{
+    if ( _log.samples() == 0 ) return;
+
+    _time = qBound( _log.startTime(), time, _log.endTime() );
+    _clockTime = _clock.nsecsElapsed();
+    _seeked = true;
+
+    if ( _scheduler ) _scheduler->requestFrame();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Replay::play()
+{
+    if ( _log.samples() == 0 ) return;
+
+    if ( _time >= _log.endTime() ) _time = _log.startTime();
+
+    _clockTime = _clock.nsecsElapsed();
+    _playing = true;
+
+    // frames are produced continuously as long as log is being played
+    if ( _scheduler ) _scheduler->setContinuous( true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Replay::pause()
+{
+    if ( !_playing ) return;
+
+    _playing = false;
+
+    if ( _scheduler ) _scheduler->setContinuous( false );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Replay::addObject( QObject *object, const std::function< void() > &apply )
+{
+    if ( !object ) return;
+
+    removeInstrument( object );
+
+    Instrument instrument;
+
+    instrument.object = object;
+    instrument.apply  = apply;
+
+    _instruments.push_back( instrument );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Replay::onFrame()
+{
+    if ( !_playing && !_seeked ) return;
+
+    bool finish = false;
+
+    if ( _playing )
+    {
+        qint64 now = _clock.nsecsElapsed();
+
+        _time += qRound64( 1.0e-3 * _speed * ( now - _clockTime ) );
+        _clockTime = now;
+
+        if ( _time >= _log.endTime() )
+        {
+            _time = _log.endTime();
+            finish = true;
+        }
+    }
+
+    _seeked = false;
+
+    sample();
+    updateStates();
+
+    for ( int i = 0; i < _instruments.size(); i++ )
+    {
+        if ( _instruments.at( i ).object ) _instruments.at( i ).apply();
+    }
+
+    if ( finish )
+    {
+        pause();
+        emit finished();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Replay::sample()
+{
+    qint64 i = qMax( static_cast< qint64 >( 0 ), _log.find( _time ) );
+
+    _log.read( i, _v0 );
+
+    qint64 t0 = _log.time( i );
+    qint64 t1 = t0;
+
+    if ( i + 1 < _log.samples() )
+    {
+        _log.read( i + 1, _v1 );
+        t1 = _log.time( i + 1 );
+    }
+
+    double ratio = ( t1 > t0 ) ? static_cast< double >( _time - t0 ) / ( t1 - t0 ) : 0.0;
+
+    for ( int c = 0; c < qfi_FlightLog::_columns; c++ )
+    {
+        Column column = static_cast< Column >( c );
+
+        // discrete values are held until the next sample
+        if ( ratio <= 0.0 || qfi_FlightLog::isDiscrete( column ) )
+        {
+            _values[ c ] = _v0[ c ];
+        }
+        else if ( column == Column::Roll || column == Column::FdRoll )
+        {
+            _values[ c ] = qfi_Interpolation::roll( _v0[ c ], _v1[ c ], ratio );
+        }
+        else if ( qfi_FlightLog::isAngle( column ) )
+        {
+            _values[ c ] = qfi_Interpolation::angle( _v0[ c ], _v1[ c ], ratio );
+        }
+        else
+        {
+            _values[ c ] = qfi_Interpolation::linear( _v0[ c ], _v1[ c ], ratio );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Replay::updateStates()
+{
+    qfi_States::fromValues( _values, &_eadi );
+    qfi_States::fromValues( _values, &_ehsi );
+    qfi_States::fromValues( _values, &_ai   );
+    qfi_States::fromValues( _values, &_alt  );
+    qfi_States::fromValues( _values, &_asi  );
+    qfi_States::fromValues( _values, &_hi   );
+    qfi_States::fromValues( _values, &_tc   );
+    qfi_States::fromValues( _values, &_vor  );
+    qfi_States::fromValues( _values, &_vsi  );
+}
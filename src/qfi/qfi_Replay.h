@@ -0,0 +1,236 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_REPLAY_H
+#define QFI_REPLAY_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+
+#include <functional>
+
+#include <qfi/qfi_defs.h>
+#include <qfi/qfi_FlightLog.h>
+#include <qfi/qfi_FrameScheduler.h>
+
+#include <qfi/qfi_AI.h>
+#include <qfi/qfi_ALT.h>
+#include <qfi/qfi_ASI.h>
+#include <qfi/qfi_EADI.h>
+#include <qfi/qfi_EHSI.h>
+#include <qfi/qfi_HI.h>
+#include <qfi/qfi_TC.h>
+#include <qfi/qfi_VOR.h>
+#include <qfi/qfi_VSI.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Flight log replay class.
+ *
+ * Plays qfi_FlightLog on the registered instruments at a variable speed.
+ * Log is sampled on every frame of the frame scheduler, values between
+ * samples are interpolated, so replay is smooth at any speed and sample rate.
+ * Seeking takes O(log n) time and no memory is allocated while playing.
+ *
+ * Usage:
+ * @code
+ * qfi_Replay *replay = new qfi_Replay( scheduler, this );
+ *
+ * replay->addInstrument( eadi );
+ * replay->addInstrument( ehsi );
+ * ...
+ * if ( replay->open( fileName ) ) replay->play();
+ * @endcode
+ */
+class QFIAPI qfi_Replay : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor.
+     * @param scheduler frame scheduler driving the registered instruments
+     */
+    explicit qfi_Replay( qfi_FrameScheduler *scheduler, QObject *parent = Q_NULLPTR );
+
+    /** Destructor. */
+    virtual ~qfi_Replay();
+
+    /**
+     * Opens log (see qfi_FlightLog::open()) and seeks to its beginning.
+     * @param fileName log file name
+     * @param source source id
+     * @return true on success, false otherwise (also if the source has no samples)
+     */
+    bool open( const QString &fileName, quint32 source = 0 );
+
+    /** Stops replay and closes log. */
+    void close();
+
+    /** @return replayed log */
+    inline const qfi_FlightLog& log() const { return _log; }
+
+    /** @param instrument instrument to be driven by the log */
+    inline void addInstrument( qfi_EADI *instrument )
+    {
+        addObject( instrument, [ this, instrument ]() { instrument->setState( _eadi ); } );
+    }
+
+    /** @param instrument instrument to be driven by the log */
+    inline void addInstrument( qfi_EHSI *instrument )
+    {
+        addObject( instrument, [ this, instrument ]() { instrument->setState( _ehsi ); } );
+    }
+
+    /** @param instrument instrument to be driven by the log */
+    inline void addInstrument( qfi_AI *instrument )
+    {
+        addObject( instrument, [ this, instrument ]() { instrument->setState( _ai ); } );
+    }
+
+    /** @param instrument instrument to be driven by the log */
+    inline void addInstrument( qfi_ALT *instrument )
+    {
+        addObject( instrument, [ this, instrument ]() { instrument->setState( _alt ); } );
+    }
+
+    /** @param instrument instrument to be driven by the log */
+    inline void addInstrument( qfi_ASI *instrument )
+    {
+        addObject( instrument, [ this, instrument ]() { instrument->setState( _asi ); } );
+    }
+
+    /** @param instrument instrument to be driven by the log */
+    inline void addInstrument( qfi_HI *instrument )
+    {
+        addObject( instrument, [ this, instrument ]() { instrument->setState( _hi ); } );
+    }
+
+    /** @param instrument instrument to be driven by the log */
+    inline void addInstrument( qfi_TC *instrument )
+    {
+        addObject( instrument, [ this, instrument ]() { instrument->setState( _tc ); } );
+    }
+
+    /** @param instrument instrument to be driven by the log */
+    inline void addInstrument( qfi_VOR *instrument )
+    {
+        addObject( instrument, [ this, instrument ]() { instrument->setState( _vor ); } );
+    }
+
+    /** @param instrument instrument to be driven by the log */
+    inline void addInstrument( qfi_VSI *instrument )
+    {
+        addObject( instrument, [ this, instrument ]() { instrument->setState( _vsi ); } );
+    }
+
+    /** @param instrument instrument not to be driven anymore */
+    void removeInstrument( QObject *instrument );
+
+    /** @param speed replay speed, from 0.1 to 100.0 (1.0 means real time) */
+    void setSpeed( double speed );
+
+    /** @return replay speed */
+    inline double speed() const { return _speed; }
+
+    /**
+     * Moves to the given log time, instruments are updated on the next frame.
+     * @param time [us] log time, clamped to the log time range
+     */
+    void seek( qint64 time );
+
+    /** @return [us] current log time */
+    inline qint64 time() const { return _time; }
+
+    /** @return true if log is being played */
+    inline bool isPlaying() const { return _playing; }
+
+public slots:
+
+    /** Starts playing, from the beginning if the end has been reached. */
+    void play();
+
+    /** Pauses playing. */
+    void pause();
+
+signals:
+
+    /** Emitted when the end of the log has been reached. */
+    void finished();
+
+private:
+
+    /** Registered instrument. */
+    struct Instrument
+    {
+        QPointer< QObject > object;     ///< instrument
+        std::function< void() > apply;  ///< instrument state setting function
+    };
+
+    QPointer< qfi_FrameScheduler > _scheduler;  ///< frame scheduler
+
+    qfi_FlightLog _log;                 ///< replayed log
+
+    QList< Instrument > _instruments;   ///< registered instruments
+
+    QElapsedTimer _clock;               ///< replay clock
+
+    double _speed;                      ///< replay speed
+
+    qint64 _time;                       ///< [us] current log time
+    qint64 _clockTime;                  ///< [ns] replay clock time of the last frame
+
+    bool _playing;                      ///< specifies if log is being played
+    bool _seeked;                       ///< specifies if states have to be set after seeking
+
+    double _v0 [ qfi_FlightLog::_columns ];     ///< values of the sample before current time
+    double _v1 [ qfi_FlightLog::_columns ];     ///< values of the sample after current time
+
+    double _values [ qfi_FlightLog::_columns ]; ///< values at current time
+
+    qfi_EADI::State _eadi;              ///< EADI state
+    qfi_EHSI::State _ehsi;              ///< EHSI state
+    qfi_AI::State   _ai;                ///< AI state
+    qfi_ALT::State  _alt;               ///< ALT state
+    qfi_ASI::State  _asi;               ///< ASI state
+    qfi_HI::State   _hi;                ///< HI state
+    qfi_TC::State   _tc;                ///< TC state
+    qfi_VOR::State  _vor;               ///< VOR state
+    qfi_VSI::State  _vsi;               ///< VSI state
+
+    void addObject( QObject *object, const std::function< void() > &apply );
+
+    void onFrame();
+
+    void sample();
+
+    void updateStates();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_REPLAY_H
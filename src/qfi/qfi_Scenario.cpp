@@ -0,0 +1,617 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_Scenario.h>
+
+#include <cmath>
+#include <cstring>
+
+#include <qfi/qfi_FlightLogWriter.h>
+#include <qfi/qfi_Interpolation.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef qfi_FlightLog::Column Column;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+const double stallSpeed = 50.0;     ///< [kts] stall speed
+const double vfe        = 85.0;     ///< [kts] maximum flaps extended speed
+const double vne        = 158.0;    ///< [kts] never exceed speed
+
+const double deg2rad = M_PI / 180.0;
+
+inline double wrap360( double angle )
+{
+    double result = fmod( angle, 360.0 );
+    return ( result < 0.0 ) ? result + 360.0 : result;
+}
+
+inline double wrap180( double angle )
+{
+    return wrap360( angle + 180.0 ) - 180.0;
+}
+
+inline double bound( double value, double limit )
+{
+    return qBound( -limit, value, limit );
+}
+
+inline double sign( double value )
+{
+    return ( value < 0.0 ) ? -1.0 : 1.0;
+}
+
+/** First order lag. */
+inline double lag( double value, double target, double timeConstant, double dt )
+{
+    return value + ( target - value ) * dt / timeConstant;
+}
+
+/** @return [ft/min] 3 deg glideslope descent rate */
+inline double glideRate( double airspeed )
+{
+    return -101.27 * airspeed * sin( 3.0 * deg2rad );
+}
+
+inline void set( double *values, Column column, double value )
+{
+    values[ static_cast< int >( column ) ] = value;
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+const double qfi_Scenario::_step = 0.01;
+
+////////////////////////////////////////////////////////////////////////////////
+
+const char* qfi_Scenario::name( Maneuver maneuver )
+{
+    switch ( maneuver )
+    {
+        case Maneuver::Cruise   : return "cruise";
+        case Maneuver::Turn     : return "turn";
+        case Maneuver::Climb    : return "climb";
+        case Maneuver::Descent  : return "descent";
+        case Maneuver::Approach : return "approach";
+        case Maneuver::Stall    : return "stall";
+    }
+
+    return "";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Scenario::qfi_Scenario( quint32 seed ) :
+    _random ( 0 )
+{
+    reset( seed );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Scenario::reset( quint32 seed )
+{
+    _random = 0x853C49E6748FEA9BULL ^ seed;
+
+    _aircraft.roll       = 0.0;
+    _aircraft.heading    = uniform( 0.0, 360.0 );
+    _aircraft.airspeed   = uniform( 100.0, 130.0 );
+    _aircraft.altitude   = uniform( 3000.0, 8000.0 );
+    _aircraft.climbRate  = 0.0;
+    _aircraft.turnRate   = 0.0;
+    _aircraft.slipSkid   = 0.0;
+    _aircraft.aoa        = 16.0 * pow( stallSpeed / _aircraft.airspeed, 2.0 );
+    _aircraft.pitch      = _aircraft.aoa;
+    _aircraft.pressure   = uniform( 29.5, 30.3 );
+    _aircraft.course     = _aircraft.heading;
+    _aircraft.bearing    = _aircraft.heading;
+    _aircraft.distance   = uniform( 20.0, 80.0 );
+    _aircraft.dotH       = 0.0;
+    _aircraft.dotV       = 0.0;
+    _aircraft.crossTrack = 0.0;
+    _aircraft.gust       = 0.0;
+
+    _maneuvers = 0;
+
+    _steps = 0;
+    _time  = 0.0;
+
+    start( Maneuver::Cruise );
+
+    update( _v1 );
+
+    memcpy( _v0     , _v1, sizeof( _v1 ) );
+    memcpy( _values , _v1, sizeof( _v1 ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Scenario::step( double dt )
+{
+    if ( !( dt > 0.0 ) ) return;
+
+    _time += dt;
+
+    while ( _steps * _step < _time )
+    {
+        memcpy( _v0, _v1, sizeof( _v1 ) );
+
+        control();
+        integrate();
+        update( _v1 );
+
+        _steps++;
+    }
+
+    // output is interpolated between the last two internal steps
+    const double ratio = ( _time - ( _steps - 1 ) * _step ) / _step;
+
+    for ( int c = 0; c < qfi_FlightLog::_columns; c++ )
+    {
+        Column column = static_cast< Column >( c );
+
+        if ( qfi_FlightLog::isDiscrete( column ) )
+        {
+            _values[ c ] = _v0[ c ];
+        }
+        else if ( column == Column::Roll || column == Column::FdRoll )
+        {
+            _values[ c ] = qfi_Interpolation::roll( _v0[ c ], _v1[ c ], ratio );
+        }
+        else if ( qfi_FlightLog::isAngle( column ) )
+        {
+            _values[ c ] = qfi_Interpolation::angle( _v0[ c ], _v1[ c ], ratio );
+        }
+        else
+        {
+            _values[ c ] = qfi_Interpolation::linear( _v0[ c ], _v1[ c ], ratio );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_Scenario::write( const QString &fileName, double duration, double rate )
+{
+    if ( !( rate > 0.0 ) || duration < 0.0 ) return false;
+
+    qfi_FlightLogWriter writer;
+
+    if ( !writer.open( fileName ) ) return false;
+
+    const double start = _time;
+    const qint64 samples = static_cast< qint64 >( duration * rate ) + 1;
+
+    for ( qint64 i = 0; i < samples; i++ )
+    {
+        // sample times are computed from the start, so they do not drift
+        if ( i > 0 ) step( start + i / rate - _time );
+
+        if ( !writer.write( static_cast< qint64 >( floor( 1.0e6 * _time + 0.5 ) ), _values ) )
+        {
+            return false;
+        }
+    }
+
+    return writer.flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double qfi_Scenario::uniform( double min, double max )
+{
+    // 64-bit LCG, the highest 53 bits make double in range [0,1)
+    _random = _random * 6364136223846793005ULL + 1442695040888963407ULL;
+
+    return min + ( max - min ) * ( ( _random >> 11 ) * ( 1.0 / 9007199254740992.0 ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Scenario::start( Maneuver maneuver )
+{
+    _maneuver = maneuver;
+    _maneuvers++;
+
+    _phase     = 0;
+    _phaseTime = 0.0;
+    _duration  = 0.0;
+
+    _stall = false;
+
+    // autopilot holds the current flight unless the maneuver changes it
+    _targets.roll          = 0.0;
+    _targets.pitch         = _aircraft.pitch;
+    _targets.heading       = _aircraft.heading;
+    _targets.airspeed      = _aircraft.airspeed;
+    _targets.altitude      = _aircraft.altitude;
+    _targets.climbRate     = 0.0;
+    _targets.bank          = 0.0;
+    _targets.verticalSpeed = 1000.0;
+
+    _fltMode = qfi_EADI::FltMode::CMD;
+    _spdMode = qfi_EADI::SpdMode::FMC_SPD;
+    _lnav    = qfi_EADI::LNAV::HDG;
+    _vnav    = qfi_EADI::VNAV::ALT;
+
+    _aircraft.dotH = 0.0;
+    _aircraft.dotV = 0.0;
+
+    switch ( maneuver )
+    {
+        case Maneuver::Cruise:
+            _duration         = uniform( 10.0, 40.0 );
+            _targets.airspeed = uniform( 100.0, 140.0 );
+            _lnav             = qfi_EADI::LNAV::NAV;
+            break;
+
+        case Maneuver::Turn:
+        {
+            const double delta = sign( uniform( -1.0, 1.0 ) ) * uniform( 30.0, 175.0 );
+
+            _targets.heading = wrap360( _aircraft.heading + delta );
+            _targets.bank    = sign( delta ) * uniform( 15.0, 30.0 );
+            break;
+        }
+
+        case Maneuver::Climb:
+            _targets.altitude      = qMin( 15000.0, _aircraft.altitude + uniform( 500.0, 3000.0 ) );
+            _targets.verticalSpeed = uniform( 700.0, 1800.0 );
+            _targets.airspeed      = uniform( 75.0, 90.0 );
+            _vnav                  = qfi_EADI::VNAV::VS;
+            break;
+
+        case Maneuver::Descent:
+            _targets.altitude      = qMax( 1500.0, _aircraft.altitude - uniform( 500.0, 3000.0 ) );
+            _targets.verticalSpeed = uniform( 700.0, 1800.0 );
+            _targets.airspeed      = uniform( 110.0, 140.0 );
+            _vnav                  = qfi_EADI::VNAV::VS;
+            break;
+
+        case Maneuver::Approach:
+            // runway ahead, localizer and glideslope not captured yet
+            _duration           = uniform( 30.0, 90.0 );
+            _targets.airspeed   = uniform( 90.0, 100.0 );
+            _aircraft.course    = wrap360( _aircraft.heading + uniform( -30.0, 30.0 ) );
+            _aircraft.distance  = uniform( 8.0, 12.0 );
+            _aircraft.crossTrack = 0.0;
+            _aircraft.dotH      = sign( uniform( -1.0, 1.0 ) ) * uniform( 1.5, 2.5 );
+            _aircraft.dotV      = uniform( 1.0, 2.0 );
+            _lnav               = qfi_EADI::LNAV::APR_ARM;
+            _vnav               = qfi_EADI::VNAV::GS_ARM;
+            break;
+
+        case Maneuver::Stall:
+            // power off, nose up, autopilot disengaged
+            _targets.airspeed = 0.0;
+            _targets.pitch    = uniform( 12.0, 18.0 );
+            _fltMode          = qfi_EADI::FltMode::Off;
+            _spdMode          = qfi_EADI::SpdMode::Off;
+            _lnav             = qfi_EADI::LNAV::Off;
+            _vnav             = qfi_EADI::VNAV::Off;
+            break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Scenario::next()
+{
+    const double r = uniform( 0.0, 1.0 );
+
+    Maneuver maneuver = Maneuver::Stall;
+
+    if      ( r < 0.25 ) maneuver = Maneuver::Cruise;
+    else if ( r < 0.50 ) maneuver = Maneuver::Turn;
+    else if ( r < 0.65 ) maneuver = Maneuver::Climb;
+    else if ( r < 0.80 ) maneuver = Maneuver::Descent;
+    else if ( r < 0.92 ) maneuver = Maneuver::Approach;
+
+    // altitude envelope
+    const double altitude = _aircraft.altitude;
+
+    if ( maneuver == Maneuver::Climb   && altitude > 14000.0 ) maneuver = Maneuver::Descent;
+    if ( maneuver == Maneuver::Descent && altitude <  2500.0 ) maneuver = Maneuver::Climb;
+
+    if ( ( maneuver == Maneuver::Approach || maneuver == Maneuver::Stall ) && altitude < 3000.0 )
+    {
+        maneuver = Maneuver::Climb;
+    }
+
+    start( maneuver );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Scenario::setPhase( int phase )
+{
+    _phase     = phase;
+    _phaseTime = 0.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Scenario::control()
+{
+    _phaseTime += _step;
+
+    bool holdHeading  = true;   // bank proportional to heading error
+    bool holdAltitude = true;   // climb rate proportional to altitude error
+
+    switch ( _maneuver )
+    {
+        case Maneuver::Cruise:
+            if ( _phaseTime > _duration ) next();
+            break;
+
+        case Maneuver::Turn:
+            if ( _phase == 0 )
+            {
+                // rolling out is started ahead of the new heading
+                const double lead = 1.5 * fabs( _aircraft.turnRate ) + 1.0;
+
+                if ( fabs( wrap180( _targets.heading - _aircraft.heading ) ) > lead )
+                {
+                    _targets.roll = _targets.bank;
+                    holdHeading = false;
+                }
+                else
+                {
+                    setPhase( 1 );
+                }
+            }
+            else if ( fabs( wrap180( _targets.heading - _aircraft.heading ) ) < 1.0
+                   && fabs( _aircraft.roll ) < 2.0 )
+            {
+                next();
+            }
+            break;
+
+        case Maneuver::Climb:
+        case Maneuver::Descent:
+        {
+            const double error = fabs( _targets.altitude - _aircraft.altitude );
+
+            if ( error < 20.0 && fabs( _aircraft.climbRate ) < 200.0 )
+            {
+                next();
+            }
+            else
+            {
+                _vnav = ( error > 300.0 ) ? qfi_EADI::VNAV::VS : qfi_EADI::VNAV::ALT_SEL;
+            }
+            break;
+        }
+
+        case Maneuver::Approach:
+            if ( _phase == 0 )
+            {
+                // localizer intercept at 30 deg
+                _targets.heading = wrap360( _aircraft.course - 30.0 * sign( _aircraft.dotH ) );
+
+                if ( fabs( _aircraft.dotH ) < 1.0 )
+                {
+                    _lnav = qfi_EADI::LNAV::APR;
+                    setPhase( 1 );
+                }
+            }
+            else
+            {
+                _targets.heading = wrap360( _aircraft.course - bound( 25.0 * _aircraft.dotH, 30.0 ) );
+            }
+
+            if ( _phase == 1 && _aircraft.dotV < 0.2 )
+            {
+                _vnav = qfi_EADI::VNAV::GS;
+                setPhase( 2 );
+            }
+
+            if ( _phase == 2 )
+            {
+                holdAltitude = false;
+                _targets.climbRate = glideRate( _aircraft.airspeed ) + 300.0 * _aircraft.dotV;
+
+                // go-around
+                if ( _phaseTime > _duration || _aircraft.altitude < 1200.0 ) start( Maneuver::Climb );
+            }
+            break;
+
+        case Maneuver::Stall:
+            if ( _phase == 0 )
+            {
+                holdHeading = false;
+                _targets.roll = 0.0;
+
+                if ( _aircraft.airspeed < stallSpeed )
+                {
+                    // wing drop, nose down and full power
+                    _stall = true;
+                    _targets.bank     = sign( uniform( -1.0, 1.0 ) ) * uniform( 10.0, 20.0 );
+                    _targets.pitch    = uniform( -12.0, -8.0 );
+                    _targets.airspeed = 110.0;
+                    setPhase( 1 );
+                }
+            }
+            else if ( _phase == 1 )
+            {
+                holdHeading = false;
+                _targets.roll = ( _phaseTime < 1.0 ) ? _targets.bank : 0.0;
+
+                if ( _aircraft.airspeed > 1.3 * stallSpeed )
+                {
+                    // recovery climb
+                    _stall = false;
+                    _targets.heading       = _aircraft.heading;
+                    _targets.altitude      = _aircraft.altitude + 500.0;
+                    _targets.verticalSpeed = 800.0;
+                    setPhase( 2 );
+                }
+            }
+            else if ( _phaseTime > 10.0 )
+            {
+                next();
+            }
+            break;
+    }
+
+    if ( holdHeading )
+    {
+        _targets.roll = bound( 2.0 * wrap180( _targets.heading - _aircraft.heading ), 25.0 );
+    }
+
+    if ( holdAltitude )
+    {
+        _targets.climbRate = bound( 10.0 * ( _targets.altitude - _aircraft.altitude ),
+                                    _targets.verticalSpeed );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Scenario::integrate()
+{
+    Aircraft &a = _aircraft;
+
+    const double dt = _step;
+
+    // turbulence, first order Gauss-Markov process of uniform noise
+    a.gust = lag( a.gust, 0.0, 2.0, dt ) + 1.5 * sqrt( dt ) * uniform( -1.0, 1.0 );
+
+    // roll rate limited to 10 deg/s
+    a.roll += bound( _targets.roll - a.roll, 10.0 * dt );
+
+    a.airspeed = lag( a.airspeed, _targets.airspeed, 8.0, dt );
+
+    const double airspeed = qMax( 20.0, a.airspeed );
+    const double roll     = a.roll + a.gust;
+    const double speed    = 101.27 * airspeed;  // [ft/min]
+
+    a.aoa = qMin( 25.0, 16.0 * pow( stallSpeed / airspeed, 2.0 ) );
+
+    // coordinated turn
+    a.turnRate = 1091.0 * tan( roll * deg2rad ) / qMax( 40.0, airspeed );
+    a.heading  = wrap360( a.heading + a.turnRate * dt );
+
+    // stall is flown by pitch, everything else by climb rate
+    if ( _maneuver == Maneuver::Stall && _phase < 2 )
+    {
+        a.pitch     = lag( a.pitch, _targets.pitch, 2.0, dt );
+        a.climbRate = speed * sin( ( a.pitch - a.aoa ) * deg2rad );
+    }
+    else
+    {
+        a.climbRate = lag( a.climbRate, _targets.climbRate, 2.0, dt );
+        a.pitch     = asin( bound( a.climbRate / speed, 1.0 ) ) / deg2rad + a.aoa;
+    }
+
+    a.altitude += a.climbRate / 60.0 * dt;
+
+    // skid while rolling in or out and in turbulence
+    a.slipSkid = bound( 0.05 * ( _targets.roll - a.roll ) + 0.1 * a.gust, 1.0 );
+
+    // navigation, new waypoint is taken when the current one is reached
+    const double track = wrap180( a.heading - a.course );
+    const double groundSpeed = airspeed / 3600.0;
+
+    a.distance   -= groundSpeed * cos( track * deg2rad ) * dt;
+    a.crossTrack += groundSpeed * sin( track * deg2rad ) * dt;
+
+    if ( _maneuver == Maneuver::Approach )
+    {
+        a.distance = qMax( 0.0, a.distance );
+
+        a.dotH += 0.004 * ( airspeed / 100.0 ) * track * dt;
+
+        // glideslope comes down once the localizer is captured
+        if ( _phase > 0 ) a.dotV -= ( a.climbRate - glideRate( airspeed ) ) / 3000.0 * dt;
+
+        a.dotH = bound( a.dotH, 2.5 );
+        a.dotV = bound( a.dotV, 2.5 );
+    }
+    else if ( a.distance < 0.5 )
+    {
+        a.distance   = uniform( 20.0, 80.0 );
+        a.course     = wrap360( a.heading + uniform( -20.0, 20.0 ) );
+        a.crossTrack = 0.0;
+    }
+
+    a.bearing = wrap360( a.course - atan2( a.crossTrack, qMax( 0.1, a.distance ) ) / deg2rad );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Scenario::update( double *values ) const
+{
+    const Aircraft &a = _aircraft;
+
+    const bool approach = _maneuver == Maneuver::Approach;
+    const bool pitchMode = _maneuver == Maneuver::Stall && _phase < 2;
+
+    int flags = qfi_FlightLog::FpmVisible
+              | qfi_FlightLog::BearingVisible
+              | qfi_FlightLog::DistanceVisible;
+
+    if ( _fltMode != qfi_EADI::FltMode::Off ) flags |= qfi_FlightLog::FdVisible;
+    if ( approach ) flags |= qfi_FlightLog::DotVisibleH | qfi_FlightLog::DotVisibleV;
+    if ( _stall   ) flags |= qfi_FlightLog::Stall;
+
+    const double fdPitch = pitchMode ? _targets.pitch
+                                     : a.pitch + bound( ( _targets.climbRate - a.climbRate ) / 200.0, 5.0 );
+
+    set( values, Column::Roll          , a.roll + a.gust );
+    set( values, Column::Pitch         , a.pitch );
+    set( values, Column::Heading       , a.heading );
+    set( values, Column::Airspeed      , a.airspeed );
+    set( values, Column::Altitude      , a.altitude );
+    set( values, Column::Pressure      , a.pressure );
+    set( values, Column::ClimbRate     , a.climbRate );
+    set( values, Column::TurnRate      , a.turnRate );
+    set( values, Column::SlipSkid      , a.slipSkid );
+    set( values, Column::AngleOfAttack , a.aoa );
+    set( values, Column::Sideslip      , 5.0 * a.slipSkid );
+    set( values, Column::MachNo        , a.airspeed * ( 1.0 + 2.0e-5 * a.altitude ) / 661.47 );
+    set( values, Column::AirspeedSel   , _targets.airspeed );
+    set( values, Column::AltitudeSel   , _targets.altitude );
+    set( values, Column::HeadingSel    , _targets.heading );
+    set( values, Column::Course        , a.course );
+    set( values, Column::Bearing       , a.bearing );
+    set( values, Column::Deviation     , approach ? a.dotH : bound( -a.crossTrack / 2.0, 1.0 ) );
+    set( values, Column::Distance      , a.distance );
+    set( values, Column::DotH          , a.dotH );
+    set( values, Column::DotV          , a.dotV );
+    set( values, Column::FdRoll        , _targets.roll );
+    set( values, Column::FdPitch       , fdPitch );
+    set( values, Column::Vfe           , vfe );
+    set( values, Column::Vne           , vne );
+    set( values, Column::FltMode       , static_cast< int >( _fltMode ) );
+    set( values, Column::SpdMode       , static_cast< int >( _spdMode ) );
+    set( values, Column::LNAV          , static_cast< int >( _lnav ) );
+    set( values, Column::VNAV          , static_cast< int >( _vnav ) );
+    set( values, Column::PressureMode  , static_cast< int >( qfi_EADI::PressureMode::IN ) );
+    set( values, Column::CDI           , static_cast< int >( CDI::TO ) );
+    set( values, Column::Flags         , flags );
+}
@@ -0,0 +1,209 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_SCENARIO_H
+#define QFI_SCENARIO_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QString>
+
+#include <qfi/qfi_defs.h>
+#include <qfi/qfi_EADI.h>
+#include <qfi/qfi_enums.h>
+#include <qfi/qfi_FlightLog.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Synthetic flight profile generator class.
+ *
+ * Generates deterministic flight trajectories for benchmarks, stress tests
+ * and demonstrations: a random sequence of maneuvers (cruise, coordinated
+ * turns, climbs, descents, ILS approaches with go-around and stalls with
+ * recovery), together with the matching EADI modes (e.g. LNAV APR_ARM
+ * changing to APR at localizer capture). With the same build the same seed
+ * gives the same trajectory at any output rate: the aircraft is integrated
+ * with a fixed internal step and the output is interpolated between steps,
+ * random numbers come from a generator of its own. Trajectories of different
+ * platforms or compilers may differ slightly, as math library functions
+ * (e.g. tan(), asin(), atan2()) are not required to round the same way.
+ *
+ * Values are of qfi_FlightLog columns, so they can be written to a flight
+ * log (see write()) or converted to instrument states (see qfi_States).
+ *
+ * Usage:
+ * @code
+ * qfi_Scenario scenario( seed );
+ *
+ * // every sample
+ * scenario.step( 0.001 );
+ *
+ * qfi_AI::State state;
+ * qfi_States::fromValues( scenario.values(), &state );
+ * ai->setState( state );
+ * @endcode
+ */
+class QFIAPI qfi_Scenario
+{
+public:
+
+    /** Maneuvers. */
+    enum class Maneuver
+    {
+        Cruise = 0,     ///< straight and level flight
+        Turn,           ///< coordinated turn to a new heading
+        Climb,          ///< climb to a new altitude
+        Descent,        ///< descent to a new altitude
+        Approach,       ///< ILS approach ended with go-around
+        Stall           ///< power off stall and recovery
+    };
+
+    static const double _step;          ///< [s] internal integration step
+
+    /** @return maneuver name */
+    static const char* name( Maneuver maneuver );
+
+    /**
+     * Constructor.
+     * @param seed random seed
+     */
+    explicit qfi_Scenario( quint32 seed = 1 );
+
+    /**
+     * Restarts scenario.
+     * @param seed random seed
+     */
+    void reset( quint32 seed );
+
+    /**
+     * Advances scenario.
+     * @param dt [s] time step, any positive value
+     */
+    void step( double dt );
+
+    /**
+     * Writes scenario to flight log, starting from the current time.
+     * @param fileName flight log file name
+     * @param duration [s] duration
+     * @param rate [Hz] sampling rate
+     * @return true on success, false otherwise
+     */
+    bool write( const QString &fileName, double duration, double rate );
+
+    /** @return [s] scenario time */
+    inline double time() const { return _time; }
+
+    /** @return current maneuver */
+    inline Maneuver maneuver() const { return _maneuver; }
+
+    /** @return number of started maneuvers */
+    inline int maneuvers() const { return _maneuvers; }
+
+    /** @return values of all qfi_FlightLog columns at the current time */
+    inline const double* values() const { return _values; }
+
+    /** @return value of the column at the current time */
+    inline double value( qfi_FlightLog::Column column ) const
+    {
+        return _values[ static_cast< int >( column ) ];
+    }
+
+private:
+
+    /** Aircraft state at the internal step. */
+    struct Aircraft
+    {
+        double roll;                    ///< [deg] roll angle
+        double pitch;                   ///< [deg] pitch angle
+        double heading;                 ///< [deg] heading
+        double airspeed;                ///< [kts] airspeed
+        double altitude;                ///< [ft] altitude
+        double climbRate;               ///< [ft/min] climb rate
+        double turnRate;                ///< [deg/s] turn rate
+        double slipSkid;                ///< normalized slip or skid
+        double aoa;                     ///< [deg] angle of attack
+        double pressure;                ///< [inHg] pressure
+        double course;                  ///< [deg] course
+        double bearing;                 ///< [deg] bearing
+        double distance;                ///< [nm] distance
+        double dotH;                    ///< normalized localizer deviation
+        double dotV;                    ///< normalized glideslope deviation
+        double crossTrack;              ///< [nm] cross track error
+        double gust;                    ///< [deg] turbulence roll disturbance
+    };
+
+    /** Maneuver targets. */
+    struct Targets
+    {
+        double roll;                    ///< [deg] roll angle
+        double pitch;                   ///< [deg] pitch angle, used in stall only
+        double heading;                 ///< [deg] heading
+        double airspeed;                ///< [kts] airspeed
+        double altitude;                ///< [ft] altitude
+        double climbRate;               ///< [ft/min] climb rate
+        double bank;                    ///< [deg] turn or wing drop bank angle
+        double verticalSpeed;           ///< [ft/min] maximum climb or descent rate
+    };
+
+    quint64 _random;                    ///< random generator state
+
+    Maneuver _maneuver;                 ///< current maneuver
+    int _maneuvers;                     ///< number of started maneuvers
+    int _phase;                         ///< maneuver phase
+    double _phaseTime;                  ///< [s] time in maneuver phase
+    double _duration;                   ///< [s] maneuver duration (cruise, approach)
+
+    Aircraft _aircraft;                 ///< aircraft state
+    Targets _targets;                   ///< maneuver targets
+
+    qfi_EADI::FltMode _fltMode;         ///< flight mode
+    qfi_EADI::SpdMode _spdMode;         ///< speed mode
+    qfi_EADI::LNAV _lnav;               ///< lateral navigation mode
+    qfi_EADI::VNAV _vnav;               ///< vertical navigation mode
+
+    bool _stall;                        ///< stall flag
+
+    qint64 _steps;                      ///< number of internal steps
+    double _time;                       ///< [s] scenario time
+
+    double _v0 [ qfi_FlightLog::_columns ];     ///< values at the previous internal step
+    double _v1 [ qfi_FlightLog::_columns ];     ///< values at the last internal step
+    double _values [ qfi_FlightLog::_columns ]; ///< values at the current time
+
+    double uniform( double min, double max );
+
+    void start( Maneuver maneuver );
+
+    void next();
+
+    void setPhase( int phase );
+
+    void control();
+
+    void integrate();
+
+    void update( double *values ) const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_SCENARIO_H
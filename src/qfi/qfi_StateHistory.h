@@ -0,0 +1,173 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_STATEHISTORY_H
+#define QFI_STATEHISTORY_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QtGlobal>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Instrument state history class template.
+ *
+ * Keeps the last N timestamped states in a fixed ring, so states may arrive
+ * at any rate (e.g. from a simulation or network) while the instrument is
+ * redrawn at display rate with a state sampled for the frame time. Between
+ * samples the state is interpolated, after the newest sample it is
+ * extrapolated from the last two samples, but not further than the maximum
+ * extrapolation time. Nothing is allocated after construction.
+ *
+ * T is an instrument State structure, it has to provide static function
+ * interpolate( const T &s0, const T &s1, double ratio, T *result ).
+ *
+ * Example:
+ * @code
+ * qfi_StateHistory< qfi_HI::State > history;
+ *
+ * // on every received sample
+ * history.push( sampleTime, state );
+ *
+ * // on every frame
+ * if ( history.sample( frameTime - delay, &state ) ) hi->setState( state );
+ * hi->redraw();
+ * @endcode
+ */
+template < class T, int N = 8 >
+class qfi_StateHistory
+{
+public:
+
+    /** Constructor. */
+    qfi_StateHistory() :
+        _newest ( N - 1 ),
+        _count ( 0 ),
+        _maxExtrapolation ( 100000 )
+    {}
+
+    /** Removes all samples. */
+    inline void clear()
+    {
+        _count = 0;
+    }
+
+    /**
+     * Adds sample. Samples older than the newest one are dropped, sample with
+     * the same time replaces the newest one.
+     * @param time [us] sample time
+     * @param state sample state
+     */
+    inline void push( qint64 time, const T &state )
+    {
+        if ( _count > 0 && time <= _times[ _newest ] )
+        {
+            if ( time == _times[ _newest ] ) _states[ _newest ] = state;
+            return;
+        }
+
+        _newest = ( _newest + 1 ) % N;
+
+        _times  [ _newest ] = time;
+        _states [ _newest ] = state;
+
+        if ( _count < N ) _count++;
+    }
+
+    /**
+     * Samples state for the given time.
+     * @param time [us] sampling time
+     * @param state output state
+     * @return false if there are no samples, true otherwise
+     */
+    inline bool sample( qint64 time, T *state ) const
+    {
+        if ( _count == 0 ) return false;
+
+        int i1 = _newest;
+
+        if ( _count == 1 )
+        {
+            *state = _states[ i1 ];
+            return true;
+        }
+
+        int i0 = index( 1 );
+
+        if ( time > _times[ i1 ] )
+        {
+            time = qMin( time, _times[ i1 ] + _maxExtrapolation );
+        }
+        else
+        {
+            for ( int i = 2; i < _count && time < _times[ i0 ]; i++ )
+            {
+                i1 = i0;
+                i0 = index( i );
+            }
+
+            if ( time <= _times[ i0 ] )
+            {
+                *state = _states[ i0 ];
+                return true;
+            }
+        }
+
+        double ratio = double( time - _times[ i0 ] ) / double( _times[ i1 ] - _times[ i0 ] );
+
+        T::interpolate( _states[ i0 ], _states[ i1 ], ratio, state );
+
+        return true;
+    }
+
+    /** @return number of samples */
+    inline int count() const { return _count; }
+
+    /** @return [us] newest sample time, 0 if there are no samples */
+    inline qint64 newestTime() const { return _count > 0 ? _times[ _newest ] : 0; }
+
+    /** @param maxExtrapolation [us] maximum extrapolation time (default 100 ms) */
+    inline void setMaxExtrapolation( qint64 maxExtrapolation )
+    {
+        _maxExtrapolation = qMax( Q_INT64_C( 0 ), maxExtrapolation );
+    }
+
+private:
+
+    qint64 _times  [ N ];       ///< [us] samples times
+    T      _states [ N ];       ///< samples states
+
+    int _newest;                ///< newest sample index
+    int _count;                 ///< number of samples
+
+    qint64 _maxExtrapolation;   ///< [us] maximum extrapolation time
+
+    /** @return index of the sample i-th from the newest one */
+    inline int index( int i ) const
+    {
+        return ( _newest - i + N ) % N;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_STATEHISTORY_H
@@ -0,0 +1,200 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_States.h>
+
+#include <qfi/qfi_FlightLog.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef qfi_FlightLog::Column Column;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+inline double value( const double *values, Column column )
+{
+    return values[ static_cast< int >( column ) ];
+}
+
+// values may come from the network or a file, so they are range checked
+// before being converted, out of range (or NaN) flags and modes are 0 (Off)
+
+const int allFlags = qfi_FlightLog::Stall
+                   | qfi_FlightLog::FpmVisible
+                   | qfi_FlightLog::FdVisible
+                   | qfi_FlightLog::DotVisibleH
+                   | qfi_FlightLog::DotVisibleV
+                   | qfi_FlightLog::BearingVisible
+                   | qfi_FlightLog::DistanceVisible;
+
+inline int flags( const double *values )
+{
+    const double f = value( values, Column::Flags );
+
+    return ( f >= 0.0 && f <= allFlags ) ? static_cast< int >( f ) : 0;
+}
+
+template < class T >
+inline T mode( const double *values, Column column, T last )
+{
+    const double m = value( values, column );
+
+    if ( m >= 0.0 && m <= static_cast< int >( last ) )
+    {
+        return static_cast< T >( static_cast< int >( m ) );
+    }
+
+    return static_cast< T >( 0 );
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_States::fromValues( const double *values, qfi_EADI::State *state )
+{
+    const int f = flags( values );
+
+    const qfi_EADI::PressureMode pressureMode = mode< qfi_EADI::PressureMode >( values, Column::PressureMode, qfi_EADI::PressureMode::IN );
+
+    // EADI shows pressure in units of the pressure mode
+    const double pressureCoef = ( pressureMode == qfi_EADI::PressureMode::MB ) ? 33.86 : 1.0;
+
+    state->fltMode      = mode< qfi_EADI::FltMode >( values, Column::FltMode , qfi_EADI::FltMode::CMD     );
+    state->spdMode      = mode< qfi_EADI::SpdMode >( values, Column::SpdMode , qfi_EADI::SpdMode::FMC_SPD );
+    state->lnav         = mode< qfi_EADI::LNAV    >( values, Column::LNAV    , qfi_EADI::LNAV::BC_ARM     );
+    state->vnav         = mode< qfi_EADI::VNAV    >( values, Column::VNAV    , qfi_EADI::VNAV::GS_ARM     );
+    state->pressureMode = pressureMode;
+    state->roll         = value( values, Column::Roll          );
+    state->pitch        = value( values, Column::Pitch         );
+    state->aoa          = value( values, Column::AngleOfAttack );
+    state->sideslip     = value( values, Column::Sideslip      );
+    state->slipSkid     = value( values, Column::SlipSkid      );
+    state->turnRate     = value( values, Column::TurnRate      ) / 6.0;
+    state->dotH         = value( values, Column::DotH          );
+    state->dotV         = value( values, Column::DotV          );
+    state->fdRoll       = value( values, Column::FdRoll        );
+    state->fdPitch      = value( values, Column::FdPitch       );
+    state->altitude     = value( values, Column::Altitude      );
+    state->pressure     = value( values, Column::Pressure      ) * pressureCoef;
+    state->airspeed     = value( values, Column::Airspeed      );
+    state->machNo       = value( values, Column::MachNo        );
+    state->heading      = value( values, Column::Heading       );
+    state->climbRate    = value( values, Column::ClimbRate     ) / 1000.0;
+    state->airspeedSel  = value( values, Column::AirspeedSel   );
+    state->altitudeSel  = value( values, Column::AltitudeSel   );
+    state->headingSel   = value( values, Column::HeadingSel    );
+    state->vfe          = value( values, Column::Vfe           );
+    state->vne          = value( values, Column::Vne           );
+    state->fpmVisible   = ( f & qfi_FlightLog::FpmVisible  ) != 0;
+    state->dotVisibleH  = ( f & qfi_FlightLog::DotVisibleH ) != 0;
+    state->dotVisibleV  = ( f & qfi_FlightLog::DotVisibleV ) != 0;
+    state->fdVisible    = ( f & qfi_FlightLog::FdVisible   ) != 0;
+    state->stall        = ( f & qfi_FlightLog::Stall       ) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_States::fromValues( const double *values, qfi_EHSI::State *state )
+{
+    const int f = flags( values );
+
+    state->heading         = value( values, Column::Heading    );
+    state->course          = value( values, Column::Course     );
+    state->bearing         = value( values, Column::Bearing    );
+    state->deviation       = value( values, Column::Deviation  );
+    state->distance        = value( values, Column::Distance   );
+    state->headingSel      = value( values, Column::HeadingSel );
+    state->cdi             = mode< CDI >( values, Column::CDI, CDI::FROM );
+    state->bearingVisible  = ( f & qfi_FlightLog::BearingVisible  ) != 0;
+    state->distanceVisible = ( f & qfi_FlightLog::DistanceVisible ) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_States::fromValues( const double *values, qfi_AI::State *state )
+{
+    state->roll  = value( values, Column::Roll  );
+    state->pitch = value( values, Column::Pitch );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_States::fromValues( const double *values, qfi_ALT::State *state )
+{
+    state->altitude = value( values, Column::Altitude );
+    state->pressure = value( values, Column::Pressure );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_States::fromValues( const double *values, qfi_ASI::State *state )
+{
+    state->airspeed = value( values, Column::Airspeed );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_States::fromValues( const double *values, qfi_HI::State *state )
+{
+    state->heading = value( values, Column::Heading );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_States::fromValues( const double *values, qfi_ILS::State *state )
+{
+    const int f = flags( values );
+
+    state->course   = value( values, Column::Course );
+    state->dotH     = value( values, Column::DotH   );
+    state->dotV     = value( values, Column::DotV   );
+    state->visibleH = ( f & qfi_FlightLog::DotVisibleH ) != 0;
+    state->visibleV = ( f & qfi_FlightLog::DotVisibleV ) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_States::fromValues( const double *values, qfi_TC::State *state )
+{
+    // TC ball angle of full scale slip or skid
+    state->turnRate = value( values, Column::TurnRate );
+    state->slipSkid = value( values, Column::SlipSkid ) * 15.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_States::fromValues( const double *values, qfi_VOR::State *state )
+{
+    state->course    = value( values, Column::Course    );
+    state->deviation = value( values, Column::Deviation );
+    state->cdi       = mode< CDI >( values, Column::CDI, CDI::FROM );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_States::fromValues( const double *values, qfi_VSI::State *state )
+{
+    state->climbRate = value( values, Column::ClimbRate );
+}
@@ -0,0 +1,71 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_STATES_H
+#define QFI_STATES_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <qfi/qfi_defs.h>
+
+#include <qfi/qfi_AI.h>
+#include <qfi/qfi_ALT.h>
+#include <qfi/qfi_ASI.h>
+#include <qfi/qfi_EADI.h>
+#include <qfi/qfi_EHSI.h>
+#include <qfi/qfi_HI.h>
+#include <qfi/qfi_ILS.h>
+#include <qfi/qfi_TC.h>
+#include <qfi/qfi_VOR.h>
+#include <qfi/qfi_VSI.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Instrument states conversion class.
+ *
+ * Makes instrument states of values of all qfi_FlightLog columns, converting
+ * units where instruments expect other ones (e.g. EADI normalized turn rate).
+ * Used by qfi_Replay and qfi_UdpReceiver.
+ */
+class QFIAPI qfi_States
+{
+public:
+
+    /**
+     * @param values array of qfi_FlightLog::Column::Count values
+     * @param state output state
+     */
+    static void fromValues( const double *values, qfi_EADI::State *state );
+    static void fromValues( const double *values, qfi_EHSI::State *state );
+    static void fromValues( const double *values, qfi_AI::State   *state );
+    static void fromValues( const double *values, qfi_ALT::State  *state );
+    static void fromValues( const double *values, qfi_ASI::State  *state );
+    static void fromValues( const double *values, qfi_HI::State   *state );
+    static void fromValues( const double *values, qfi_ILS::State  *state );
+    static void fromValues( const double *values, qfi_TC::State   *state );
+    static void fromValues( const double *values, qfi_VOR::State  *state );
+    static void fromValues( const double *values, qfi_VSI::State  *state );
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_STATES_H
@@ -28,43 +28,73 @@
 
 #include <cmath>
 
+#include <qfi/qfi_Cache.h>
+#include <qfi/qfi_CachedSvgItem.h>
+#include <qfi/qfi_Interpolation.h>
+#include <qfi/qfi_Latency.h>
+#include <qfi/qfi_Offscreen.h>
+#include <qfi/qfi_Profiler.h>
+#include <qfi/qfi_Renderers.h>
+#include <qfi/qfi_Trace.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 
-qfi_TC::qfi_TC( QWidget *parent ) :
+qfi_TC::qfi_TC( QWidget *parent, RenderBackend backend ) :
     QGraphicsView ( parent ),
 
     _scene ( Q_NULLPTR ),
 
+    _resizeTimer ( Q_NULLPTR ),
+
+    _backend ( backend ),
+
     _itemBack   ( Q_NULLPTR ),
     _itemBall   ( Q_NULLPTR ),
-    _itemFace_1 ( Q_NULLPTR ),
-    _itemFace_2 ( Q_NULLPTR ),
+    _itemFace   ( Q_NULLPTR ),
     _itemMark   ( Q_NULLPTR ),
     _itemCase   ( Q_NULLPTR ),
 
     _turnRate ( 0.0 ),
     _slipSkid ( 0.0 ),
 
+    _turnRate_old ( 0.0 ),
+    _slipSkid_old ( 0.0 ),
+
+    _dirty ( true ),
+
+    _suppressedRedraws ( 0 ),
+
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
 
+    _atlasStep ( 0.0 ),
+
     _originalHeight ( 240 ),
     _originalWidth  ( 240 ),
 
+    _originalMarkRadius ( 60.0 ),
+    _originalBallRadius ( 200.0 ),
+
     _originalMarkCtr ( 120.0 , 120.0 ),
     _originalBallCtr ( 120.0 , -36.0 ),
 
     _backZ  ( -70 ),
     _ballZ  ( -60 ),
-    _face1Z ( -50 ),
-    _face2Z ( -40 ),
+    _faceZ  ( -50 ),
     _markZ  ( -30 ),
     _caseZ  (  10 )
 {
     reset();
 
     _scene = new QGraphicsScene( this );
-    setScene( _scene );
+
+    // painter backend draws items itself, the view has no scene
+    if ( _backend == RenderBackend::Scene ) setScene( _scene );
+
+    _resizeTimer = new QTimer( this );
+    _resizeTimer->setSingleShot( true );
+    _resizeTimer->setInterval( 200 );
+    connect( _resizeTimer, &QTimer::timeout, this, &qfi_TC::reinit );
 
     _scene->clear();
 
@@ -91,7 +121,12 @@ void qfi_TC::reinit()
 {
     if ( _scene )
     {
+        _resizeTimer->stop();
+
+        resetTransform();
+
         _scene->clear();
+        _direct.clear();
 
         init();
     }
@@ -102,29 +137,128 @@ void qfi_TC::reinit()
 void qfi_TC::redraw()
 {
     if ( isVisible() )
+    {
+        State state;
+
+        if ( _stateBuffer.consume( &state ) ) setState( state );
+
+        if ( _dirty )
+        {
+            updateView();
+        }
+        else
+        {
+            _suppressedRedraws++;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_TC::renderImage( QImage &image )
+{
+    QSize size = qfi_Offscreen::size( image );
+
+    if ( size.isEmpty() ) return;
+
+    State state;
+
+    if ( _stateBuffer.consume( &state ) ) setState( state );
+
+    if ( !isVisible() && size != this->size() )
+    {
+        resize( size );
+        reinit();
+    }
+
+    if ( _dirty )
     {
         updateView();
     }
+
+    QRectF source( 0.0, 0.0, _scaleX * _originalWidth, _scaleY * _originalHeight );
+
+    if ( _backend == RenderBackend::Painter )
+    {
+        qfi_Offscreen::render( _direct, source, image, renderHints() );
+    }
+    else
+    {
+        qfi_Offscreen::render( _scene, source, image, renderHints() );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_TC::setState( const State &state )
+{
+    if ( _stateHook ) _stateHook( state );
+
+    setTurnRate( state.turnRate );
+    setSlipSkid( state.slipSkid );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_TC::State::interpolate( const State &s0, const State &s1, double ratio, State *result )
+{
+    result->turnRate = qfi_Interpolation::linear( s0.turnRate, s1.turnRate, ratio );
+    result->slipSkid = qfi_Interpolation::linear( s0.slipSkid, s1.slipSkid, ratio );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_TC::setTurnRate( double turnRate )
 {
+    if ( turnRate < -6.0 ) turnRate = -6.0;
+    if ( turnRate >  6.0 ) turnRate =  6.0;
+
+    // 20 deg of mark rotation per 3 deg/s
+    double pxPerDps = ( 20.0 / 3.0 ) * qfi_Dirty::pxPerDeg( _originalMarkRadius * qMin( _scaleX, _scaleY ) );
+
     _turnRate = turnRate;
 
-    if ( _turnRate < -6.0 ) _turnRate = -6.0;
-    if ( _turnRate >  6.0 ) _turnRate =  6.0;
+    if ( qfi_Dirty::isChanged( _turnRate, _turnRate_old, pxPerDps ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_TC::setSlipSkid( double slipSkid )
 {
+    if ( slipSkid < -15.0 ) slipSkid = -15.0;
+    if ( slipSkid >  15.0 ) slipSkid =  15.0;
+
+    double pxPerDeg = qfi_Dirty::pxPerDeg( _originalBallRadius * qMin( _scaleX, _scaleY ) );
+
     _slipSkid = slipSkid;
 
-    if ( _slipSkid < -15.0 ) _slipSkid = -15.0;
-    if ( _slipSkid >  15.0 ) _slipSkid =  15.0;
+    if ( qfi_Dirty::isChanged( _slipSkid, _slipSkid_old, pxPerDeg ) )
+    {
+        _dirty = true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_TC::setAtlasStep( double step )
+{
+    _atlasStep = step;
+
+    if ( _itemMark ) _itemMark->setAngleStep( _atlasStep );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_TC::atlasBytes() const
+{
+    qint64 bytes = 0;
+
+    if ( _itemMark ) bytes += _itemMark->atlasBytes();
+
+    return bytes;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -135,7 +269,55 @@ void qfi_TC::resizeEvent( QResizeEvent *event )
     QGraphicsView::resizeEvent( event );
     ////////////////////////////////////
 
-    reinit();
+    if ( isVisible() && _itemCase )
+    {
+        rescale();
+    }
+    else
+    {
+        reinit();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_TC::paintEvent( QPaintEvent *event )
+{
+    if ( _backend == RenderBackend::Scene )
+    {
+        QGraphicsView::paintEvent( event );
+        return;
+    }
+
+    QPainter painter( viewport() );
+    painter.setRenderHints( renderHints() );
+
+    // the same area the scene view shows, centered in the viewport
+    QRectF target( 0.5 * ( viewport()->width()  - width()  ),
+                   0.5 * ( viewport()->height() - height() ),
+                   width(), height() );
+
+    _direct.render( &painter, target,
+                    QRectF( 0.0, 0.0, _scaleX * _originalWidth, _scaleY * _originalHeight ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_TC::rescale()
+{
+    // items and their state are kept, the scene is rebuilt at the new scale
+    // once the size settles
+    setTransform( QTransform::fromScale( width()  / ( _scaleX * _originalWidth  ),
+                                         height() / ( _scaleY * _originalHeight ) ) );
+
+    centerOn( _scaleX * _originalWidth / 2.0 , _scaleY * _originalHeight / 2.0 );
+
+    // changes too small to be visible at the previous size may be visible now
+    _dirty = true;
+
+    qfi_Cache::deferRebuilds( _resizeTimer->interval() );
+
+    _resizeTimer->start();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -147,43 +329,40 @@ void qfi_TC::init()
 
     reset();
 
-    _itemBack = new QGraphicsSvgItem( ":/qfi/images/tc/tc_back.svg" );
+    _itemBack = new qfi_CachedSvgItem( ":/qfi/images/tc/tc_back.svg" );
     _itemBack->setCacheMode( QGraphicsItem::NoCache );
     _itemBack->setZValue( _backZ );
     _itemBack->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
-    _scene->addItem( _itemBack );
+    addItem( _itemBack );
 
-    _itemBall = new QGraphicsSvgItem( ":/qfi/images/tc/tc_ball.svg" );
+    _itemBall = qfi_Renderers::createItem( ":/qfi/images/tc/tc_ball.svg" );
     _itemBall->setCacheMode( QGraphicsItem::NoCache );
     _itemBall->setZValue( _ballZ );
     _itemBall->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemBall->setTransformOriginPoint( _originalBallCtr );
-    _scene->addItem( _itemBall );
-
-    _itemFace_1 = new QGraphicsSvgItem( ":/qfi/images/tc/tc_face_1.svg" );
-    _itemFace_1->setCacheMode( QGraphicsItem::NoCache );
-    _itemFace_1->setZValue( _face1Z );
-    _itemFace_1->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
-    _scene->addItem( _itemFace_1 );
+    addItem( _itemBall );
 
-    _itemFace_2 = new QGraphicsSvgItem( ":/qfi/images/tc/tc_face_2.svg" );
-    _itemFace_2->setCacheMode( QGraphicsItem::NoCache );
-    _itemFace_2->setZValue( _face2Z );
-    _itemFace_2->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
-    _scene->addItem( _itemFace_2 );
+    // both face layers are static and adjacent in the Z order
+    _itemFace = new qfi_CachedSvgItem( ":/qfi/images/tc/tc_face_1.svg" );
+    _itemFace->addLayer( ":/qfi/images/tc/tc_face_2.svg" );
+    _itemFace->setCacheMode( QGraphicsItem::NoCache );
+    _itemFace->setZValue( _faceZ );
+    _itemFace->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
+    addItem( _itemFace );
 
-    _itemMark = new QGraphicsSvgItem( ":/qfi/images/tc/tc_mark.svg" );
+    _itemMark = new qfi_AtlasSvgItem( ":/qfi/images/tc/tc_mark.svg" );
     _itemMark->setCacheMode( QGraphicsItem::NoCache );
     _itemMark->setZValue( _markZ );
     _itemMark->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
+    _itemMark->setAngleStep( _atlasStep );
     _itemMark->setTransformOriginPoint( _originalMarkCtr );
-    _scene->addItem( _itemMark );
+    addItem( _itemMark );
 
-    _itemCase = new QGraphicsSvgItem( ":/qfi/images/tc/tc_case.svg" );
+    _itemCase = new qfi_CachedSvgItem( ":/qfi/images/tc/tc_case.svg" );
     _itemCase->setCacheMode( QGraphicsItem::NoCache );
     _itemCase->setZValue( _caseZ );
     _itemCase->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
-    _scene->addItem( _itemCase );
+    addItem( _itemCase );
 
     centerOn( width() / 2.0 , height() / 2.0 );
 
@@ -192,25 +371,38 @@ void qfi_TC::init()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void qfi_TC::addItem( QGraphicsItem *item )
+{
+    if ( _backend == RenderBackend::Painter )
+    {
+        _direct.addItem( item );
+    }
+    else
+    {
+        _scene->addItem( item );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void qfi_TC::reset()
 {
     _itemBack   = Q_NULLPTR;
     _itemBall   = Q_NULLPTR;
-    _itemFace_1 = Q_NULLPTR;
-    _itemFace_2 = Q_NULLPTR;
+    _itemFace   = Q_NULLPTR;
     _itemMark   = Q_NULLPTR;
     _itemCase   = Q_NULLPTR;
 
-    _turnRate = 0.0;
-    _slipSkid = 0.0;
+    _dirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_TC::updateView()
 {
-    _scaleX = static_cast< double >( width()  ) / static_cast< double >( _originalWidth  );
-    _scaleY = static_cast< double >( height() ) / static_cast< double >( _originalHeight );
+    QFI_PROFILE( "qfi_TC::updateView" );
+    QFI_TRACE( "updateView", "qfi_TC" );
+    qfi_Latency::updated( this );
 
     _itemBall->setRotation( -_slipSkid );
 
@@ -218,5 +410,17 @@ void qfi_TC::updateView()
 
     _itemMark->setRotation( angle );
 
-    _scene->update();
+    _turnRate_old = _turnRate;
+    _slipSkid_old = _slipSkid;
+
+    _dirty = false;
+
+    if ( _backend == RenderBackend::Painter )
+    {
+        viewport()->update();
+    }
+    else
+    {
+        _scene->update();
+    }
 }
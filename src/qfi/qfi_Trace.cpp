@@ -0,0 +1,225 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_Trace.h>
+
+#include <QFile>
+#include <QHash>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QThread>
+
+#include <qfi/qfi_PaintHook.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+QAtomicInteger< int > qfi_Trace::_active( 0 );
+
+QMutex qfi_Trace::_mutex;
+
+QElapsedTimer qfi_Trace::_clock;
+
+QVector< qfi_Trace::Event > qfi_Trace::_events;
+
+int qfi_Trace::_maxEvents = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Trace::Scope::Scope( const char *name, const char *instrument ) :
+    _name       ( name ),
+    _instrument ( instrument ),
+    _start      ( -1 )
+{
+    if ( qfi_Trace::isActive() ) _start = qfi_Trace::now();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Trace::Scope::~Scope()
+{
+    if ( _start >= 0 && qfi_Trace::isActive() )
+    {
+        qfi_Trace::complete( _name, _instrument, _start, qfi_Trace::now() - _start );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Trace::start( int maxEvents )
+{
+    QMutexLocker locker( &_mutex );
+
+    _events.clear();
+    _events.reserve( qMin( maxEvents, 65536 ) );
+
+    _maxEvents = maxEvents;
+
+    _clock.start();
+
+    _active.storeRelease( 1 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Trace::stop()
+{
+    _active.storeRelease( 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_Trace::now()
+{
+    return _clock.isValid() ? _clock.nsecsElapsed() / 1000 : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Trace::complete( const char *name, const char *instrument,
+                          qint64 start, qint64 duration )
+{
+    if ( !isActive() ) return;
+
+    Event event;
+
+    event.name       = name;
+    event.instrument = instrument;
+    event.start      = start;
+    event.duration   = duration;
+    event.thread     = reinterpret_cast< quintptr >( QThread::currentThreadId() );
+
+    record( event );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Trace::instant( const char *name, const char *instrument )
+{
+    if ( !isActive() ) return;
+
+    Event event;
+
+    event.name       = name;
+    event.instrument = instrument;
+    event.start      = now();
+    event.duration   = -1;
+    event.thread     = reinterpret_cast< quintptr >( QThread::currentThreadId() );
+
+    record( event );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Trace::addView( QGraphicsView *view )
+{
+    if ( !view ) return;
+
+    const char *instrument = view->metaObject()->className();
+
+    qfi_PaintHook::subscribe( view->viewport(), instance(), [ instrument ]( qint64 duration )
+    {
+        if ( !isActive() ) return;
+
+        const qint64 end = now();
+
+        complete( "paint", instrument, end - duration / 1000, duration / 1000 );
+    } );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_Trace::save( const QString &fileName )
+{
+    QFile file( fileName );
+
+    if ( !file.open( QIODevice::WriteOnly | QIODevice::Text ) ) return false;
+
+    QMutexLocker locker( &_mutex );
+
+    QTextStream out( &file );
+
+    // thread IDs are replaced with consecutive numbers, GUI thread first
+    QHash< quintptr, int > threads;
+    threads.insert( reinterpret_cast< quintptr >( QThread::currentThreadId() ), 1 );
+
+    out << "{\"traceEvents\":[\n";
+
+    for ( int i = 0; i < _events.size(); i++ )
+    {
+        const Event &event = _events.at( i );
+
+        if ( !threads.contains( event.thread ) )
+        {
+            threads.insert( event.thread, static_cast< int >( threads.size() ) + 1 );
+        }
+
+        out << "{\"name\":\"" << event.name << "\",\"cat\":\"qfi\"";
+
+        if ( event.duration < 0 )
+        {
+            out << ",\"ph\":\"i\",\"s\":\"t\"";
+        }
+        else
+        {
+            out << ",\"ph\":\"X\",\"dur\":" << event.duration;
+        }
+
+        out << ",\"ts\":" << event.start
+            << ",\"pid\":1,\"tid\":" << threads.value( event.thread );
+
+        if ( event.instrument )
+        {
+            out << ",\"args\":{\"instrument\":\"" << event.instrument << "\"}";
+        }
+
+        out << ( i + 1 < _events.size() ? "},\n" : "}\n" );
+    }
+
+    out << "],\"displayTimeUnit\":\"ms\"}\n";
+
+    return out.status() == QTextStream::Ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Trace::qfi_Trace() :
+    QObject ( Q_NULLPTR )
+{}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_Trace* qfi_Trace::instance()
+{
+    static qfi_Trace trace;
+    return &trace;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_Trace::record( const Event &event )
+{
+    QMutexLocker locker( &_mutex );
+
+    if ( _events.size() < _maxEvents )
+    {
+        _events.push_back( event );
+    }
+}
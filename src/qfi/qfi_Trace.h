@@ -0,0 +1,153 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_TRACE_H
+#define QFI_TRACE_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QGraphicsView>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include <qfi/qfi_defs.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define QFI_TRACE( name, instrument ) \
+    qfi_Trace::Scope qfi_trace_scope( name, instrument )
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Frame timeline tracer class.
+ *
+ * Records timeline events (setters, updateView(), scene paint, parallel
+ * render and present) of all instruments and saves them in the Chrome trace
+ * event JSON format, which can be loaded into Perfetto UI or chrome://tracing.
+ * Tracing is off by default and costs a single atomic load per event then.
+ *
+ * Names and instrument names of events have to be string literals or class
+ * names from meta objects, they are stored as pointers.
+ */
+class QFIAPI qfi_Trace : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /** Records duration of the enclosing scope. */
+    class QFIAPI Scope
+    {
+    public:
+
+        Scope( const char *name, const char *instrument = Q_NULLPTR );
+
+        ~Scope();
+
+    private:
+
+        const char *_name;          ///< event name
+        const char *_instrument;    ///< instrument name
+        qint64 _start;              ///< [us] start time, -1 if not tracing
+    };
+
+    /**
+     * Starts tracing, discards previously recorded events.
+     * @param maxEvents maximum number of recorded events
+     */
+    static void start( int maxEvents = 1000000 );
+
+    /** Stops tracing, recorded events are kept. */
+    static void stop();
+
+    /** @return true if tracing is active */
+    static inline bool isActive() { return _active.loadAcquire() != 0; }
+
+    /** @return [us] time since tracing has been started */
+    static qint64 now();
+
+    /**
+     * Records complete event.
+     * @param name event name
+     * @param instrument instrument name (may be null)
+     * @param start [us] start time
+     * @param duration [us] duration
+     */
+    static void complete( const char *name, const char *instrument,
+                          qint64 start, qint64 duration );
+
+    /**
+     * Records instant event.
+     * @param name event name
+     * @param instrument instrument name (may be null)
+     */
+    static void instant( const char *name, const char *instrument = Q_NULLPTR );
+
+    /**
+     * Traces painting of the view.
+     * @param view traced view
+     */
+    static void addView( QGraphicsView *view );
+
+    /**
+     * Saves recorded events.
+     * @param fileName output file name
+     * @return true on success, false on failure
+     */
+    static bool save( const QString &fileName );
+
+private:
+
+    /** Trace event. */
+    struct Event
+    {
+        const char *name;           ///< event name
+        const char *instrument;     ///< instrument name
+        qint64 start;               ///< [us] start time
+        qint64 duration;            ///< [us] duration, -1 for instant events
+        quintptr thread;            ///< thread ID
+    };
+
+    static QAtomicInteger< int > _active;
+
+    static QMutex _mutex;
+
+    static QElapsedTimer _clock;
+
+    static QVector< Event > _events;
+
+    static int _maxEvents;
+
+    qfi_Trace();
+
+    static qfi_Trace* instance();
+
+    static void record( const Event &event );
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_TRACE_H
@@ -0,0 +1,102 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_TRIPLEBUFFER_H
+#define QFI_TRIPLEBUFFER_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QAtomicInteger>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Lock-free triple buffer class template.
+ *
+ * Hands values over from a single producer thread to a single consumer
+ * thread. Neither side ever blocks nor allocates: producer always writes
+ * to its own slot and then swaps it with the middle one, consumer swaps its
+ * slot with the middle one only if a new value has been published since.
+ * Consumer always gets the newest complete value, intermediate values may
+ * be skipped.
+ *
+ * T has to be copy-assignable, typically a plain data state structure.
+ */
+template < class T >
+class qfi_TripleBuffer
+{
+public:
+
+    /** Constructor. */
+    qfi_TripleBuffer() :
+        _middle ( 1 ),
+        _back   ( 0 ),
+        _front  ( 2 )
+    {}
+
+    /**
+     * Publishes value. Producer thread only.
+     * @param value published value
+     */
+    inline void publish( const T &value )
+    {
+        _slots[ _back ] = value;
+
+        int middle = _middle.fetchAndStoreAcquireRelease( _back | _fresh );
+
+        _back = middle & _index;
+    }
+
+    /**
+     * Takes the newest value if it has been published since the last call.
+     * Consumer thread only.
+     * @param value output value
+     * @return true if a new value has been taken, false otherwise
+     */
+    inline bool consume( T *value )
+    {
+        if ( !( _middle.loadAcquire() & _fresh ) ) return false;
+
+        int middle = _middle.fetchAndStoreAcquireRelease( _front );
+
+        _front = middle & _index;
+
+        *value = _slots[ _front ];
+
+        return true;
+    }
+
+private:
+
+    static const int _index = 0x3;      ///< slot index mask
+    static const int _fresh = 0x4;      ///< new value flag
+
+    T _slots[ 3 ];                      ///< value slots
+
+    QAtomicInteger< int > _middle;      ///< middle slot index and new value flag
+
+    int _back;                          ///< slot owned by producer
+    int _front;                         ///< slot owned by consumer
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_TRIPLEBUFFER_H
@@ -0,0 +1,450 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#include <qfi/qfi_UdpReceiver.h>
+
+#include <QThread>
+#include <QUdpSocket>
+#include <QtEndian>
+#include <QtNumeric>
+
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#   include <poll.h>
+#   include <sys/socket.h>
+#   include <sys/uio.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+const int timeout = 100;                ///< [ms] stop request check period
+
+/** Receiver thread. */
+class ReceiverThread : public QThread
+{
+public:
+
+    explicit ReceiverThread( const std::function< void() > &function ) :
+        _function ( function )
+    {}
+
+protected:
+
+    void run() override { _function(); }
+
+private:
+
+    std::function< void() > _function;
+};
+
+template < class T >
+inline T load( const char *data, bool bigEndian )
+{
+    const uchar *src = reinterpret_cast< const uchar* >( data );
+    return bigEndian ? qFromBigEndian< T >( src ) : qFromLittleEndian< T >( src );
+}
+
+inline double read( const char *data, qfi_UdpReceiver::Type type, bool bigEndian )
+{
+    switch ( type )
+    {
+        case qfi_UdpReceiver::Type::Float32:
+        {
+            const quint32 raw = load< quint32 >( data, bigEndian );
+            float value;
+            memcpy( &value, &raw, sizeof( value ) );
+            return value;
+        }
+
+        case qfi_UdpReceiver::Type::Float64:
+        {
+            const quint64 raw = load< quint64 >( data, bigEndian );
+            double value;
+            memcpy( &value, &raw, sizeof( value ) );
+            return value;
+        }
+
+        case qfi_UdpReceiver::Type::Int16:
+            return static_cast< qint16 >( load< quint16 >( data, bigEndian ) );
+
+        case qfi_UdpReceiver::Type::Int32:
+            return static_cast< qint32 >( load< quint32 >( data, bigEndian ) );
+    }
+
+    return 0.0;
+}
+
+inline int size( qfi_UdpReceiver::Type type )
+{
+    switch ( type )
+    {
+        case qfi_UdpReceiver::Type::Float32: return 4;
+        case qfi_UdpReceiver::Type::Float64: return 8;
+        case qfi_UdpReceiver::Type::Int16:   return 2;
+        case qfi_UdpReceiver::Type::Int32:   return 4;
+    }
+
+    return 0;
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_UdpReceiver::Field qfi_UdpReceiver::field( qfi_FlightLog::Column column, int offset,
+                                               Type type, bool bigEndian,
+                                               double scale, double bias )
+{
+    Field result;
+
+    result.offset    = offset;
+    result.type      = type;
+    result.bigEndian = bigEndian;
+    result.scale     = scale;
+    result.bias      = bias;
+    result.column    = column;
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_UdpReceiver::now()
+{
+    return qfi_Latency::now();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_UdpReceiver::qfi_UdpReceiver( int batchSize, int datagramSize, QObject *parent ) :
+    QObject ( parent ),
+
+    _batchSize    ( qMax( 1, batchSize    ) ),
+    _datagramSize ( qMax( 1, datagramSize ) ),
+
+    _minSize ( 0 ),
+
+    _socket ( Q_NULLPTR ),
+    _thread ( Q_NULLPTR ),
+
+    _port ( 0 ),
+
+    _stopping ( 0 ),
+    _pending  ( 0 ),
+
+    _datagrams   ( 0 ),
+    _batches     ( 0 ),
+    _rejected    ( 0 ),
+    _lastArrival ( 0 )
+{
+    for ( int i = 0; i < qfi_FlightLog::_columns; i++ )
+    {
+        _values[ i ] = 0.0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qfi_UdpReceiver::~qfi_UdpReceiver()
+{
+    stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_UdpReceiver::setMapping( const QVector< Field > &mapping )
+{
+    if ( isRunning() ) return;
+
+    _mapping.clear();
+    _minSize = _header.size();
+
+    for ( int i = 0; i < mapping.size(); i++ )
+    {
+        const Field &field = mapping.at( i );
+        const int column = static_cast< int >( field.column );
+
+        if ( column < 0 || column >= qfi_FlightLog::_columns ) continue;
+
+        if ( field.offset < 0 )
+        {
+            // constant values are set once
+            _values[ column ] = field.bias;
+        }
+        else
+        {
+            _mapping.push_back( field );
+            _minSize = qMax( _minSize, field.offset + size( field.type ) );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_UdpReceiver::setHeader( const QByteArray &header )
+{
+    if ( isRunning() ) return;
+
+    _header = header;
+
+    setMapping( QVector< Field >( _mapping ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_UdpReceiver::start( quint16 port, const QHostAddress &address )
+{
+    if ( isRunning() ) return false;
+
+    _socket = new QUdpSocket();
+
+    if ( !_socket->bind( address, port ) )
+    {
+        delete _socket;
+        _socket = Q_NULLPTR;
+
+        return false;
+    }
+
+    // bursts are buffered by the kernel while a batch is being parsed
+    _socket->setSocketOption( QAbstractSocket::ReceiveBufferSizeSocketOption, 1 << 20 );
+
+    _port = _socket->localPort();
+
+    _buffers.resize( _batchSize * _datagramSize );
+
+    _stopping.storeRelease( 0 );
+
+    _thread = new ReceiverThread( [ this ]() { receive(); } );
+
+    _socket->moveToThread( _thread );
+
+    _thread->start( QThread::TimeCriticalPriority );
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_UdpReceiver::stop()
+{
+    if ( !isRunning() ) return;
+
+    _stopping.storeRelease( 1 );
+
+    _thread->wait();
+
+    delete _thread;
+    _thread = Q_NULLPTR;
+
+    _port = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_UdpReceiver::sampleStates()
+{
+    const qint64 time = now() / 1000;
+
+    for ( int i = 0; i < _samplers.size(); i++ )
+    {
+        _samplers.at( i )( time );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_UdpReceiver::notify()
+{
+    _pending.storeRelease( 0 );
+
+    emit received();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_UdpReceiver::addPublisher( const std::function< void( const double*, qint64 ) > &publisher )
+{
+    if ( isRunning() ) return;
+
+    _publishers.push_back( publisher );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_UdpReceiver::addSampler( const std::function< void( qint64 ) > &sampler )
+{
+    if ( isRunning() ) return;
+
+    _samplers.push_back( sampler );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool qfi_UdpReceiver::parse( const char *data, qint64 size )
+{
+    if ( size < _minSize || size > _datagramSize
+      || memcmp( data, _header.constData(), _header.size() ) != 0 )
+    {
+        _rejected.fetchAndAddRelaxed( 1 );
+        return false;
+    }
+
+    // datagram is taken whole or not at all, infinite or NaN values would
+    // stall the instruments normalizing angles
+    double values[ qfi_FlightLog::_columns ];
+    memcpy( values, _values, sizeof( values ) );
+
+    for ( int i = 0; i < _mapping.size(); i++ )
+    {
+        const Field &field = _mapping.at( i );
+
+        const double value = read( data + field.offset, field.type, field.bigEndian ) * field.scale + field.bias;
+
+        if ( !qIsFinite( value ) )
+        {
+            _rejected.fetchAndAddRelaxed( 1 );
+            return false;
+        }
+
+        values[ static_cast< int >( field.column ) ] = value;
+    }
+
+    memcpy( _values, values, sizeof( values ) );
+
+    _datagrams.fetchAndAddRelaxed( 1 );
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_UdpReceiver::publish( qint64 arrival )
+{
+    for ( int i = 0; i < _publishers.size(); i++ )
+    {
+        _publishers.at( i )( _values, arrival );
+    }
+
+    _batches.fetchAndAddRelaxed( 1 );
+    _lastArrival.storeRelease( arrival );
+
+    if ( !_pending.fetchAndStoreAcquire( 1 ) )
+    {
+        QMetaObject::invokeMethod( this, "notify", Qt::QueuedConnection );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_UdpReceiver::receive()
+{
+    char *buffers = _buffers.data();
+
+#   ifdef Q_OS_LINUX
+    const int fd = static_cast< int >( _socket->socketDescriptor() );
+
+    QVector< mmsghdr > messages( _batchSize );
+    QVector< iovec > vectors( _batchSize );
+
+    for ( int i = 0; i < _batchSize; i++ )
+    {
+        vectors[ i ].iov_base = buffers + i * _datagramSize;
+        vectors[ i ].iov_len  = static_cast< size_t >( _datagramSize );
+
+        memset( &messages[ i ], 0, sizeof( mmsghdr ) );
+        messages[ i ].msg_hdr.msg_iov    = &vectors[ i ];
+        messages[ i ].msg_hdr.msg_iovlen = 1;
+    }
+
+    while ( !_stopping.loadAcquire() )
+    {
+        pollfd pfd;
+        pfd.fd      = fd;
+        pfd.events  = POLLIN;
+        pfd.revents = 0;
+
+        if ( poll( &pfd, 1, timeout ) <= 0 ) continue;
+
+        const int count = recvmmsg( fd, messages.data(), static_cast< unsigned int >( _batchSize ),
+                                    MSG_DONTWAIT, Q_NULLPTR );
+
+        if ( count <= 0 ) continue;
+
+        const qint64 arrival = now();
+
+        bool accepted = false;
+
+        for ( int i = 0; i < count; i++ )
+        {
+            const mmsghdr &message = messages.at( i );
+
+            if ( message.msg_hdr.msg_flags & MSG_TRUNC )
+            {
+                _rejected.fetchAndAddRelaxed( 1 );
+            }
+            else
+            {
+                accepted |= parse( buffers + i * _datagramSize, message.msg_len );
+            }
+
+            messages[ i ].msg_hdr.msg_flags = 0;
+        }
+
+        if ( accepted ) publish( arrival );
+    }
+#   else
+    while ( !_stopping.loadAcquire() )
+    {
+        if ( !_socket->waitForReadyRead( timeout ) ) continue;
+
+        const qint64 arrival = now();
+
+        bool accepted = false;
+
+        for ( int i = 0; i < _batchSize && _socket->hasPendingDatagrams(); i++ )
+        {
+            const qint64 pending = _socket->pendingDatagramSize();
+            const qint64 length  = _socket->readDatagram( buffers, _datagramSize );
+
+            if ( length < 0 ) break;
+
+            if ( pending > _datagramSize )
+            {
+                _rejected.fetchAndAddRelaxed( 1 );
+            }
+            else
+            {
+                accepted |= parse( buffers, length );
+            }
+        }
+
+        if ( accepted ) publish( arrival );
+    }
+#   endif
+
+    delete _socket;
+    _socket = Q_NULLPTR;
+}
@@ -0,0 +1,317 @@
+/****************************************************************************//*
+ * Copyright (C) 2021 Marek M. Cel
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ ******************************************************************************/
+#ifndef QFI_UDPRECEIVER_H
+#define QFI_UDPRECEIVER_H
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QHostAddress>
+#include <QObject>
+#include <QVector>
+
+#include <functional>
+#include <memory>
+
+#include <qfi/qfi_defs.h>
+#include <qfi/qfi_FlightLog.h>
+#include <qfi/qfi_Latency.h>
+#include <qfi/qfi_StateHistory.h>
+#include <qfi/qfi_States.h>
+#include <qfi/qfi_TripleBuffer.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+class QThread;
+class QUdpSocket;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief UDP flight data receiver class.
+ *
+ * Receives flight data datagrams on a dedicated thread and publishes
+ * instrument states to the state buffers of the registered instruments (see
+ * qfi_TripleBuffer), so the GUI thread only consumes the newest states when
+ * redrawing. On Linux datagrams are received in batches with recvmmsg() into
+ * preallocated buffers, elsewhere QUdpSocket is read until the batch is full
+ * or no datagram is pending. Fields are read in place, as given by the field
+ * mapping, into values of qfi_FlightLog columns; values not contained in
+ * a datagram keep the last received ones. States are published once per
+ * batch, instruments are stamped with the batch arrival time (see
+ * qfi_Latency). Instruments registered with addSmoothedInstrument() are
+ * given states interpolated for the frame time instead (see
+ * qfi_StateHistory), so they move smoothly even if data come at lower or
+ * irregular rate than frames.
+ *
+ * Mapping, header and instruments have to be set before start(), instruments
+ * have to outlive the receiver or it has to be stopped before they are
+ * deleted.
+ *
+ * The receiver is compiled in only with CONFIG += qfi_network, which adds
+ * the Qt network module to the project (see qfi.pri).
+ *
+ * Usage:
+ * @code
+ * QVector< qfi_UdpReceiver::Field > mapping;
+ * mapping.push_back( qfi_UdpReceiver::field( qfi_FlightLog::Column::Roll  , 4 ) );
+ * mapping.push_back( qfi_UdpReceiver::field( qfi_FlightLog::Column::Pitch , 8 ) );
+ * ...
+ * receiver->setHeader( "DATA" );
+ * receiver->setMapping( mapping );
+ * receiver->addInstrument( ai );
+ * connect( receiver, &qfi_UdpReceiver::received, scheduler, &qfi_FrameScheduler::requestFrame );
+ * receiver->start( 49000 );
+ * @endcode
+ */
+class QFIAPI qfi_UdpReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /** Field type. */
+    enum class Type
+    {
+        Float32 = 0,    ///< 32-bit IEEE 754 floating point
+        Float64,        ///< 64-bit IEEE 754 floating point
+        Int16,          ///< 16-bit signed integer
+        Int32           ///< 32-bit signed integer
+    };
+
+    /** Datagram field, value = raw * scale + bias. */
+    struct Field
+    {
+        int offset;                     ///< [B] offset in datagram, negative for constant value (bias)
+        Type type;                      ///< field type
+        bool bigEndian;                 ///< specifies if field is big-endian
+        double scale;                   ///< scale factor
+        double bias;                    ///< bias
+        qfi_FlightLog::Column column;   ///< output column
+    };
+
+    /**
+     * Makes field.
+     * @param column output column
+     * @param offset [B] offset in datagram, negative for constant value (bias)
+     * @param type field type
+     * @param bigEndian specifies if field is big-endian
+     * @param scale scale factor
+     * @param bias bias
+     * @return field
+     */
+    static Field field( qfi_FlightLog::Column column, int offset,
+                        Type type = Type::Float32, bool bigEndian = false,
+                        double scale = 1.0, double bias = 0.0 );
+
+    /** @return [ns] receiver clock time, the same as qfi_Latency::now() */
+    static qint64 now();
+
+    /**
+     * Constructor.
+     * @param batchSize maximum number of datagrams received at once
+     * @param datagramSize [B] maximum datagram size, longer ones are rejected
+     * @param parent parent object
+     */
+    explicit qfi_UdpReceiver( int batchSize = 32, int datagramSize = 1472,
+                              QObject *parent = Q_NULLPTR );
+
+    /** Destructor, stops receiving. */
+    virtual ~qfi_UdpReceiver();
+
+    /** @param mapping datagram fields */
+    void setMapping( const QVector< Field > &mapping );
+
+    /** @param header datagram header, datagrams not starting with it are rejected */
+    void setHeader( const QByteArray &header );
+
+    /**
+     * Registers instrument, its state is published every received batch.
+     * @param instrument instrument (qfi_AI, qfi_EADI, etc.)
+     */
+    template < class T >
+    inline void addInstrument( T *instrument )
+    {
+        addPublisher( [ instrument ]( const double *values, qint64 arrival )
+        {
+            typename T::State state;
+            qfi_States::fromValues( values, &state );
+            instrument->stateBuffer().publish( state );
+            qfi_Latency::stamp( instrument, arrival );
+        } );
+    }
+
+    /**
+     * Registers instrument with smoothed motion. Received states are kept
+     * with their arrival times and sampleStates() gives the instrument state
+     * interpolated for the current time minus delay.
+     * @param instrument instrument (qfi_AI, qfi_EADI, etc.)
+     * @param delay [us] display delay, should be longer than data period
+     */
+    template < class T >
+    inline void addSmoothedInstrument( T *instrument, qint64 delay = 50000 )
+    {
+        typedef typename T::State State;
+
+        std::shared_ptr< Smoothing< State > > smoothing( new Smoothing< State >() );
+
+        addPublisher( [ instrument, smoothing ]( const double *values, qint64 arrival )
+        {
+            Sample< State > sample;
+            qfi_States::fromValues( values, &sample.state );
+            sample.time = arrival / 1000;
+            smoothing->buffer.publish( sample );
+            qfi_Latency::stamp( instrument, arrival );
+        } );
+
+        addSampler( [ instrument, smoothing, delay ]( qint64 time )
+        {
+            Sample< State > sample;
+
+            // samples newer than the last frame are passed one per frame,
+            // with their arrival times, so interpolation still follows data
+            if ( smoothing->buffer.consume( &sample ) )
+            {
+                smoothing->history.push( sample.time, sample.state );
+            }
+
+            State state;
+
+            if ( smoothing->history.sample( time - delay, &state ) )
+            {
+                instrument->setState( state );
+            }
+        } );
+    }
+
+    /**
+     * Binds socket and starts receiver thread.
+     * @param port UDP port, 0 means any free port (see port())
+     * @param address bound address
+     * @return true on success, false otherwise
+     */
+    bool start( quint16 port, const QHostAddress &address = QHostAddress::Any );
+
+    /** Stops receiver thread and closes socket. */
+    void stop();
+
+    /** @return true if receiving */
+    inline bool isRunning() const { return _thread != Q_NULLPTR; }
+
+    /** @return bound UDP port */
+    inline quint16 port() const { return _port; }
+
+    /** @return number of accepted datagrams */
+    inline qint64 datagrams() const { return _datagrams.loadAcquire(); }
+
+    /** @return number of received batches */
+    inline qint64 batches() const { return _batches.loadAcquire(); }
+
+    /** @return number of rejected (too short, too long, wrong header or non-finite value) datagrams */
+    inline qint64 rejected() const { return _rejected.loadAcquire(); }
+
+    /** @return [ns] arrival time of the last published batch, see now() */
+    inline qint64 lastArrival() const { return _lastArrival.loadAcquire(); }
+
+public slots:
+
+    /**
+     * Sets interpolated states of instruments registered with
+     * addSmoothedInstrument(), has to be called on every frame, e.g.
+     * connected to qfi_FrameScheduler::frame() in continuous mode.
+     */
+    void sampleStates();
+
+signals:
+
+    /**
+     * Emitted (in the receiver object thread) after states have been
+     * published, batches published before the signal is delivered make one
+     * signal.
+     */
+    void received();
+
+private slots:
+
+    void notify();
+
+private:
+
+    /** Timestamped state. */
+    template < class S >
+    struct Sample
+    {
+        qint64 time;                        ///< [us] arrival time
+        S state;                            ///< state
+    };
+
+    /** Smoothed instrument data. */
+    template < class S >
+    struct Smoothing
+    {
+        qfi_TripleBuffer< Sample< S > > buffer; ///< newest sample, published by receiver thread
+        qfi_StateHistory< S > history;          ///< samples taken by GUI thread
+    };
+
+    const int _batchSize;               ///< maximum number of datagrams received at once
+    const int _datagramSize;            ///< [B] maximum datagram size
+
+    QVector< Field > _mapping;          ///< datagram fields
+    QByteArray _header;                 ///< datagram header
+
+    int _minSize;                       ///< [B] minimum datagram size
+
+    QVector< std::function< void( const double*, qint64 ) > > _publishers; ///< state publishing functions
+    QVector< std::function< void( qint64 ) > > _samplers;                  ///< smoothed state sampling functions
+
+    QVector< char > _buffers;           ///< datagram buffers
+
+    double _values [ qfi_FlightLog::_columns ]; ///< last received values
+
+    QUdpSocket *_socket;                ///< socket, owned by receiver thread while running
+    QThread *_thread;                   ///< receiver thread
+
+    quint16 _port;                      ///< bound UDP port
+
+    QAtomicInteger< int > _stopping;    ///< specifies if receiver thread has to finish
+    QAtomicInteger< int > _pending;     ///< specifies if received() signal is pending
+
+    QAtomicInteger< qint64 > _datagrams;    ///< number of accepted datagrams
+    QAtomicInteger< qint64 > _batches;      ///< number of received batches
+    QAtomicInteger< qint64 > _rejected;     ///< number of rejected datagrams
+    QAtomicInteger< qint64 > _lastArrival;  ///< [ns] arrival time of the last batch
+
+    void addPublisher( const std::function< void( const double*, qint64 ) > &publisher );
+
+    void addSampler( const std::function< void( qint64 ) > &sampler );
+
+    bool parse( const char *data, qint64 size );
+
+    void publish( qint64 arrival );
+
+    void receive();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // QFI_UDPRECEIVER_H
@@ -28,6 +28,15 @@
 
 #include <cmath>
 
+#include <qfi/qfi_Cache.h>
+#include <qfi/qfi_CachedSvgItem.h>
+#include <qfi/qfi_Interpolation.h>
+#include <qfi/qfi_Latency.h>
+#include <qfi/qfi_Offscreen.h>
+#include <qfi/qfi_Profiler.h>
+#include <qfi/qfi_Renderers.h>
+#include <qfi/qfi_Trace.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 
 qfi_VOR::qfi_VOR( QWidget *parent ) :
@@ -35,6 +44,8 @@ qfi_VOR::qfi_VOR( QWidget *parent ) :
 
     _scene ( Q_NULLPTR ),
 
+    _resizeTimer ( Q_NULLPTR ),
+
     _itemFaceFixed ( Q_NULLPTR ),
     _itemFace ( Q_NULLPTR ),
     _itemTo ( Q_NULLPTR ),
@@ -44,6 +55,15 @@ qfi_VOR::qfi_VOR( QWidget *parent ) :
     _itemCase ( Q_NULLPTR ),
 
     _course ( 0.0 ),
+    _deviation ( 0.0 ),
+    _cdi ( CDI::Off ),
+
+    _course_old ( 0.0 ),
+    _deviation_old ( 0.0 ),
+
+    _dirty ( true ),
+
+    _suppressedRedraws ( 0 ),
 
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
@@ -51,6 +71,9 @@ qfi_VOR::qfi_VOR( QWidget *parent ) :
     _originalHeight ( 240 ),
     _originalWidth  ( 240 ),
 
+    _originalFaceRadius ( 93.0 ),
+    _originalHandRadius ( 80.0 ),
+
     _originalVorCtr ( 120.0 , 120.0 ),
     _originalHandCtr( 120, 68 ),
 
@@ -67,6 +90,11 @@ qfi_VOR::qfi_VOR( QWidget *parent ) :
     _scene = new QGraphicsScene( this );
     setScene( _scene );
 
+    _resizeTimer = new QTimer( this );
+    _resizeTimer->setSingleShot( true );
+    _resizeTimer->setInterval( 200 );
+    connect( _resizeTimer, &QTimer::timeout, this, &qfi_VOR::reinit );
+
     _scene->clear();
 
     init();
@@ -92,6 +120,10 @@ void qfi_VOR::reinit()
 {
     if ( _scene )
     {
+        _resizeTimer->stop();
+
+        resetTransform();
+
         _scene->clear();
 
         init();
@@ -103,27 +135,106 @@ void qfi_VOR::reinit()
 void qfi_VOR::redraw()
 {
     if ( isVisible() )
+    {
+        State state;
+
+        if ( _stateBuffer.consume( &state ) ) setState( state );
+
+        if ( _dirty )
+        {
+            updateView();
+        }
+        else
+        {
+            _suppressedRedraws++;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_VOR::renderImage( QImage &image )
+{
+    QSize size = qfi_Offscreen::size( image );
+
+    if ( size.isEmpty() ) return;
+
+    State state;
+
+    if ( _stateBuffer.consume( &state ) ) setState( state );
+
+    if ( !isVisible() && size != this->size() )
+    {
+        resize( size );
+        reinit();
+    }
+
+    if ( _dirty )
     {
         updateView();
     }
+
+    qfi_Offscreen::render( _scene,
+                           QRectF( 0.0, 0.0, _scaleX * _originalWidth, _scaleY * _originalHeight ),
+                           image, renderHints() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_VOR::setState( const State &state )
+{
+    if ( _stateHook ) _stateHook( state );
+
+    setCourse( state.course );
+    setDeviation( state.deviation, state.cdi );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_VOR::State::interpolate( const State &s0, const State &s1, double ratio, State *result )
+{
+    *result = ( ratio < 0.5 ) ? s0 : s1;
+
+    result->course    = qfi_Interpolation::angle ( s0.course, s1.course, ratio );
+    result->deviation = qfi_Interpolation::linear( s0.deviation, s1.deviation, ratio );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_VOR::setCourse( double course )
 {
+    double pxPerDeg = qfi_Dirty::pxPerDeg( _originalFaceRadius * qMin( _scaleX, _scaleY ) );
+
     _course = course;
+
+    if ( qfi_Dirty::isChanged( _course, _course_old, pxPerDeg ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_VOR::setDeviation( double deviation, CDI cdi )
 {
+    if ( deviation < -1.0 ) deviation = -1.0;
+    if ( deviation >  1.0 ) deviation =  1.0;
+
+    // 40 deg of hand rotation per unit of deviation
+    double pxPerDev = 40.0 * qfi_Dirty::pxPerDeg( _originalHandRadius * qMin( _scaleX, _scaleY ) );
+
+    if ( cdi != _cdi )
+    {
+        _dirty = true;
+    }
+
     _deviation = deviation;
     _cdi = cdi;
 
-    if ( _deviation < -1.0 ) _deviation = -1.0;
-    if ( _deviation >  1.0 ) _deviation =  1.0;
+    if ( qfi_Dirty::isChanged( _deviation, _deviation_old, pxPerDev ) )
+    {
+        _dirty = true;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -134,7 +245,33 @@ void qfi_VOR::resizeEvent( QResizeEvent *event )
     QGraphicsView::resizeEvent( event );
     ////////////////////////////////////
 
-    reinit();
+    if ( isVisible() && _itemCase )
+    {
+        rescale();
+    }
+    else
+    {
+        reinit();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_VOR::rescale()
+{
+    // items and their state are kept, the scene is rebuilt at the new scale
+    // once the size settles
+    setTransform( QTransform::fromScale( width()  / ( _scaleX * _originalWidth  ),
+                                         height() / ( _scaleY * _originalHeight ) ) );
+
+    centerOn( _scaleX * _originalWidth / 2.0 , _scaleY * _originalHeight / 2.0 );
+
+    // changes too small to be visible at the previous size may be visible now
+    _dirty = true;
+
+    qfi_Cache::deferRebuilds( _resizeTimer->interval() );
+
+    _resizeTimer->start();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -146,42 +283,42 @@ void qfi_VOR::init()
 
     reset();
 
-    _itemFaceFixed = new QGraphicsSvgItem( ":/qfi/images/vor/vor_face_fixed.svg" );
+    _itemFaceFixed = new qfi_CachedSvgItem( ":/qfi/images/vor/vor_face_fixed.svg" );
     _itemFaceFixed->setCacheMode( QGraphicsItem::NoCache );
     _itemFaceFixed->setZValue( _faceFixedZ );
     _itemFaceFixed->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemFaceFixed->setTransformOriginPoint( _originalVorCtr );
     _scene->addItem( _itemFaceFixed );
 
-    _itemFace = new QGraphicsSvgItem( ":/qfi/images/vor/vor_face.svg" );
+    _itemFace = qfi_Renderers::createItem( ":/qfi/images/vor/vor_face.svg" );
     _itemFace->setCacheMode( QGraphicsItem::NoCache );
     _itemFace->setZValue( _faceZ );
     _itemFace->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemFace->setTransformOriginPoint( _originalVorCtr );
     _scene->addItem( _itemFace );
 
-    _itemTo = new QGraphicsSvgItem( ":/qfi/images/vor/vor_to.svg" );
+    _itemTo = new qfi_CachedSvgItem( ":/qfi/images/vor/vor_to.svg" );
     _itemTo->setCacheMode( QGraphicsItem::NoCache );
     _itemTo->setZValue( _toZ );
     _itemTo->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemTo->setTransformOriginPoint( _originalVorCtr );
     _scene->addItem( _itemTo );
 
-    _itemFrom = new QGraphicsSvgItem( ":/qfi/images/vor/vor_from.svg" );
+    _itemFrom = new qfi_CachedSvgItem( ":/qfi/images/vor/vor_from.svg" );
     _itemFrom->setCacheMode( QGraphicsItem::NoCache );
     _itemFrom->setZValue( _fromZ );
     _itemFrom->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemFrom->setTransformOriginPoint( _originalVorCtr );
     _scene->addItem( _itemFrom );
 
-    _itemFlag = new QGraphicsSvgItem( ":/qfi/images/vor/vor_flag.svg" );
+    _itemFlag = new qfi_CachedSvgItem( ":/qfi/images/vor/vor_flag.svg" );
     _itemFlag->setCacheMode( QGraphicsItem::NoCache );
     _itemFlag->setZValue( _flagZ );
     _itemFlag->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
     _itemFlag->setTransformOriginPoint( _originalVorCtr );
     _scene->addItem( _itemFlag );
 
-    _itemHand = new QGraphicsSvgItem( ":/qfi/images/vor/vor_hand.svg" );
+    _itemHand = qfi_Renderers::createItem( ":/qfi/images/vor/vor_hand.svg" );
     _itemHand->setCacheMode( QGraphicsItem::NoCache );
     _itemHand->setZValue( _handZ );
     _itemHand->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -189,7 +326,7 @@ void qfi_VOR::init()
     //_itemHand->setTransformOriginPoint(QPoint(120,68));
     _scene->addItem( _itemHand );
 
-    _itemCase = new QGraphicsSvgItem( ":/qfi/images/vor/vor_case.svg" );
+    _itemCase = new qfi_CachedSvgItem( ":/qfi/images/vor/vor_case.svg" );
     _itemCase->setCacheMode( QGraphicsItem::NoCache );
     _itemCase->setZValue( _caseZ );
     _itemCase->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
@@ -207,13 +344,17 @@ void qfi_VOR::reset()
     _itemFace = Q_NULLPTR;
     _itemCase = Q_NULLPTR;
 
-    _course = 0.0;
+    _dirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_VOR::updateView()
 {
+    QFI_PROFILE( "qfi_VOR::updateView" );
+    QFI_TRACE( "updateView", "qfi_VOR" );
+    qfi_Latency::updated( this );
+
     _itemFace->setRotation( - _course );
 
     if ( _cdi != CDI::Off )
@@ -240,5 +381,10 @@ void qfi_VOR::updateView()
         _itemHand->setRotation(0.0);
     }
 
+    _course_old    = _course;
+    _deviation_old = _deviation;
+
+    _dirty = false;
+
     _scene->update();
 }
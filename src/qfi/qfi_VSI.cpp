@@ -28,25 +28,47 @@
 
 #include <cmath>
 
+#include <qfi/qfi_Cache.h>
+#include <qfi/qfi_CachedSvgItem.h>
+#include <qfi/qfi_Interpolation.h>
+#include <qfi/qfi_Latency.h>
+#include <qfi/qfi_Offscreen.h>
+#include <qfi/qfi_Profiler.h>
+#include <qfi/qfi_Trace.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 
-qfi_VSI::qfi_VSI( QWidget *parent ) :
+qfi_VSI::qfi_VSI( QWidget *parent, RenderBackend backend ) :
     QGraphicsView ( parent ),
 
     _scene ( Q_NULLPTR ),
 
+    _resizeTimer ( Q_NULLPTR ),
+
+    _backend ( backend ),
+
     _itemFace ( Q_NULLPTR ),
     _itemHand ( Q_NULLPTR ),
     _itemCase ( Q_NULLPTR ),
 
     _climbRate ( 0.0 ),
 
+    _climbRate_old ( 0.0 ),
+
+    _dirty ( true ),
+
+    _suppressedRedraws ( 0 ),
+
     _scaleX ( 1.0 ),
     _scaleY ( 1.0 ),
 
+    _atlasStep ( 0.0 ),
+
     _originalHeight ( 240 ),
     _originalWidth  ( 240 ),
 
+    _originalHandRadius ( 86.0 ),
+
     _originalVsiCtr ( 120.0 , 120.0 ),
 
     _faceZ ( -20 ),
@@ -56,7 +78,14 @@ qfi_VSI::qfi_VSI( QWidget *parent ) :
     reset();
 
     _scene = new QGraphicsScene( this );
-    setScene( _scene );
+
+    // painter backend draws items itself, the view has no scene
+    if ( _backend == RenderBackend::Scene ) setScene( _scene );
+
+    _resizeTimer = new QTimer( this );
+    _resizeTimer->setSingleShot( true );
+    _resizeTimer->setInterval( 200 );
+    connect( _resizeTimer, &QTimer::timeout, this, &qfi_VSI::reinit );
 
     _scene->clear();
 
@@ -83,7 +112,12 @@ void qfi_VSI::reinit()
 {
     if ( _scene )
     {
+        _resizeTimer->stop();
+
+        resetTransform();
+
         _scene->clear();
+        _direct.clear();
 
         init();
     }
@@ -94,19 +128,108 @@ void qfi_VSI::reinit()
 void qfi_VSI::redraw()
 {
     if ( isVisible() )
+    {
+        State state;
+
+        if ( _stateBuffer.consume( &state ) ) setState( state );
+
+        if ( _dirty )
+        {
+            updateView();
+        }
+        else
+        {
+            _suppressedRedraws++;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_VSI::renderImage( QImage &image )
+{
+    QSize size = qfi_Offscreen::size( image );
+
+    if ( size.isEmpty() ) return;
+
+    State state;
+
+    if ( _stateBuffer.consume( &state ) ) setState( state );
+
+    if ( !isVisible() && size != this->size() )
+    {
+        resize( size );
+        reinit();
+    }
+
+    if ( _dirty )
     {
         updateView();
     }
+
+    QRectF source( 0.0, 0.0, _scaleX * _originalWidth, _scaleY * _originalHeight );
+
+    if ( _backend == RenderBackend::Painter )
+    {
+        qfi_Offscreen::render( _direct, source, image, renderHints() );
+    }
+    else
+    {
+        qfi_Offscreen::render( _scene, source, image, renderHints() );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_VSI::setState( const State &state )
+{
+    if ( _stateHook ) _stateHook( state );
+
+    setClimbRate( state.climbRate );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_VSI::State::interpolate( const State &s0, const State &s1, double ratio, State *result )
+{
+    result->climbRate = qfi_Interpolation::linear( s0.climbRate, s1.climbRate, ratio );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_VSI::setClimbRate( double climbRate )
 {
+    if ( climbRate < -2000.0 ) climbRate = -2000.0;
+    if ( climbRate >  2000.0 ) climbRate =  2000.0;
+
+    double pxPerFpm = 0.086 * qfi_Dirty::pxPerDeg( _originalHandRadius * qMin( _scaleX, _scaleY ) );
+
     _climbRate = climbRate;
 
-    if ( _climbRate < -2000.0 ) _climbRate = -2000.0;
-    if ( _climbRate >  2000.0 ) _climbRate =  2000.0;
+    if ( qfi_Dirty::isChanged( _climbRate, _climbRate_old, pxPerFpm ) )
+    {
+        _dirty = true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_VSI::setAtlasStep( double step )
+{
+    _atlasStep = step;
+
+    if ( _itemHand ) _itemHand->setAngleStep( _atlasStep );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 qfi_VSI::atlasBytes() const
+{
+    qint64 bytes = 0;
+
+    if ( _itemHand ) bytes += _itemHand->atlasBytes();
+
+    return bytes;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -117,7 +240,55 @@ void qfi_VSI::resizeEvent( QResizeEvent *event )
     QGraphicsView::resizeEvent( event );
     ////////////////////////////////////
 
-    reinit();
+    if ( isVisible() && _itemCase )
+    {
+        rescale();
+    }
+    else
+    {
+        reinit();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_VSI::paintEvent( QPaintEvent *event )
+{
+    if ( _backend == RenderBackend::Scene )
+    {
+        QGraphicsView::paintEvent( event );
+        return;
+    }
+
+    QPainter painter( viewport() );
+    painter.setRenderHints( renderHints() );
+
+    // the same area the scene view shows, centered in the viewport
+    QRectF target( 0.5 * ( viewport()->width()  - width()  ),
+                   0.5 * ( viewport()->height() - height() ),
+                   width(), height() );
+
+    _direct.render( &painter, target,
+                    QRectF( 0.0, 0.0, _scaleX * _originalWidth, _scaleY * _originalHeight ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void qfi_VSI::rescale()
+{
+    // items and their state are kept, the scene is rebuilt at the new scale
+    // once the size settles
+    setTransform( QTransform::fromScale( width()  / ( _scaleX * _originalWidth  ),
+                                         height() / ( _scaleY * _originalHeight ) ) );
+
+    centerOn( _scaleX * _originalWidth / 2.0 , _scaleY * _originalHeight / 2.0 );
+
+    // changes too small to be visible at the previous size may be visible now
+    _dirty = true;
+
+    qfi_Cache::deferRebuilds( _resizeTimer->interval() );
+
+    _resizeTimer->start();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -129,24 +300,25 @@ void qfi_VSI::init()
 
     reset();
 
-    _itemFace = new QGraphicsSvgItem( ":/qfi/images/vsi/vsi_face.svg" );
+    _itemFace = new qfi_CachedSvgItem( ":/qfi/images/vsi/vsi_face.svg" );
     _itemFace->setCacheMode( QGraphicsItem::NoCache );
     _itemFace->setZValue( _faceZ );
     _itemFace->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
-    _scene->addItem( _itemFace );
+    addItem( _itemFace );
 
-    _itemHand = new QGraphicsSvgItem( ":/qfi/images/vsi/vsi_hand.svg" );
+    _itemHand = new qfi_AtlasSvgItem( ":/qfi/images/vsi/vsi_hand.svg" );
     _itemHand->setCacheMode( QGraphicsItem::NoCache );
     _itemHand->setZValue( _handZ );
     _itemHand->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
+    _itemHand->setAngleStep( _atlasStep );
     _itemHand->setTransformOriginPoint( _originalVsiCtr );
-    _scene->addItem( _itemHand );
+    addItem( _itemHand );
 
-    _itemCase = new QGraphicsSvgItem( ":/qfi/images/vsi/vsi_case.svg" );
+    _itemCase = new qfi_CachedSvgItem( ":/qfi/images/vsi/vsi_case.svg" );
     _itemCase->setCacheMode( QGraphicsItem::NoCache );
     _itemCase->setZValue( _caseZ );
     _itemCase->setTransform( QTransform::fromScale( _scaleX, _scaleY ), true );
-    _scene->addItem( _itemCase );
+    addItem( _itemCase );
 
     centerOn( width() / 2.0 , height() / 2.0 );
 
@@ -155,20 +327,49 @@ void qfi_VSI::init()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void qfi_VSI::addItem( QGraphicsItem *item )
+{
+    if ( _backend == RenderBackend::Painter )
+    {
+        _direct.addItem( item );
+    }
+    else
+    {
+        _scene->addItem( item );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void qfi_VSI::reset()
 {
     _itemFace = Q_NULLPTR;
     _itemHand = Q_NULLPTR;
     _itemCase = Q_NULLPTR;
 
-    _climbRate = 0.0;
+    _dirty = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void qfi_VSI::updateView()
 {
+    QFI_PROFILE( "qfi_VSI::updateView" );
+    QFI_TRACE( "updateView", "qfi_VSI" );
+    qfi_Latency::updated( this );
+
     _itemHand->setRotation( _climbRate * 0.086 );
 
-    _scene->update();
+    _climbRate_old = _climbRate;
+
+    _dirty = false;
+
+    if ( _backend == RenderBackend::Painter )
+    {
+        viewport()->update();
+    }
+    else
+    {
+        _scene->update();
+    }
 }
@@ -26,8 +26,17 @@
 
 #include <QGraphicsView>
 #include <QGraphicsSvgItem>
+#include <QImage>
+#include <QTimer>
 
+#include <functional>
+
+#include <qfi/qfi_AtlasSvgItem.h>
 #include <qfi/qfi_defs.h>
+#include <qfi/qfi_DirectPainter.h>
+#include <qfi/qfi_Dirty.h>
+#include <qfi/qfi_enums.h>
+#include <qfi/qfi_TripleBuffer.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -40,8 +49,31 @@ class QFIAPI qfi_VSI : public QGraphicsView
 
 public:
 
-    /** Constructor. */
-    explicit qfi_VSI( QWidget *parent = Q_NULLPTR );
+    /**
+     * Instrument state, applied at once with setState(). Plain data
+     * structure, it can be copied between threads with memcpy().
+     */
+    struct State
+    {
+        double climbRate;   ///< [ft/min] climb rate
+
+        /**
+         * Interpolates (ratio from 0.0 to 1.0) or extrapolates (ratio greater
+         * than 1.0) between states, see qfi_StateHistory.
+         * @param s0 first state
+         * @param s1 second state
+         * @param ratio interpolation ratio
+         * @param result output state
+         */
+        static void interpolate( const State &s0, const State &s1, double ratio, State *result );
+    };
+
+    /**
+     * Constructor.
+     * @param backend rendering backend, selected once for the lifetime
+     */
+    explicit qfi_VSI( QWidget *parent = Q_NULLPTR,
+                      RenderBackend backend = RenderBackend::Scene );
 
     /** Destructor. */
     virtual ~qfi_VSI();
@@ -52,30 +84,95 @@ public:
     /** Refreshes (redraws) widget. */
     void redraw();
 
+    /**
+     * Renders widget into the image, also when the widget is not shown
+     * (e.g. with the offscreen platform plugin). Hidden widget is resized
+     * to the image size, image itself is never reallocated.
+     * @param image target image
+     */
+    void renderImage( QImage &image );
+
     /** @param climb rate [ft/min] */
     void setClimbRate( double climbRate );
 
+    /**
+     * Enables drawing of the needle from pre-rotated frames.
+     * @param step [deg] frames angle step, 0 disables (default)
+     */
+    void setAtlasStep( double step );
+
+    /** @return [deg] frames angle step */
+    inline double atlasStep() const { return _atlasStep; }
+
+    /** @return [B] memory occupied by the pre-rotated frames */
+    qint64 atlasBytes() const;
+
+    /**
+     * Applies all values of the state at once, only the visibly changed ones
+     * mark the instrument dirty.
+     * @param state instrument state
+     */
+    void setState( const State &state );
+
+    /**
+     * Other threads (e.g. simulation) may publish state into this buffer
+     * without blocking, the newest state is applied on redraw.
+     * @return state buffer
+     */
+    inline qfi_TripleBuffer< State >& stateBuffer() { return _stateBuffer; }
+
+    /**
+     * Sets function called with every state passed to setState(), also with
+     * states taken from stateBuffer(), e.g. by qfi_Recorder.
+     * @param hook state hook, empty function removes hook
+     */
+    inline void setStateHook( const std::function< void( const State& ) > &hook ) { _stateHook = hook; }
+
+    /** @return number of redraws skipped because nothing has changed */
+    inline qint64 suppressedRedraws() const { return _suppressedRedraws; }
+
 protected:
 
     /** */
     void resizeEvent( QResizeEvent *event );
 
+    /** Paints items directly when the painter backend is selected. */
+    void paintEvent( QPaintEvent *event );
+
 private:
 
     QGraphicsScene *_scene;
+    QTimer *_resizeTimer;   ///< debounces rebuilding the scene after resizing
+
+    const RenderBackend _backend;   ///< rendering backend
+    qfi_DirectPainter _direct;      ///< items painted directly (painter backend)
 
     QGraphicsSvgItem *_itemFace;
-    QGraphicsSvgItem *_itemHand;
+    qfi_AtlasSvgItem *_itemHand;
     QGraphicsSvgItem *_itemCase;
 
     double _climbRate;
 
+    double _climbRate_old;  ///< [ft/min] climb rate currently drawn
+
+    bool _dirty;
+
+    qint64 _suppressedRedraws;
+
+    qfi_TripleBuffer< State > _stateBuffer;
+
+    std::function< void( const State& ) > _stateHook;
+
     double _scaleX;
     double _scaleY;
 
+    double _atlasStep;
+
     const int _originalHeight;
     const int _originalWidth;
 
+    const double _originalHandRadius;
+
     QPointF _originalVsiCtr;
 
     const int _faceZ;
@@ -84,8 +181,14 @@ private:
 
     void init();
 
+    /** Adds item either to the scene or to the direct painter. */
+    void addItem( QGraphicsItem *item );
+
     void reset();
 
+    /** Scales the view to the current size until the scene is rebuilt. */
+    void rescale();
+
     void updateView();
 };
 
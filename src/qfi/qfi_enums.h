@@ -31,4 +31,15 @@ enum class CDI
     FROM
 };
 
+/**
+ * Instrument rendering backend. Painter backend is supported by qfi_AI,
+ * qfi_TC and qfi_VSI, it cannot be used with qfi_Panel and
+ * qfi_ParallelRenderer, which both need the instrument scene.
+ */
+enum class RenderBackend
+{
+    Scene = 0,  ///< items in QGraphicsScene (default)
+    Painter     ///< items painted directly with QPainter, see qfi_DirectPainter
+};
+
 #endif // QFI_ENUMS_H
@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+################################################################################
+# Copyright (C) 2021 Marek M. Cel
+#
+# Permission is hereby granted, free of charge, to any person obtaining
+# a copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom
+# the Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+# IN THE SOFTWARE.
+################################################################################
+#
+# Minifies SVG files listed in a Qt resource file.
+#
+# Usage: qfi_svgmin.py <input.qrc> <output directory>
+#
+# Writes minified copies of the SVG files and the resource file itself
+# to the output directory, keeping relative paths, so resource paths used
+# by the library stay the same. Editor metadata, comments, unused defs and
+# unreferenced ids are removed. Geometry and paint are left untouched.
+#
+################################################################################
+
+import os
+import re
+import shutil
+import sys
+import xml.etree.ElementTree as ET
+
+################################################################################
+
+SVG   = 'http://www.w3.org/2000/svg'
+XLINK = 'http://www.w3.org/1999/xlink'
+
+EDITOR_NAMESPACES = (
+    'http://www.inkscape.org/namespaces/inkscape',
+    'http://sodipodi.sourceforge.net/DTD/sodipodi-0.dtd',
+    'http://www.w3.org/1999/02/22-rdf-syntax-ns#',
+    'http://creativecommons.org/ns#',
+    'http://purl.org/dc/elements/1.1/',
+)
+
+TEXT_ELEMENTS = ( 'text', 'tspan', 'textPath', 'flowRoot', 'flowPara' )
+
+REF_PATTERN = re.compile( r'url\(\s*#([^)\s]+)\s*\)' )
+
+ET.register_namespace( '', SVG )
+ET.register_namespace( 'xlink', XLINK )
+
+################################################################################
+
+def namespace( tag ):
+    if tag.startswith( '{' ):
+        return tag[ 1:tag.index( '}' ) ]
+    return ''
+
+def local( tag ):
+    return tag[ tag.index( '}' ) + 1: ] if tag.startswith( '{' ) else tag
+
+################################################################################
+
+def strip_editor_data( elem ):
+    for child in list( elem ):
+        if not isinstance( child.tag, str ) \
+           or namespace( child.tag ) in EDITOR_NAMESPACES \
+           or child.tag == '{%s}metadata' % SVG:
+            elem.remove( child )
+        else:
+            strip_editor_data( child )
+
+    for name in list( elem.attrib ):
+        if namespace( name ) in EDITOR_NAMESPACES:
+            del elem.attrib[ name ]
+
+    style = elem.get( 'style' )
+    if style is not None:
+        props = [ p.strip() for p in style.split( ';' ) ]
+        props = [ p for p in props if p and not p.startswith( '-inkscape' ) ]
+        if props:
+            elem.set( 'style', ';'.join( props ) )
+        else:
+            del elem.attrib[ 'style' ]
+
+################################################################################
+
+def collect_refs( root ):
+    refs = set()
+    for elem in root.iter():
+        for name, value in elem.attrib.items():
+            if local( name ) == 'href' and value.startswith( '#' ):
+                refs.add( value[ 1: ] )
+            refs.update( REF_PATTERN.findall( value ) )
+        if local( elem.tag ) == 'style' and elem.text:
+            refs.update( REF_PATTERN.findall( elem.text ) )
+    return refs
+
+################################################################################
+
+def strip_unused( root ):
+    # removing a def may leave other defs (e.g. gradient stops) unreferenced
+    while True:
+        refs = collect_refs( root )
+        removed = False
+        for defs in root.iter( '{%s}defs' % SVG ):
+            for child in list( defs ):
+                if child.get( 'id' ) not in refs:
+                    defs.remove( child )
+                    removed = True
+        if not removed:
+            break
+
+    for elem in root.iter():
+        if 'id' in elem.attrib and elem.get( 'id' ) not in refs:
+            del elem.attrib[ 'id' ]
+
+    for parent in root.iter():
+        for child in list( parent ):
+            if local( child.tag ) == 'defs' and len( child ) == 0:
+                parent.remove( child )
+
+################################################################################
+
+def strip_whitespace( elem ):
+    if local( elem.tag ) in TEXT_ELEMENTS:
+        return
+    if elem.text and not elem.text.strip():
+        elem.text = None
+    for child in elem:
+        if child.tail and not child.tail.strip():
+            child.tail = None
+        strip_whitespace( child )
+
+################################################################################
+
+def minify( src, dst ):
+    tree = ET.parse( src )
+    root = tree.getroot()
+
+    strip_editor_data( root )
+    strip_unused( root )
+    strip_whitespace( root )
+
+    tree.write( dst, encoding='UTF-8', xml_declaration=True )
+
+################################################################################
+
+def main( argv ):
+    if len( argv ) != 3:
+        sys.stderr.write( 'Usage: %s <input.qrc> <output directory>\n' % argv[ 0 ] )
+        return 1
+
+    qrc_file = argv[ 1 ]
+    out_dir  = argv[ 2 ]
+
+    src_dir = os.path.dirname( os.path.abspath( qrc_file ) )
+
+    files = [ f.text.strip() for f in ET.parse( qrc_file ).getroot().iter( 'file' ) ]
+
+    size_src = 0
+    size_dst = 0
+
+    for name in files:
+        src = os.path.join( src_dir, name )
+        dst = os.path.join( out_dir, name )
+
+        os.makedirs( os.path.dirname( dst ), exist_ok=True )
+
+        # up-to-date files are skipped
+        if not os.path.exists( dst ) or os.path.getmtime( dst ) < os.path.getmtime( src ):
+            if name.lower().endswith( '.svg' ):
+                minify( src, dst )
+            else:
+                shutil.copyfile( src, dst )
+
+        size_src += os.path.getsize( src )
+        size_dst += os.path.getsize( dst )
+
+    shutil.copyfile( qrc_file, os.path.join( out_dir, os.path.basename( qrc_file ) ) )
+
+    print( 'qfi_svgmin: %d files, %d -> %d bytes' % ( len( files ), size_src, size_dst ) )
+
+    return 0
+
+################################################################################
+
+if __name__ == '__main__':
+    sys.exit( main( sys.argv ) )